@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <cxxopts.hpp>
+
+#include <afina/logging/Config.h>
+#include <afina/network/Config.h>
+#include <afina/network/Server.h>
+
+#include "logging/ServiceImpl.h"
+#include "network/mt_blocking/ServerImpl.h"
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "network/st_blocking/ServerImpl.h"
+#include "network/st_nonblocking/ServerImpl.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+
+// Connects to the server over loopback TCP
+static int connect_tcp(uint16_t port) {
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == -1 || connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        throw std::runtime_error("Failed to connect over tcp: " + std::string(strerror(errno)));
+    }
+
+    // Ping-pong traffic, do not let Nagle to hold small requests
+    int opts = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &opts, sizeof(opts));
+    return sock;
+}
+
+// Connects to the server over unix socket in abstract namespace
+static int connect_unix(const std::string &name) {
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path + 1, name.data() + 1, name.size() - 1);
+    socklen_t addr_len = offsetof(struct sockaddr_un, sun_path) + name.size();
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock == -1 || connect(sock, (struct sockaddr *)&addr, addr_len) == -1) {
+        throw std::runtime_error("Failed to connect over unix socket: " + std::string(strerror(errno)));
+    }
+    return sock;
+}
+
+// Sends request and waits for the whole response, returns round trip time in nanoseconds
+static double round_trip(int sock, const std::string &request, const std::string &response) {
+    auto start = std::chrono::steady_clock::now();
+    if (send(sock, request.data(), request.size(), 0) != ssize_t(request.size())) {
+        throw std::runtime_error("Failed to send request");
+    }
+
+    char buffer[4096];
+    std::size_t received = 0;
+    while (received < response.size()) {
+        ssize_t n = recv(sock, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            throw std::runtime_error("Failed to receive response");
+        }
+        received += n;
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+static void report(const std::string &name, std::vector<double> &samples) {
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double s : samples) {
+        sum += s;
+    }
+
+    auto at = [&samples](double q) { return samples[std::min(samples.size() - 1, std::size_t(q * samples.size()))]; };
+    std::cout << std::setw(6) << name << std::fixed << std::setprecision(1) << " avg=" << sum / samples.size() / 1000
+              << "us p50=" << at(0.5) / 1000 << "us p99=" << at(0.99) / 1000 << "us p99.9=" << at(0.999) / 1000
+              << "us max=" << samples.back() / 1000 << "us" << std::endl;
+}
+
+static std::vector<double> run(int sock, std::size_t requests) {
+    const std::string request = "set bench 0 0 5\r\nvalue\r\n";
+    const std::string response = "STORED\r\n";
+
+    // Warm up caches and connection state
+    for (std::size_t i = 0; i < std::min<std::size_t>(1000, requests); i++) {
+        round_trip(sock, request, response);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(requests);
+    for (std::size_t i = 0; i < requests; i++) {
+        samples.push_back(round_trip(sock, request, response));
+    }
+    close(sock);
+    return samples;
+}
+
+/**
+ * Compares request round trip latency of loopback TCP and unix socket on the same server
+ */
+int main(int argc, char **argv) {
+    cxxopts::Options options("benchNetworkLatency", "Latency of loopback TCP versus unix socket");
+    options.add_options()("n,network", "Type of network service to use", cxxopts::value<std::string>());
+    options.add_options()("r,requests", "Number of requests to send", cxxopts::value<std::size_t>());
+    options.add_options()("p,port", "TCP port to listen on", cxxopts::value<uint16_t>());
+    options.parse(argc, argv);
+
+    std::string network_type = options.count("network") ? options["network"].as<std::string>() : "mt_nonblock";
+    std::size_t requests = options.count("requests") ? options["requests"].as<std::size_t>() : 100000;
+    uint16_t port = options.count("port") ? options["port"].as<uint16_t>() : 18080;
+
+    auto logConfig = std::make_shared<Logging::Config>();
+    logConfig->appenders["console"].type = Logging::Appender::Type::STDERR;
+    logConfig->appenders["console"].color = false;
+    logConfig->loggers["root"].level = Logging::Logger::Level::ERROR;
+    logConfig->loggers["root"].appenders.push_back("console");
+    logConfig->loggers["root"].format = "[%H:%M:%S %z] [%l] %v";
+    auto logService = std::make_shared<Logging::ServiceImpl>(logConfig);
+    logService->Start();
+
+    auto storage = std::make_shared<Backend::ThreadSafeSimplLRU>();
+    std::shared_ptr<Network::Server> server;
+    if (network_type == "st_block") {
+        server = std::make_shared<Network::STblocking::ServerImpl>(storage, logService);
+    } else if (network_type == "mt_block") {
+        server = std::make_shared<Network::MTblocking::ServerImpl>(storage, logService);
+    } else if (network_type == "st_nonblock") {
+        server = std::make_shared<Network::STnonblock::ServerImpl>(storage, logService);
+    } else if (network_type == "mt_nonblock") {
+        server = std::make_shared<Network::MTnonblock::ServerImpl>(storage, logService);
+    } else {
+        std::cerr << "Unknown network type" << std::endl;
+        return 1;
+    }
+
+    Network::Config config;
+    config.unix_socket = "@afina-bench-" + std::to_string(getpid());
+    server->Configure(config);
+    server->Start(port, 1, 1);
+
+    std::cout << "network=" << network_type << " requests=" << requests << std::endl;
+    try {
+        // Blocking servers serve single connection at a time, so run one after another
+        std::vector<double> tcp = run(connect_tcp(port), requests);
+        report("tcp", tcp);
+
+        std::vector<double> unix_samples = run(connect_unix(config.unix_socket), requests);
+        report("unix", unix_samples);
+    } catch (std::runtime_error &ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+    }
+
+    server->Stop();
+    server->Join();
+    logService->Stop();
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+#include <afina/Storage.h>
+
+#include "StorageFactory.h"
+#include "Workload.h"
+
+using namespace Afina;
+
+// Replays trace as a look-aside cache would see it: get, and set on miss. Returns hit ratio
+static double replay(Storage &storage, const std::vector<std::string> &trace, const std::string &value) {
+    std::size_t hits = 0;
+    std::string result;
+    for (auto &key : trace) {
+        if (storage.Get(key, result)) {
+            hits++;
+        } else {
+            storage.Put(key, value);
+        }
+    }
+    return double(hits) / trace.size();
+}
+
+/**
+ * Compares hit ratio of storages on the same key trace, either read from file or generated
+ */
+int main(int argc, char **argv) {
+    cxxopts::Options options("benchStorageHitRatio", "Hit ratio of storages on key trace");
+    options.add_options()("s,storage", "Comma separated storages to compare", cxxopts::value<std::string>());
+    options.add_options()("f,trace", "File with keys, one per line, instead of generated trace",
+                          cxxopts::value<std::string>());
+    options.add_options()("n,requests", "Number of requests in generated trace", cxxopts::value<std::size_t>());
+    options.add_options()("k,keys", "Number of distinct keys in generated trace", cxxopts::value<std::size_t>());
+    options.add_options()("z,zipf", "Zipf exponent of generated trace", cxxopts::value<double>());
+    options.add_options()("scan-every", "Insert scan of cold keys every N requests, 0 - no scans",
+                          cxxopts::value<std::size_t>());
+    options.add_options()("scan-length", "Number of keys in each scan", cxxopts::value<std::size_t>());
+    options.add_options()("v,value-size", "Size of values stored", cxxopts::value<std::size_t>());
+    options.parse(argc, argv);
+
+    std::string types =
+        options.count("storage") ? options["storage"].as<std::string>() : "st_lru,st_tinylfu,s3fifo,st_arc";
+    std::size_t value_size = options.count("value-size") ? options["value-size"].as<std::size_t>() : 100;
+    std::size_t keys = options.count("keys") ? options["keys"].as<std::size_t>() : 100000;
+
+    std::vector<std::string> trace;
+    if (options.count("trace")) {
+        trace = Bench::file_trace(options["trace"].as<std::string>());
+    } else {
+        std::size_t requests = options.count("requests") ? options["requests"].as<std::size_t>() : 2000000;
+        double s = options.count("zipf") ? options["zipf"].as<double>() : 0.9;
+        std::size_t scan_every = options.count("scan-every") ? options["scan-every"].as<std::size_t>() : 50000;
+        std::size_t scan_length = options.count("scan-length") ? options["scan-length"].as<std::size_t>() : 20000;
+        trace = Bench::zipf_trace(requests, keys, s, scan_every, scan_length);
+    }
+
+    std::cout << "requests=" << trace.size() << " value=" << value_size << "b" << std::endl;
+    const std::string value(value_size, 'v');
+    for (double fraction : {0.01, 0.05, 0.1, 0.25}) {
+        // Cache size is a fraction of the key space, assuming keys of about 10 bytes
+        std::size_t max_size = std::size_t(fraction * keys * (value_size + 10));
+
+        std::stringstream type_stream(types);
+        std::string type;
+        while (std::getline(type_stream, type, ',')) {
+            auto storage = Bench::make_storage(type, max_size);
+            double ratio = replay(*storage, trace, value);
+            std::cout << "cache=" << std::setw(4) << int(fraction * 100) << "% " << std::setw(8) << type
+                      << std::fixed << std::setprecision(2) << " hit=" << ratio * 100 << "%" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+#ifndef AFINA_BENCH_STORAGE_STORAGE_FACTORY_H
+#define AFINA_BENCH_STORAGE_STORAGE_FACTORY_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <afina/Storage.h>
+
+#include "storage/ARC.h"
+#include "storage/ClockCache.h"
+#include "storage/S3FIFO.h"
+#include "storage/SimpleLRU.h"
+#include "storage/SlabLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TinyLFU.h"
+
+namespace Afina {
+namespace Bench {
+
+/**
+ * Creates storage by the same name main uses for --storage
+ */
+inline std::shared_ptr<Storage> make_storage(const std::string &type, std::size_t max_size) {
+    if (type == "st_lru") {
+        return std::make_shared<Backend::SimpleLRU>(max_size);
+    } else if (type == "mt_lru") {
+        return std::make_shared<Backend::ThreadSafeSimplLRU>(max_size);
+    } else if (type == "st_tinylfu") {
+        return std::make_shared<Backend::TinyLFU>(max_size);
+    } else if (type == "clock") {
+        return std::make_shared<Backend::ClockCache>(max_size);
+    } else if (type == "s3fifo") {
+        return std::make_shared<Backend::S3FIFO>(max_size);
+    } else if (type == "st_arc") {
+        return std::make_shared<Backend::ARC>(max_size);
+    } else if (type == "st_slab") {
+        return std::make_shared<Backend::SlabLRU>(max_size);
+    }
+    throw std::runtime_error("Unknown storage type: " + type);
+}
+
+} // namespace Bench
+} // namespace Afina
+
+#endif // AFINA_BENCH_STORAGE_STORAGE_FACTORY_H
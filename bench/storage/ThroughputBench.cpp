@@ -0,0 +1,131 @@
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+#include <afina/Storage.h>
+
+#include "StorageFactory.h"
+#include "storage/DurableStorage.h"
+#include "Workload.h"
+
+using namespace Afina;
+
+// Generates key indexes each thread goes through, uniform if zipf exponent is zero
+static std::vector<std::vector<uint32_t>> make_traces(std::size_t threads, std::size_t ops, std::size_t keys, double s) {
+    std::unique_ptr<Bench::ZipfGenerator> zipf;
+    if (s > 0) {
+        zipf.reset(new Bench::ZipfGenerator(keys, s));
+    }
+
+    std::vector<std::vector<uint32_t>> traces(threads);
+    for (std::size_t t = 0; t < threads; t++) {
+        std::minstd_rand rnd(t + 1);
+        std::uniform_int_distribution<std::size_t> uniform(0, keys - 1);
+        traces[t].reserve(ops);
+        for (std::size_t i = 0; i < ops; i++) {
+            traces[t].push_back(zipf ? (*zipf)(rnd) : uniform(rnd));
+        }
+    }
+    return traces;
+}
+
+// Runs mixed workload in a given number of threads, returns total operations per second
+static double run(Storage &storage, const std::vector<std::string> &keys,
+                  const std::vector<std::vector<uint32_t>> &traces, std::size_t threads, unsigned read_percent) {
+    const std::string value(32, 'v');
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            std::minstd_rand rnd(t + 1);
+            std::uniform_int_distribution<unsigned> op_dist(0, 99);
+            std::string result;
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+
+            for (uint32_t index : traces[t]) {
+                const std::string &key = keys[index];
+                if (op_dist(rnd) < read_percent) {
+                    storage.Get(key, result);
+                } else {
+                    storage.Put(key, value);
+                }
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return threads * traces[0].size() / std::chrono::duration<double>(end - start).count();
+}
+
+/**
+ * Measures how storage throughput scales with number of threads on read-mostly workload
+ */
+int main(int argc, char **argv) {
+    cxxopts::Options options("benchStorageThroughput", "Storage throughput versus number of threads");
+    options.add_options()("s,storage", "Comma separated storages to compare", cxxopts::value<std::string>());
+    options.add_options()("t,threads", "Maximum number of threads", cxxopts::value<std::size_t>());
+    options.add_options()("o,ops", "Number of operations per thread", cxxopts::value<std::size_t>());
+    options.add_options()("k,keys", "Number of distinct keys", cxxopts::value<std::size_t>());
+    options.add_options()("r,reads", "Percent of reads in the workload", cxxopts::value<unsigned>());
+    options.add_options()("z,zipf", "Zipf exponent of key popularity, 0 - uniform", cxxopts::value<double>());
+    options.add_options()("oplog", "Log changes into this directory, to see the cost of durability",
+                          cxxopts::value<std::string>());
+    options.parse(argc, argv);
+
+    std::string types = options.count("storage") ? options["storage"].as<std::string>() : "mt_lru,clock,s3fifo";
+    std::size_t max_threads =
+        options.count("threads") ? options["threads"].as<std::size_t>() : std::thread::hardware_concurrency();
+    std::size_t ops = options.count("ops") ? options["ops"].as<std::size_t>() : 1000000;
+    std::size_t key_count = options.count("keys") ? options["keys"].as<std::size_t>() : 100000;
+    unsigned read_percent = options.count("reads") ? options["reads"].as<unsigned>() : 95;
+    double s = options.count("zipf") ? options["zipf"].as<double>() : 0.99;
+
+    std::vector<std::string> keys;
+    for (std::size_t i = 0; i < key_count; i++) {
+        keys.push_back("key:" + std::to_string(i));
+    }
+
+    auto traces = make_traces(max_threads, ops, key_count, s);
+    std::cout << "reads=" << read_percent << "% keys=" << key_count << " zipf=" << s << " ops/thread=" << ops
+              << std::endl;
+    std::stringstream type_stream(types);
+    std::string type;
+    while (std::getline(type_stream, type, ',')) {
+        // Every key fits, so that the benchmark measures synchronization rather than misses
+        auto storage = Bench::make_storage(type, key_count * 64);
+        if (options.count("oplog")) {
+            std::unique_ptr<Backend::OpLog> log(
+                new Backend::OpLog(options["oplog"].as<std::string>(), std::chrono::milliseconds(100)));
+            storage = std::make_shared<Backend::DurableStorage>(storage, std::move(log));
+        }
+        storage->Start();
+        for (auto &key : keys) {
+            storage->Put(key, std::string(32, 'v'));
+        }
+
+        for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+            double rate = run(*storage, keys, traces, threads, read_percent);
+            std::cout << std::setw(8) << type << " threads=" << std::setw(3) << threads << std::fixed
+                      << std::setprecision(2) << " Mops/s=" << rate / 1e6 << std::endl;
+        }
+        storage->Stop();
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+#ifndef AFINA_BENCH_STORAGE_WORKLOAD_H
+#define AFINA_BENCH_STORAGE_WORKLOAD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Afina {
+namespace Bench {
+
+/**
+ * # Generator of Zipf distributed ranks in [0, n)
+ * Rank 0 is the most popular one, probability of rank i is proportional to 1 / (i + 1)^s
+ */
+class ZipfGenerator {
+public:
+    ZipfGenerator(std::size_t n, double s) : _cdf(n) {
+        double sum = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            sum += 1.0 / std::pow(double(i + 1), s);
+            _cdf[i] = sum;
+        }
+        for (auto &p : _cdf) {
+            p /= sum;
+        }
+    }
+
+    template <typename Random> std::size_t operator()(Random &rnd) {
+        double p = std::uniform_real_distribution<double>(0, 1)(rnd);
+        return std::min<std::size_t>(std::lower_bound(_cdf.begin(), _cdf.end(), p) - _cdf.begin(), _cdf.size() - 1);
+    }
+
+private:
+    std::vector<double> _cdf;
+};
+
+/**
+ * Builds key trace of Zipf distributed requests. Every scan_every requests a scan of scan_length
+ * keys never seen before is inserted, the way batch jobs go over cold data
+ */
+inline std::vector<std::string> zipf_trace(std::size_t requests, std::size_t keys, double s, std::size_t scan_every,
+                                           std::size_t scan_length, unsigned seed = 1) {
+    std::mt19937_64 rnd(seed);
+    ZipfGenerator zipf(keys, s);
+
+    // Shuffle ranks, so that popularity isn't correlated with key order
+    std::vector<std::size_t> ids(keys);
+    for (std::size_t i = 0; i < keys; i++) {
+        ids[i] = i;
+    }
+    std::shuffle(ids.begin(), ids.end(), rnd);
+
+    std::vector<std::string> trace;
+    trace.reserve(requests);
+    std::size_t scanned = 0;
+    while (trace.size() < requests) {
+        if (scan_every > 0 && trace.size() > 0 && trace.size() % scan_every == 0) {
+            for (std::size_t i = 0; i < scan_length && trace.size() < requests; i++) {
+                trace.push_back("scan:" + std::to_string(scanned++));
+            }
+        }
+        trace.push_back("key:" + std::to_string(ids[zipf(rnd)]));
+    }
+    return trace;
+}
+
+/**
+ * Reads key trace from file, one key per line
+ */
+inline std::vector<std::string> file_trace(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Failed to open trace " + path);
+    }
+
+    std::vector<std::string> trace;
+    std::string key;
+    while (std::getline(in, key)) {
+        if (!key.empty()) {
+            trace.push_back(key);
+        }
+    }
+    return trace;
+}
+
+} // namespace Bench
+} // namespace Afina
+
+#endif // AFINA_BENCH_STORAGE_WORKLOAD_H
@@ -1,9 +1,15 @@
 #ifndef AFINA_STORAGE_H
 #define AFINA_STORAGE_H
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <string>
 
 namespace Afina {
+namespace Metrics {
+struct StorageGauges;
+} // namespace Metrics
 
 /**
  *
@@ -56,6 +62,26 @@ public:
      */
     virtual bool Set(const std::string &key, const std::string &value) = 0;
 
+    /**
+     * Same as Put/PutIfAbsent/Set above, but association lives for a given number of seconds
+     * only. Once time is over any subsequent access to storage must not see the association.
+     *
+     * Zero ttl means association never expires, negative one means it is expired right away.
+     * Plain Put and PutIfAbsent are the same as zero ttl, while plain Set keeps expiration
+     * time of the existing association.
+     *
+     * Storages which doesn't support expiration keep associations forever
+     *
+     * @param key to be associated with value
+     * @param value to be assigned for the key
+     * @param ttl number of seconds association lives for
+     */
+    virtual bool Put(const std::string &key, const std::string &value, int32_t ttl) { return Put(key, value); }
+    virtual bool PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) {
+        return PutIfAbsent(key, value);
+    }
+    virtual bool Set(const std::string &key, const std::string &value, int32_t ttl) { return Set(key, value); }
+
     /**
      * Removes association for the given key
      * If requested key doesn't present in storage method returns false and
@@ -84,6 +110,76 @@ public:
      * @param value output parameter to copy value to
      */
     virtual bool Get(const std::string &key, std::string &value) = 0;
+
+    /**
+     * Same as Get above, but also tells steady clock time association expires at, time_point::max()
+     * if it never does. Storages which doesn't track expiration report time_point::min(), so that
+     * caller never relies on the value being alive for any time
+     *
+     * @param key to retrive value for
+     * @param value output parameter to copy value to
+     * @param expire output parameter to copy expiration time to
+     */
+    virtual bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) {
+        expire = std::chrono::steady_clock::time_point::min();
+        return Get(key, value);
+    }
+
+    /**
+     * Receives snapshot items one by one: key, value and number of seconds item lives for, zero
+     * if it never expires. Returns false to stop the snapshot
+     */
+    using SnapshotWriter = std::function<bool(const std::string &key, const std::string &value, int32_t ttl)>;
+
+    /**
+     * Streams all live associations into the writer. Snapshot is taken at the moment call starts:
+     * changes made while it runs are not seen by the writer, and storage keeps serving them
+     * meanwhile.
+     *
+     * Method returns false if storage doesn't support snapshots or writer stopped it
+     *
+     * @param writer to pass associations to
+     */
+    virtual bool Snapshot(const SnapshotWriter &writer) { return false; }
+
+    /**
+     * Receives statistics one by one: name and value
+     */
+    using StatWriter = std::function<void(const std::string &name, uint64_t value)>;
+
+    /**
+     * Reports statistics of the group, named the way memcached `stats <group>` names them. Empty
+     * group is the general one: curr_items, bytes, limit_maxbytes and evictions. Storage made of
+     * size classes reports them in "items" and "slabs" groups. Storage reports only what it tracks
+     *
+     * @param group of statistics to report
+     * @param writer to pass statistics to
+     */
+    virtual void Stats(const std::string &group, const StatWriter &writer) {}
+
+    /**
+     * Occupancy figures storage keeps up to date as it changes, nullptr if it doesn't. Unlike Stats
+     * they could be read from any thread at any moment without taking storage locks
+     */
+    virtual const Metrics::StorageGauges *Gauges() const { return nullptr; }
+
+protected:
+    /**
+     * Steady clock time association written at the given moment with the given ttl expires at, see
+     * Put/PutIfAbsent/Set with ttl above: never for zero ttl, right away for negative one
+     */
+    static std::chrono::steady_clock::time_point Deadline(int32_t ttl, std::chrono::steady_clock::time_point now) {
+        if (ttl == 0) {
+            return std::chrono::steady_clock::time_point::max();
+        } else if (ttl < 0) {
+            return std::chrono::steady_clock::time_point::min();
+        }
+        return now + std::chrono::seconds(ttl);
+    }
+
+    static std::chrono::steady_clock::time_point Deadline(int32_t ttl) {
+        return Deadline(ttl, std::chrono::steady_clock::now());
+    }
 };
 
 } // namespace Afina
@@ -0,0 +1,77 @@
+#ifndef AFINA_ALLOCATOR_ARENA_H
+#define AFINA_ALLOCATOR_ARENA_H
+
+#include <cstddef>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Anonymous memory region
+ * Memory is mapped right from the system, it is zeroed and committed page by page on first touch.
+ *
+ * With huge pages requested region first tries hugetlbfs pages (MAP_HUGETLB), which must be
+ * reserved by administrator via vm.nr_hugepages. If none are available, region falls back to
+ * normal pages aligned to huge page boundary and advised for transparent huge pages
+ * (MADV_HUGEPAGE). Either way, random access over large region then misses TLB much less often.
+ *
+ * Prefault touches every page up front, so that page faults happen at startup instead of
+ * on the request path.
+ *
+ * Region could be mapped from a file instead, then its content survives the process.
+ *
+ * Arena owns the memory and unmaps it on destruction
+ */
+class Arena {
+public:
+    Arena(std::size_t size, bool huge_pages = false, bool prefault = false);
+
+    /**
+     * Maps size bytes of the file starting from offset, which must be aligned to system page.
+     * Changes are shared with the file. If address is given, region is placed exactly there or
+     * constructor throws AllocError
+     */
+    Arena(int fd, std::size_t offset, std::size_t size, void *address = nullptr, bool prefault = false);
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * Start of the region, aligned at least to system page
+     */
+    void *base() const { return _base; }
+
+    /**
+     * Size of the region as requested
+     */
+    std::size_t size() const { return _size; }
+
+    /**
+     * True if region is backed by hugetlbfs pages
+     */
+    bool huge_tlb() const { return _huge_tlb; }
+
+    /**
+     * Writes changed pages of file backed region to the file and waits for it
+     */
+    void sync();
+
+private:
+    void *_base;
+    std::size_t _size;
+
+    // What to unmap on destruction, differs from the region if it was aligned or rounded
+    void *_mapped;
+    std::size_t _mapped_len;
+
+    bool _huge_tlb;
+
+    // Region is mapped from a file
+    bool _shared;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_ARENA_H
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <cstddef>
+#include <memory>
 
 namespace Afina {
 namespace Allocator {
@@ -10,6 +11,7 @@ namespace Allocator {
 // Forward declaration. Do not include real class definition
 // to avoid expensive macros calculations and increase compile speed
 class Pointer;
+class Arena;
 
 /**
  * Wraps given memory area and provides defagmentation allocator interface on
@@ -18,12 +20,22 @@ class Pointer;
  * Allocator instance doesn't take ownership of wrapped memmory and do not delete it
  * on destruction. So caller must take care of resource cleaup after allocator stop
  * being needs
+ *
+ * Allocator created without caller memory maps its own Arena and unmaps it on destruction
  */
 // TODO: Implements interface to allow usage as C++ allocators
 class Simple {
 public:
     Simple(void *base, const size_t size);
 
+    /**
+     * Wraps memory area of the given size mapped by the allocator itself
+     * @param huge_pages back area with huge pages, see Arena
+     * @param prefault touch area pages up front
+     */
+    Simple(const size_t size, bool huge_pages = false, bool prefault = false);
+    ~Simple();
+
     /**
      * TODO: semantics
      * @param N size_t
@@ -54,6 +66,9 @@ public:
     std::string dump() const;
 
 private:
+    // Own memory, if allocator wasn't given one
+    std::unique_ptr<Arena> _arena;
+
     void *_base;
     const size_t _base_len;
 };
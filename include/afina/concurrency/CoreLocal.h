@@ -1,10 +1,61 @@
 #ifndef AFINA_CONCURRENCY_CORE_LOCAL_H
 #define AFINA_CONCURRENCY_CORE_LOCAL_H
 
+#include <cstddef>
+#include <memory>
+
+#include <sched.h>
+#include <unistd.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class CoreLocal {};
+/**
+ * # Separate instance of T for each CPU core
+ * Get picks the instance of the core calling thread runs on, instances are padded apart so that
+ * cores never write the same cache line.
+ *
+ * Thread could be moved to other core right after Get, or two threads could run on the same core
+ * one after another, so instance is still shared: T must synchronize access by itself. Contention
+ * happens only on such rare moves, a lock inside T stays in the cache of its core
+ */
+template <typename T> class CoreLocal {
+public:
+    CoreLocal() : _cores(Cores()), _slots(new Slot[_cores]) {}
+    ~CoreLocal() {}
+
+    // Instance of the core calling thread runs on
+    T &Get() {
+        int cpu = sched_getcpu();
+        return _slots[cpu < 0 ? 0 : std::size_t(cpu) % _cores].instance;
+    }
+
+    // Calls f for the instance of every core
+    template <typename F> void ForEach(F f) {
+        for (std::size_t i = 0; i < _cores; i++) {
+            f(_slots[i].instance);
+        }
+    }
+
+    std::size_t Size() const { return _cores; }
+
+private:
+    static const std::size_t kCacheLine = 64;
+
+    // Padding after the instance keeps the next one off its last cache line
+    struct Slot {
+        T instance;
+        char padding[kCacheLine];
+    };
+
+    static std::size_t Cores() {
+        long cores = sysconf(_SC_NPROCESSORS_CONF);
+        return cores > 0 ? std::size_t(cores) : 1;
+    }
+
+    std::size_t _cores;
+    std::unique_ptr<Slot[]> _slots;
+};
 
 } // namespace Concurrency
 } // namespace Afina
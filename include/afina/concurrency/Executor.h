@@ -9,6 +9,8 @@
 #include <string>
 #include <thread>
 
+#include <afina/metrics/Locks.h>
+
 namespace Afina {
 namespace Concurrency {
 
@@ -50,7 +52,7 @@ class Executor {
         // Prepare "task"
         auto exec = std::bind(std::forward<F>(func), std::forward<Types>(args)...);
 
-        std::unique_lock<std::mutex> lock(this->mutex);
+        std::unique_lock<Metrics::ProfiledMutex> lock(this->mutex);
         if (state != State::kRun) {
             return false;
         }
@@ -74,14 +76,14 @@ private:
     friend void perform(Executor *executor);
 
     /**
-     * Mutex to protect state below from concurrent modification
+     * Mutex to protect state below from concurrent modification, profiled under the name "executor"
      */
-    std::mutex mutex;
+    Metrics::ProfiledMutex mutex{"executor"};
 
     /**
      * Conditional variable to await new data in case of empty queue
      */
-    std::condition_variable empty_condition;
+    std::condition_variable_any empty_condition;
 
     /**
      * Vector of actual threads that perorm execution
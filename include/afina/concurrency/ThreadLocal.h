@@ -1,10 +1,90 @@
 #ifndef AFINA_CONCURRENCY_THREAD_LOCAL_H
 #define AFINA_CONCURRENCY_THREAD_LOCAL_H
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class ThreadLocal {};
+/**
+ * # Separate instance of T for each thread
+ * Thread gets its instance on the first Get, after that Get is a lookup in a short thread local
+ * list, without locks. Instance of the exited thread is handed over to the next new one, so that
+ * server spawning a thread per connection doesn't grow the set of instances forever.
+ *
+ * Instances are never destroyed while ThreadLocal exists, so ForEach visits everything threads
+ * have ever collected. T must be safe to read by ForEach while its owner changes it
+ */
+template <typename T> class ThreadLocal {
+public:
+    ThreadLocal() : _shared(std::make_shared<Shared>()) {}
+    ~ThreadLocal() {}
+
+    // Instance of the calling thread
+    T &Get() {
+        Cache &cache = ThreadCache();
+        for (const Entry &entry : cache.entries) {
+            if (entry.shared == _shared) {
+                return *entry.instance;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_shared->mutex);
+        T *instance;
+        if (!_shared->released.empty()) {
+            instance = _shared->released.back();
+            _shared->released.pop_back();
+        } else {
+            _shared->instances.emplace_back(new T());
+            instance = _shared->instances.back().get();
+        }
+        cache.entries.push_back(Entry{_shared, instance});
+        return *instance;
+    }
+
+    // Calls f for the instance of every thread, including ones that have exited
+    template <typename F> void ForEach(F f) const {
+        std::lock_guard<std::mutex> lock(_shared->mutex);
+        for (const std::unique_ptr<T> &instance : _shared->instances) {
+            f(static_cast<const T &>(*instance));
+        }
+    }
+
+private:
+    // Shared by ThreadLocal and threads using it, so that thread exiting after ThreadLocal is
+    // destroyed still could release its instance
+    struct Shared {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<T>> instances;
+        std::vector<T *> released;
+    };
+
+    struct Entry {
+        std::shared_ptr<Shared> shared;
+        T *instance;
+    };
+
+    // Instances of the thread, released once thread exits
+    struct Cache {
+        ~Cache() {
+            for (const Entry &entry : entries) {
+                std::lock_guard<std::mutex> lock(entry.shared->mutex);
+                entry.shared->released.push_back(entry.instance);
+            }
+        }
+
+        std::vector<Entry> entries;
+    };
+
+    static Cache &ThreadCache() {
+        static thread_local Cache cache;
+        return cache;
+    }
+
+    std::shared_ptr<Shared> _shared;
+};
 
 } // namespace Concurrency
 } // namespace Afina
@@ -22,6 +22,13 @@ public:
     inline const uint32_t flags() const { return _flags; }
     inline const int32_t expire() const { return _expire; }
 
+    /**
+     * Converts memcached expiration time into storage ttl. Expiration time is either offset in
+     * seconds from now or, if it exceeds 30 days, absolute unix time. Zero means never expire,
+     * negative value means expired immediately
+     */
+    static int32_t ExpireToTTL(int32_t expire);
+
 protected:
     const std::string _key;
     const uint32_t _flags;
@@ -0,0 +1,41 @@
+#ifndef AFINA_EXECUTE_META_ARITHMETIC_H
+#define AFINA_EXECUTE_META_ARITHMETIC_H
+
+#include <string>
+#include <vector>
+
+#include "MetaCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Meta arithmetic: increment or decrement numeric value of the key
+ * Value is kept as decimal string of unsigned 64 bit number. Flags are, in addition to
+ * MetaCommand.h ones:
+ * - q: omit "HD" and "NF" responses
+ * - v: return new value
+ * - N(token): create item with the initial value on miss, token is TTL
+ * - J(token): initial value to use on miss, 0 by default
+ * - D(token): delta to apply, 1 by default
+ * - T(token): update TTL of the item
+ * - M(token): mode switch, I or + to increment (default), D or - to decrement
+ *
+ * Command must write result to the output, which could be:
+ * - "VA <size> <flags>*\r\n<number>" if value was requested
+ * - "HD <flags>*" to indicate success
+ * - "NF <flags>*" if item was not found
+ * - "NS <flags>*" if item could not be stored
+ */
+class MetaArithmetic : public MetaCommand {
+public:
+    MetaArithmetic(const std::string &key, const std::vector<std::string> &flags) : MetaCommand(key, flags) {}
+    ~MetaArithmetic() {}
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_META_ARITHMETIC_H
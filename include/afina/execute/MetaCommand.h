@@ -0,0 +1,71 @@
+#ifndef AFINA_EXECUTE_META_COMMAND_H
+#define AFINA_EXECUTE_META_COMMAND_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Basic class for all meta commands
+ * Meta commands are followed by the key and set of flags. Each flag is a single letter, some
+ * of them carry a token right after the letter, e.g "v", "T30", "Oabc".
+ *
+ * Some flags ask server to return item properties in the response, they are written back in
+ * the same order client passed them:
+ * - O(token): opaque value, echoed back as is
+ * - k: return key
+ * - c: return CAS value
+ * - f: return client flags
+ * - s: return value size
+ * - t: return remaining TTL in seconds, -1 means item never expires. Flag is omitted if storage
+ *   doesn't track expiration
+ *
+ * Flag q turns on quiet mode, in which command omits response for the most common result, so
+ * that client could pipeline commands and wait for "mn" response to get all failures
+ */
+class MetaCommand : public Command {
+public:
+    MetaCommand(const std::string &key, const std::vector<std::string> &flags) : _key(key), _flags(flags) {}
+    ~MetaCommand() {}
+
+    inline const std::string &key() const { return _key; }
+    inline const std::vector<std::string> &flags() const { return _flags; }
+
+protected:
+    /**
+     * Checks that each of command flags is in the given set of letters
+     */
+    bool ValidFlags(const char *allowed) const;
+
+    /**
+     * Looks for the flag with the given letter, if token is not null it gets flag argument
+     */
+    bool HasFlag(char name, std::string *token = nullptr) const;
+
+    /**
+     * Looks for the flag with the given letter and converts its token into storage ttl. Returns
+     * false if token isn't a valid number, ttl is left untouched if there is no such flag
+     */
+    bool TTLFlag(char name, int32_t &ttl) const;
+
+    /**
+     * Appends flags client asked to return, see above. Size is returned only if value is known, TTL
+     * only if expiration time is, see Storage::Get
+     */
+    void ReturnFlags(const std::string *value, std::string &out,
+                     std::chrono::steady_clock::time_point expire = std::chrono::steady_clock::time_point::min()) const;
+
+    const std::string _key;
+    const std::vector<std::string> _flags;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_META_COMMAND_H
@@ -0,0 +1,31 @@
+#ifndef AFINA_EXECUTE_META_DELETE_H
+#define AFINA_EXECUTE_META_DELETE_H
+
+#include <string>
+#include <vector>
+
+#include "MetaCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Meta delete: remove association for the key
+ * Flags are O, k (see MetaCommand.h) and q, which omits both "HD" and "NF" responses
+ *
+ * Command must write result to the output, which could be:
+ * - "HD <flags>*" to indicate success
+ * - "NF <flags>*" if item was not found
+ */
+class MetaDelete : public MetaCommand {
+public:
+    MetaDelete(const std::string &key, const std::vector<std::string> &flags) : MetaCommand(key, flags) {}
+    ~MetaDelete() {}
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_META_DELETE_H
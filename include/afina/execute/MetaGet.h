@@ -0,0 +1,34 @@
+#ifndef AFINA_EXECUTE_META_GET_H
+#define AFINA_EXECUTE_META_GET_H
+
+#include <string>
+#include <vector>
+
+#include "MetaCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Meta get: retrive item properties for the key
+ * Client picks what to fetch by flags, see MetaCommand.h, plus:
+ * - v: return value
+ * - q: omit "EN" response on miss
+ *
+ * Command must write result to the output, which could be:
+ * - "VA <size> <flags>*\r\n<data>" if value was requested and item found
+ * - "HD <flags>*" if item found
+ * - "EN" if item not found
+ */
+class MetaGet : public MetaCommand {
+public:
+    MetaGet(const std::string &key, const std::vector<std::string> &flags) : MetaCommand(key, flags) {}
+    ~MetaGet() {}
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_META_GET_H
@@ -0,0 +1,36 @@
+#ifndef AFINA_EXECUTE_META_SET_H
+#define AFINA_EXECUTE_META_SET_H
+
+#include <string>
+#include <vector>
+
+#include "MetaCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Meta set: store data for the key
+ * Command is followed by the data block size, data itself is passed as command argument.
+ * Flags are, in addition to MetaCommand.h ones:
+ * - q: omit "HD" response on success
+ * - F(token): client flags, ignored since flags are not stored
+ * - T(token): TTL of the item
+ * - M(token): mode switch, one of E (add), A (append), P (prepend), R (replace), S (set, default)
+ *
+ * Command must write result to the output, which could be:
+ * - "HD <flags>*" to indicate success
+ * - "NS <flags>*" if data was not stored, because condition of the mode was not met
+ */
+class MetaSet : public MetaCommand {
+public:
+    MetaSet(const std::string &key, const std::vector<std::string> &flags) : MetaCommand(key, flags) {}
+    ~MetaSet() {}
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_META_SET_H
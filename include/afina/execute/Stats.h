@@ -8,11 +8,32 @@
 namespace Afina {
 namespace Execute {
 
+/**
+ * # Server statistics
+ * Responds with "STAT <name> <value>" lines followed by "END", like memcached does. Group selects
+ * which statistics to report:
+ * - empty: process, connections, request counters summed over all threads and general storage ones
+ * - "items", "slabs": per size class statistics of storage
+ * - "conns": one set of lines per open connection
+ * - "latency": count, p50, p99, p99.9 and max in nanoseconds of parse, execute and write phases
+ *   of each command type, merged over all threads
+ * - "slowlog": latest slow and sampled requests, one line each
+ * - "locks": acquisitions, contended ones, wait and hold time percentiles in nanoseconds of each
+ *   profiled lock. Setting "on" or "off" turns lock profiling on or off and responds with "OK"
+ * - "hotkeys": the most frequently accessed keys among the sampled ones, with the estimated number
+ *   of accesses, its error and share of all sampled. Setting N samples one of N accesses from now
+ *   on, 0 stops sampling, and responds with "OK"
+ */
 class Stats : public Command {
 public:
-    Stats() {}
+    Stats(const std::string &group = std::string(), const std::string &setting = std::string())
+        : _group(group), _setting(setting) {}
     ~Stats() {}
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+private:
+    std::string _group;
+    std::string _setting;
 };
 
 } // namespace Execute
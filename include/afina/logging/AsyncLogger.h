@@ -0,0 +1,389 @@
+#ifndef AFINA_LOGGING_ASYNC_LOGGER_H
+#define AFINA_LOGGING_ASYNC_LOGGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include <spdlog/logger.h>
+
+#include <afina/logging/RateLimit.h>
+
+namespace Afina {
+namespace Logging {
+
+class AsyncLogger;
+class Drain;
+
+/**
+ * # Log call not yet formatted
+ * Format string is kept as a pointer, so it must outlive the record: string literals are fine.
+ * Arguments are copied into payload as raw bytes, strings longer than the room left are truncated
+ */
+struct Record {
+    static const std::size_t kSize = 256;
+    static const std::size_t kPayload = kSize - 5 * sizeof(uint64_t);
+
+    // Decodes payload and formats it by the pattern, see Decoder below
+    typedef void (*Format)(fmt::MemoryWriter &out, const char *pattern, const char *payload);
+
+    AsyncLogger *logger;
+    Format format;
+    const char *pattern;
+    spdlog::log_clock::time_point time;
+    uint64_t level;
+    char payload[kPayload];
+};
+
+/**
+ * Codec of argument of type T: kBinary tells whether it could be copied into the record, the rest
+ * of the types are formatted right in the calling thread
+ */
+template <typename T, typename Enable = void> struct Codec { static const bool kBinary = false; };
+
+// Numbers are copied as they are
+template <typename T> struct Codec<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+    static const bool kBinary = true;
+    typedef T Value;
+
+    static char *Encode(char *out, char *end, const T &value) {
+        if (std::size_t(end - out) < sizeof(T)) {
+            return nullptr;
+        }
+        std::memcpy(out, &value, sizeof(T));
+        return out + sizeof(T);
+    }
+
+    static Value Decode(const char *&in) {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        in += sizeof(T);
+        return value;
+    }
+};
+
+// Strings are copied as length and bytes
+struct StringCodec {
+    static const bool kBinary = true;
+    typedef fmt::StringRef Value;
+
+    static char *Encode(char *out, char *end, const char *data, std::size_t size) {
+        if (std::size_t(end - out) < sizeof(uint32_t)) {
+            return nullptr;
+        }
+        const uint32_t length = uint32_t(std::min(size, std::size_t(end - out) - sizeof(uint32_t)));
+        std::memcpy(out, &length, sizeof(length));
+        std::memcpy(out + sizeof(length), data, length);
+        return out + sizeof(length) + length;
+    }
+
+    static Value Decode(const char *&in) {
+        uint32_t length;
+        std::memcpy(&length, in, sizeof(length));
+        in += sizeof(length) + length;
+        return Value(in - length, length);
+    }
+};
+
+template <> struct Codec<const char *> : StringCodec {
+    static char *Encode(char *out, char *end, const char *value) {
+        return StringCodec::Encode(out, end, value, value == nullptr ? 0 : std::strlen(value));
+    }
+};
+
+template <> struct Codec<char *> : Codec<const char *> {};
+
+template <> struct Codec<std::string> : StringCodec {
+    static char *Encode(char *out, char *end, const std::string &value) {
+        return StringCodec::Encode(out, end, value.data(), value.size());
+    }
+};
+
+// Tells whether all of Args could be copied into the record
+template <typename... Args> struct Binary : std::true_type {};
+
+template <typename Arg, typename... Args>
+struct Binary<Arg, Args...> : std::integral_constant<bool, Codec<Arg>::kBinary && Binary<Args...>::value> {};
+
+inline char *Encode(char *out, char *) { return out; }
+
+// Copies arguments into the record payload, returns nullptr if they don't fit
+template <typename Arg, typename... Args>
+char *Encode(char *out, char *end, const Arg &arg, const Args &... args) {
+    out = Codec<typename std::decay<Arg>::type>::Encode(out, end, arg);
+    return out == nullptr ? nullptr : Encode(out, end, args...);
+}
+
+// Decodes arguments one by one, then formats them all at once
+template <typename... Args> struct Decoder {
+    template <typename... Values>
+    static void Run(fmt::MemoryWriter &out, const char *pattern, const char *, const Values &... values) {
+        out.write(pattern, values...);
+    }
+};
+
+template <typename Arg, typename... Args> struct Decoder<Arg, Args...> {
+    template <typename... Values>
+    static void Run(fmt::MemoryWriter &out, const char *pattern, const char *in, const Values &... values) {
+        const typename Codec<Arg>::Value value = Codec<Arg>::Decode(in);
+        Decoder<Args...>::Run(out, pattern, in, values..., value);
+    }
+};
+
+template <typename... Args> void Format(fmt::MemoryWriter &out, const char *pattern, const char *payload) {
+    Decoder<Args...>::Run(out, pattern, payload);
+}
+
+/**
+ * # Records of a single thread
+ * Ring with one producer, the thread owning it, and one consumer, the drain. Producer never waits:
+ * if the ring is full, record is dropped and counted. Head and tail live on cache lines of their own,
+ * each side reads the other one only when the copy it saw last tells the ring is full or empty.
+ *
+ * Producer writes a record between Enter and Leave, so that the drain stopping could wait for the
+ * records already started instead of losing them
+ */
+class Ring {
+public:
+    static const std::size_t kCapacity = 512;
+
+    Ring();
+
+    /**
+     * Ring of the calling thread, created on the first call. Once thread exits the drain frees it
+     * after the last record is written
+     */
+    static Ring &Local();
+
+    /**
+     * Whether there is a drain to write records out, without it loggers format in the calling thread
+     */
+    static bool Draining();
+
+    /**
+     * Marks the ring busy if there is a drain, returns false and leaves it idle otherwise. Once the
+     * drain is stopped it waits for busy rings, so a record started after a successful Enter is
+     * always written
+     */
+    bool Enter() {
+        _busy.store(true);
+        if (Draining()) {
+            return true;
+        }
+        _busy.store(false, std::memory_order_release);
+        return false;
+    }
+
+    /**
+     * Marks the ring idle, record is either published or abandoned by now
+     */
+    void Leave() { _busy.store(false, std::memory_order_release); }
+
+    /**
+     * Slot for the next record, nullptr if the ring is full. Slot becomes a record only when published,
+     * until then the next call returns the same one
+     */
+    Record *Claim() {
+        const uint64_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail_seen >= kCapacity) {
+            _tail_seen = _tail.load(std::memory_order_acquire);
+            if (head - _tail_seen >= kCapacity) {
+                _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        return &_records[head % kCapacity];
+    }
+
+    /**
+     * Hands the claimed record over to the drain
+     */
+    void Publish() { _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    /**
+     * Records dropped so far for the ring being full
+     */
+    uint64_t Dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    friend class Drain;
+
+    static const std::size_t kCacheLine = 64;
+
+    // Record the drain is to write next, nullptr if there is none yet
+    const Record *Front() {
+        if (_tail_local == _head_seen) {
+            _head_seen = _head.load(std::memory_order_acquire);
+            if (_tail_local == _head_seen) {
+                return nullptr;
+            }
+        }
+        return &_records[_tail_local % kCapacity];
+    }
+
+    void Pop() { _tail.store(++_tail_local, std::memory_order_release); }
+
+    // Written by the owning thread
+    std::atomic<uint64_t> _head;
+    uint64_t _tail_seen;
+    std::atomic<uint64_t> _dropped;
+    std::atomic<bool> _busy;
+    char _producer_padding[kCacheLine - 3 * sizeof(uint64_t) - sizeof(std::atomic<bool>)];
+
+    // Written by the drain
+    std::atomic<uint64_t> _tail;
+    uint64_t _tail_local;
+    uint64_t _head_seen;
+    uint64_t _dropped_reported;
+    char _consumer_padding[kCacheLine - 4 * sizeof(uint64_t)];
+
+    // Set once the owning thread exits
+    std::atomic<bool> _closed;
+
+    // Kernel id of the owning thread, as spdlog prints it
+    std::size_t _thread_id;
+
+    Record _records[kCapacity];
+};
+
+/**
+ * # Logger deferring formatting to the drain
+ * Calls through AsyncLogger copy format string pointer and arguments into the ring of the calling
+ * thread, the drain formats them and writes them to sinks. Numbers and strings are copied as raw
+ * bytes, calls with arguments of other types are formatted in the calling thread and only the text
+ * goes through the ring.
+ *
+ * Calls through the base spdlog::logger, as well as all calls while there is no drain, are written
+ * synchronously the way spdlog does it
+ */
+class AsyncLogger : public spdlog::logger {
+public:
+    AsyncLogger(const std::string &name, spdlog::sink_ptr sink) : spdlog::logger(name, sink) {}
+
+    template <typename Arg1, typename... Args> void trace(const char *fmt, const Arg1 &arg1, const Args &... args) {
+        Push(spdlog::level::trace, fmt, arg1, args...);
+    }
+
+    template <typename Arg1, typename... Args> void debug(const char *fmt, const Arg1 &arg1, const Args &... args) {
+        Push(spdlog::level::debug, fmt, arg1, args...);
+    }
+
+    template <typename Arg1, typename... Args> void info(const char *fmt, const Arg1 &arg1, const Args &... args) {
+        Push(spdlog::level::info, fmt, arg1, args...);
+    }
+
+    template <typename Arg1, typename... Args> void warn(const char *fmt, const Arg1 &arg1, const Args &... args) {
+        Push(spdlog::level::warn, fmt, arg1, args...);
+    }
+
+    template <typename Arg1, typename... Args> void error(const char *fmt, const Arg1 &arg1, const Args &... args) {
+        Push(spdlog::level::err, fmt, arg1, args...);
+    }
+
+    template <typename Arg1, typename... Args> void critical(const char *fmt, const Arg1 &arg1, const Args &... args) {
+        Push(spdlog::level::critical, fmt, arg1, args...);
+    }
+
+    template <typename T> void trace(const T &msg) { Push(spdlog::level::trace, "{}", msg); }
+    template <typename T> void debug(const T &msg) { Push(spdlog::level::debug, "{}", msg); }
+    template <typename T> void info(const T &msg) { Push(spdlog::level::info, "{}", msg); }
+    template <typename T> void warn(const T &msg) { Push(spdlog::level::warn, "{}", msg); }
+    template <typename T> void error(const T &msg) { Push(spdlog::level::err, "{}", msg); }
+    template <typename T> void critical(const T &msg) { Push(spdlog::level::critical, "{}", msg); }
+
+    /**
+     * Logs unless call site went over its limit, see AFINA_LOG_LIMITED
+     */
+    template <typename Arg1, typename... Args>
+    void Limited(RateLimit &limit, spdlog::level::level_enum level, const char *fmt, const Arg1 &arg1,
+                 const Args &... args) {
+        if (Admit(limit, level, fmt)) {
+            Push(level, fmt, arg1, args...);
+        }
+    }
+
+    void Limited(RateLimit &limit, spdlog::level::level_enum level, const char *msg) {
+        if (Admit(limit, level, msg)) {
+            Push(level, "{}", msg);
+        }
+    }
+
+    /**
+     * Formats record and writes it to sinks, called by the drain
+     */
+    void Write(const Record &record, std::size_t thread_id);
+
+private:
+    // Takes a token of the call site, first logging the number of messages it has suppressed
+    bool Admit(RateLimit &limit, spdlog::level::level_enum level, const char *fmt) {
+        uint64_t suppressed;
+        if (!should_log(level) || !limit.Take(suppressed)) {
+            return false;
+        } else if (suppressed > 0) {
+            Push(level, "Suppressed {} messages like \"{}\"", suppressed, fmt);
+        }
+        return true;
+    }
+
+    template <typename... Args> void Push(spdlog::level::level_enum level, const char *fmt, const Args &... args) {
+        if (!should_log(level)) {
+            return;
+        } else if (!Ring::Draining()) {
+            spdlog::logger::log(level, fmt, args...);
+            return;
+        }
+
+        // Drain could be stopped since the check above
+        Ring &ring = Ring::Local();
+        if (!ring.Enter()) {
+            spdlog::logger::log(level, fmt, args...);
+            return;
+        }
+
+        Record *record = ring.Claim();
+        if (record != nullptr) {
+            record->logger = this;
+            record->time = spdlog::details::os::now();
+            record->level = level;
+            if (Fill(*record, fmt, Binary<typename std::decay<Args>::type...>(), args...)) {
+                ring.Publish();
+            }
+        }
+        ring.Leave();
+    }
+
+    template <typename... Args>
+    bool Fill(Record &record, const char *fmt, std::true_type, const Args &... args) {
+        if (Encode(record.payload, record.payload + Record::kPayload, args...) != nullptr) {
+            record.format = &Format<typename std::decay<Args>::type...>;
+            record.pattern = fmt;
+            return true;
+        }
+        return Fill(record, fmt, std::false_type(), args...);
+    }
+
+    template <typename... Args>
+    bool Fill(Record &record, const char *fmt, std::false_type, const Args &... args) {
+        try {
+            fmt::MemoryWriter text;
+            text.write(fmt, args...);
+            Encode(record.payload, record.payload + Record::kPayload, text.str());
+            record.format = &Format<std::string>;
+            record.pattern = "{}";
+            return true;
+        } catch (const std::exception &ex) {
+            _err_handler(ex.what());
+        } catch (...) {
+            _err_handler("Unknown exception");
+        }
+        return false;
+    }
+};
+
+} // namespace Logging
+} // namespace Afina
+
+#endif // AFINA_LOGGING_ASYNC_LOGGER_H
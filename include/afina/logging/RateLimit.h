@@ -0,0 +1,60 @@
+#ifndef AFINA_LOGGING_RATE_LIMIT_H
+#define AFINA_LOGGING_RATE_LIMIT_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace Afina {
+namespace Logging {
+
+/**
+ * # Token bucket of a single log call site
+ * Lets through up to burst messages at once and rate messages a second on average, the rest are
+ * counted as suppressed. Bucket is kept as the time it gets full again, so that threads share it
+ * through a single atomic word and never wait for each other.
+ *
+ * Call sites get their buckets by AFINA_LOG_LIMITED
+ */
+class RateLimit {
+public:
+    static const uint32_t kRate = 10;
+    static const uint32_t kBurst = 10;
+
+    RateLimit(uint32_t rate = kRate, uint32_t burst = kBurst);
+
+    /**
+     * Takes a token if there is one. If so, suppressed is set to the number of messages refused since
+     * the last token taken
+     */
+    bool Take(uint64_t &suppressed);
+
+private:
+    // Nanoseconds a single token takes to come back and the whole bucket to fill up
+    const uint64_t _interval;
+    const uint64_t _capacity;
+
+    // Steady clock time bucket is full again at, provided nothing more is taken
+    std::atomic<uint64_t> _full_at;
+
+    std::atomic<uint64_t> _suppressed;
+};
+
+} // namespace Logging
+} // namespace Afina
+
+/**
+ * Logs through the given AsyncLogger at most RateLimit::kRate times a second with bursts up to
+ * RateLimit::kBurst, per call site. The next message let through after some were refused is
+ * preceded by the note telling how many of them were suppressed:
+ *
+ *     AFINA_LOG_LIMITED(_logger, err, "Failed to accept socket: {}", strerror(errno));
+ *
+ * Severity is one of spdlog::level names: trace, debug, info, warn, err, critical
+ */
+#define AFINA_LOG_LIMITED(logger, severity, ...)                                                                       \
+    do {                                                                                                               \
+        static ::Afina::Logging::RateLimit afina_log_limit;                                                            \
+        (logger)->Limited(afina_log_limit, ::spdlog::level::severity, __VA_ARGS__);                                    \
+    } while (0)
+
+#endif // AFINA_LOGGING_RATE_LIMIT_H
@@ -5,7 +5,7 @@
 #include <memory>
 #include <string>
 
-#include <spdlog/logger.h>
+#include <afina/logging/AsyncLogger.h>
 
 namespace Afina {
 namespace Logging {
@@ -22,7 +22,11 @@ public:
 
     virtual void Stop() = 0;
 
-    virtual std::shared_ptr<spdlog::logger> select(const std::string &name) noexcept = 0;
+    /**
+     * Logger configured for the given name or the closest of its dot separated parents. Calls through
+     * it are formatted and written by a separate thread once the service is started
+     */
+    virtual std::shared_ptr<AsyncLogger> select(const std::string &name) noexcept = 0;
 
     virtual std::unique_ptr<spdlog::logger> create(const std::string &name,
                                                    const std::map<std::string, std::string> &mdc) noexcept = 0;
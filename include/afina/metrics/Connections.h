@@ -0,0 +1,62 @@
+#ifndef AFINA_METRICS_CONNECTIONS_H
+#define AFINA_METRICS_CONNECTIONS_H
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+
+#include "Counters.h"
+
+namespace Afina {
+namespace Metrics {
+
+/**
+ * # Client connection as `stats conns` sees it
+ * Connection is listed from construction till destruction. Only the owner thread calls Active,
+ * any thread could read it
+ */
+class Connection {
+public:
+    Connection();
+    ~Connection();
+
+    // Notes that connection got a request
+    void Active() {
+        _requests.Add();
+        _last_active.store(std::time(nullptr), std::memory_order_relaxed);
+    }
+
+    // Sequence number of the connection since server start
+    uint64_t Id() const { return _id; }
+
+    // Unix time connection was opened at
+    time_t Opened() const { return _opened; }
+
+    // Unix time of the last request
+    time_t LastActive() const { return _last_active.load(std::memory_order_relaxed); }
+
+    // Number of times connection got requests
+    uint64_t Requests() const { return _requests.Get(); }
+
+private:
+    const uint64_t _id;
+    const time_t _opened;
+    std::atomic<time_t> _last_active;
+    Counter _requests;
+};
+
+/**
+ * Calls f for every open connection, connections are not closed meanwhile
+ */
+void ForEachConnection(const std::function<void(const Connection &)> &f);
+
+/**
+ * Number of open connections, takes no lock
+ */
+std::size_t OpenConnections();
+
+} // namespace Metrics
+} // namespace Afina
+
+#endif // AFINA_METRICS_CONNECTIONS_H
@@ -0,0 +1,88 @@
+#ifndef AFINA_METRICS_COUNTERS_H
+#define AFINA_METRICS_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace Afina {
+namespace Metrics {
+
+/**
+ * # Counter changed by a single thread
+ * Only owner thread changes it, so increment is a plain load and store: no locked instruction and
+ * no cache line shared with other writers. Any thread could read it at any moment
+ */
+class Counter {
+public:
+    Counter() : _value(0) {}
+
+    void Add(uint64_t delta = 1) {
+        _value.store(_value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    uint64_t Get() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> _value;
+};
+
+/**
+ * Request statistics, named the way memcached `stats` names them
+ */
+enum class Stat {
+    // Keys looked up by retrieval commands and how many of them were found
+    kCmdGet,
+    kGetHits,
+    kGetMisses,
+
+    // Storage commands: set, add, replace, append, prepend
+    kCmdSet,
+
+    kCmdDelete,
+    kDeleteHits,
+    kDeleteMisses,
+
+    kCmdIncr,
+    kIncrHits,
+    kIncrMisses,
+    kCmdDecr,
+    kDecrHits,
+    kDecrMisses,
+
+    kCmdStats,
+
+    // Traffic of the protocol sessions
+    kBytesRead,
+    kBytesWritten,
+    kTotalConnections,
+
+    kCount
+};
+
+// Name of the statistic in `stats` output
+const char *Name(Stat stat);
+
+/**
+ * # Counters of a single thread
+ */
+struct Counters {
+    Counter &operator[](Stat stat) { return values[static_cast<int>(stat)]; }
+    const Counter &operator[](Stat stat) const { return values[static_cast<int>(stat)]; }
+
+    Counter values[static_cast<int>(Stat::kCount)];
+};
+
+/**
+ * Counters of the calling thread, request processing code adds to them
+ */
+Counters &Local();
+
+/**
+ * Sums counters of all threads into totals, which must have Stat::kCount elements
+ */
+void Collect(uint64_t *totals);
+
+} // namespace Metrics
+} // namespace Afina
+
+#endif // AFINA_METRICS_COUNTERS_H
@@ -0,0 +1,46 @@
+#ifndef AFINA_METRICS_EVENT_LOOP_H
+#define AFINA_METRICS_EVENT_LOOP_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "Histogram.h"
+
+namespace Afina {
+namespace Metrics {
+
+/**
+ * # State of a single epoll loop
+ * Changed by the thread running the loop only
+ */
+struct EventLoop {
+    EventLoop() : ready(0) {}
+
+    // Handles events of a single epoll_wait, ready is the number of them
+    void Begin(uint64_t events) { ready.store(events, std::memory_order_relaxed); }
+
+    // Events got handled in the given number of nanoseconds
+    void End(uint64_t nanoseconds) { busy.Record(nanoseconds); }
+
+    // Nanoseconds spent in handling events of each epoll_wait
+    Histogram busy;
+
+    // Events the last epoll_wait returned: connections the loop has to serve before waiting again
+    std::atomic<uint64_t> ready;
+};
+
+/**
+ * Loop of the calling thread, nonblocking network workers record into it
+ */
+EventLoop &LocalEventLoop();
+
+/**
+ * Calls f for the loop of every thread that ever ran one
+ */
+void ForEachEventLoop(const std::function<void(const EventLoop &)> &f);
+
+} // namespace Metrics
+} // namespace Afina
+
+#endif // AFINA_METRICS_EVENT_LOOP_H
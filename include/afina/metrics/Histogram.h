@@ -0,0 +1,121 @@
+#ifndef AFINA_METRICS_HISTOGRAM_H
+#define AFINA_METRICS_HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "Counters.h"
+
+namespace Afina {
+namespace Metrics {
+
+/**
+ * # Log-linear histogram of durations, changed by a single thread
+ * The way HdrHistogram does it: each power of two range is split into 16 linear buckets, so
+ * recorded value is known with error below 1/16 whatever its magnitude is. Values below 32 are
+ * kept exactly, values of 2^36 and above (about a minute in nanoseconds) share the last bucket.
+ *
+ * Record is a bucket index computation and a couple of single writer counters, any thread could
+ * read histogram meanwhile
+ */
+class Histogram {
+public:
+    // Linear buckets in each power of two range
+    static const int kSubBucketBits = 4;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+
+    // Values of that many bits are told apart
+    static const int kValueBits = 36;
+    static const int kBuckets = (kValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+    Histogram() : _max(0) {}
+
+    void Record(uint64_t value) {
+        _buckets[Index(value)].Add();
+        _count.Add();
+        _sum.Add(value);
+        if (value > _max.load(std::memory_order_relaxed)) {
+            _max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    // Adds values recorded by the other histogram, it could be changed meanwhile
+    void Merge(const Histogram &other) {
+        for (int i = 0; i < kBuckets; i++) {
+            _buckets[i].Add(other._buckets[i].Get());
+        }
+        _count.Add(other._count.Get());
+        _sum.Add(other._sum.Get());
+        if (other.Max() > Max()) {
+            _max.store(other.Max(), std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t Count() const { return _count.Get(); }
+
+    uint64_t Sum() const { return _sum.Get(); }
+
+    uint64_t Max() const { return _max.load(std::memory_order_relaxed); }
+
+    /**
+     * Value that quantile q of recorded values doesn't exceed, rounded up to the bucket bound
+     * but never above the max recorded
+     */
+    uint64_t Quantile(double q) const {
+        const uint64_t count = Count();
+        if (count == 0) {
+            return 0;
+        }
+
+        uint64_t rank = uint64_t(q * count);
+        if (rank < q * count || rank == 0) {
+            rank++;
+        }
+
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; i++) {
+            seen += _buckets[i].Get();
+            if (seen >= rank) {
+                // The last bucket holds values of any size
+                return (i == kBuckets - 1 || UpperBound(i) > Max()) ? Max() : UpperBound(i);
+            }
+        }
+        return Max();
+    }
+
+    // Bucket value belongs to
+    static int Index(uint64_t value) {
+        if (value < 2 * kSubBuckets) {
+            return int(value);
+        }
+
+        const int msb = 63 - __builtin_clzll(value);
+        if (msb >= kValueBits) {
+            return kBuckets - 1;
+        }
+        const int shift = msb - kSubBucketBits;
+        return (shift + 1) * kSubBuckets + int((value >> shift) & (kSubBuckets - 1));
+    }
+
+    // Largest value bucket holds
+    static uint64_t UpperBound(int index) {
+        if (index < 2 * kSubBuckets) {
+            return uint64_t(index);
+        }
+
+        const int shift = index / kSubBuckets - 1;
+        const uint64_t lower = uint64_t(kSubBuckets + index % kSubBuckets) << shift;
+        return lower + (uint64_t(1) << shift) - 1;
+    }
+
+private:
+    Counter _buckets[kBuckets];
+    Counter _count;
+    Counter _sum;
+    std::atomic<uint64_t> _max;
+};
+
+} // namespace Metrics
+} // namespace Afina
+
+#endif // AFINA_METRICS_HISTOGRAM_H
@@ -0,0 +1,95 @@
+#ifndef AFINA_METRICS_HOT_KEYS_H
+#define AFINA_METRICS_HOT_KEYS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Afina {
+namespace Metrics {
+
+/**
+ * Key with its estimated number of accesses. Estimate never falls below the real number and
+ * exceeds it by error at most
+ */
+struct HotKey {
+    std::string key;
+    uint64_t count;
+    uint64_t error;
+};
+
+/**
+ * # Space-saving summary of the most frequent keys
+ * Keeps a fixed number of counters. Key without one takes over the counter of the least frequent
+ * key and inherits its count as error, so any key accessed more than total / capacity times is
+ * sure to hold a counter (Metwally et al., "Efficient computation of frequent and top-k elements
+ * in data streams")
+ */
+class SpaceSaving {
+public:
+    explicit SpaceSaving(std::size_t capacity);
+
+    void Add(const std::string &key, uint64_t count = 1);
+
+    /**
+     * Adds keys counted by the other summary. Key missing in one of full summaries could have
+     * been accessed there as many times as its smallest counter, so that is added to the estimate
+     * and to the error
+     */
+    void Merge(const SpaceSaving &other);
+
+    // Number of keys added
+    uint64_t Total() const { return _total; }
+
+    // The most frequent keys, at most n of them
+    std::vector<HotKey> Top(std::size_t n) const;
+
+    /**
+     * Halves all counts, errors and the total. Keys left with no count lose their counters, so
+     * that keys no longer accessed make room for the new ones
+     */
+    void Decay();
+
+    void Clear();
+
+private:
+    // The smallest count a key absent from the summary could have
+    uint64_t Floor() const;
+
+    std::size_t _capacity;
+    uint64_t _total;
+    std::vector<HotKey> _counters;
+    std::unordered_map<std::string, std::size_t> _index;
+};
+
+/**
+ * Sets how often keys are sampled into the summaries of workers: one of that many accesses at
+ * random, 0 to sample none. Summaries collected before are dropped. Sampling is off by default
+ */
+void SetHotKeySampling(uint32_t every);
+
+uint32_t HotKeySampling();
+
+/**
+ * Notes access to the key by the calling thread, unless it is skipped by sampling
+ */
+void SampleKey(const char *key, std::size_t size);
+
+/**
+ * Merges summaries of all threads, sampled is set to the number of keys sampled
+ */
+std::vector<HotKey> HotKeys(std::size_t n, uint64_t &sampled);
+
+/**
+ * Decays summaries of all threads, see SpaceSaving::Decay. Called periodically it makes the
+ * summaries weigh recent accesses over the old ones: a key stopped being accessed halves its
+ * count with every call and soon gives way to the one accessed now
+ */
+void DecayHotKeys();
+
+} // namespace Metrics
+} // namespace Afina
+
+#endif // AFINA_METRICS_HOT_KEYS_H
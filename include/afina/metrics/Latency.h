@@ -0,0 +1,72 @@
+#ifndef AFINA_METRICS_LATENCY_H
+#define AFINA_METRICS_LATENCY_H
+
+#include <cstdint>
+
+#include "Histogram.h"
+
+namespace Afina {
+namespace Metrics {
+
+/**
+ * Kinds of commands latency is tracked for, text and binary protocol commands alike
+ */
+enum class CommandType {
+    kGet,
+    kSet,
+    kDelete,
+
+    // incr, decr and meta arithmetic
+    kArithmetic,
+
+    kStats,
+
+    // noop, quit and the like
+    kOther,
+
+    kCount
+};
+
+/**
+ * Steps request goes through:
+ * - parse: time spent in parsing the command, possibly over several reads
+ * - execute: time spent in running command over storage, lock waits included
+ * - write: time from response is ready till it is handed to the socket completely
+ */
+enum class Phase { kParse, kExecute, kWrite, kCount };
+
+// Name of the command type in `stats latency` output
+const char *Name(CommandType type);
+
+// Name of the phase in `stats latency` output
+const char *Name(Phase phase);
+
+/**
+ * # Latency histograms of a single thread
+ * Values are nanoseconds
+ */
+struct Latencies {
+    Histogram &operator()(CommandType type, Phase phase) {
+        return values[static_cast<int>(type)][static_cast<int>(phase)];
+    }
+    const Histogram &operator()(CommandType type, Phase phase) const {
+        return values[static_cast<int>(type)][static_cast<int>(phase)];
+    }
+
+    Histogram values[static_cast<int>(CommandType::kCount)][static_cast<int>(Phase::kCount)];
+};
+
+/**
+ * Histograms of the calling thread, request processing code records into them
+ */
+Latencies &LocalLatencies();
+
+/**
+ * Merges histograms of all threads into totals, which must be empty
+ */
+void Collect(Latencies &totals);
+
+} // namespace Metrics
+} // namespace Afina
+
+#endif // AFINA_METRICS_LATENCY_H
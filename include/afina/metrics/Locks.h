@@ -0,0 +1,182 @@
+#ifndef AFINA_METRICS_LOCKS_H
+#define AFINA_METRICS_LOCKS_H
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include <pthread.h>
+
+#include <afina/concurrency/CoreLocal.h>
+
+#include "Histogram.h"
+
+namespace Afina {
+namespace Metrics {
+
+/**
+ * # Contention statistics of a lock
+ * Wait is the time from the attempt to take the lock till it is taken, zero when it was free.
+ * Hold is the time from the lock is taken till it is released. Both are nanoseconds
+ */
+struct LockProfile {
+    void Merge(const LockProfile &other) {
+        acquisitions.Add(other.acquisitions.Get());
+        contended.Add(other.contended.Get());
+        wait.Merge(other.wait);
+        hold.Merge(other.hold);
+    }
+
+    Counter acquisitions;
+    Counter contended;
+    Histogram wait;
+    Histogram hold;
+};
+
+/**
+ * # Lock reported by ForEachLock
+ * Locks register under a name, the ones sharing it (shards of a storage, say) are reported together.
+ * While profiling is off uncontended lock reads no clock at all, contended one still reports its
+ * wait to the slow log, see SlowLog.h
+ */
+class ProfiledLock {
+public:
+    const std::string &Name() const { return _name; }
+
+    // Adds statistics collected so far to the profile, they could be changed meanwhile
+    virtual void Collect(LockProfile &profile) const = 0;
+
+protected:
+    explicit ProfiledLock(const std::string &name) : _name(name) {}
+    virtual ~ProfiledLock() {}
+
+    // Lists the lock for ForEachLock, called once the lock is fully constructed and till it is not
+    void Register();
+    void Unregister();
+
+    // Time spent waiting for the lock that try_lock failed to take, reported to the slow log as well
+    static uint64_t Wait(const std::function<void()> &lock);
+
+    // Counts acquisition of the lock just taken into the profile, returns the time it was taken at
+    // if it was profiled, 0 otherwise
+    static uint64_t Acquired(LockProfile &profile, uint64_t wait, bool contended);
+
+    // Counts the hold of the lock taken at the given time
+    static void Released(LockProfile &profile, uint64_t locked_at);
+
+private:
+    // No copy/move/assign allowed
+    ProfiledLock(const ProfiledLock &);            // = delete;
+    ProfiledLock &operator=(const ProfiledLock &); // = delete;
+
+    const std::string _name;
+};
+
+/**
+ * # Mutex that profiles itself
+ * Satisfies Lockable, so lock_guard and unique_lock take it as they take std::mutex; condition
+ * variables need std::condition_variable_any.
+ *
+ * Statistics are changed only by the thread holding the lock, so they cost no synchronization of
+ * their own
+ */
+class ProfiledMutex : public ProfiledLock {
+public:
+    explicit ProfiledMutex(const std::string &name) : ProfiledLock(name), _locked_at(0) { Register(); }
+    ~ProfiledMutex() { Unregister(); }
+
+    void lock();
+    bool try_lock();
+    void unlock();
+
+    // Statistics collected so far, they could be changed meanwhile
+    const LockProfile &Profile() const { return _profile; }
+
+    // See ProfiledLock above
+    void Collect(LockProfile &profile) const override { profile.Merge(_profile); }
+
+private:
+    std::mutex _mutex;
+    LockProfile _profile;
+
+    // Time lock was taken at if it was profiled, 0 otherwise
+    uint64_t _locked_at;
+};
+
+/**
+ * # Readers-writer lock that profiles itself
+ * C++11 has no shared mutex, so this wraps pthread one. Writers are preferred: storages take it
+ * for writes rarely and writers must not starve behind a steady stream of readers.
+ *
+ * Exclusive side is profiled the way ProfiledMutex is. Readers hold the lock together, so each core
+ * counts shared acquisitions of its own and the time shared side was taken at is kept by ReadGuard.
+ * Both sides are reported together
+ */
+class ProfiledRWLock : public ProfiledLock {
+public:
+    explicit ProfiledRWLock(const std::string &name);
+    ~ProfiledRWLock();
+
+    void lock();
+    void unlock();
+
+    // Takes shared side, returns the value unlock_shared needs
+    uint64_t lock_shared();
+    void unlock_shared(uint64_t locked_at);
+
+    // See ProfiledLock above
+    void Collect(LockProfile &profile) const override;
+
+    /**
+     * Holds shared side of the lock
+     */
+    class ReadGuard {
+    public:
+        ReadGuard(ProfiledRWLock &lock) : _lock(lock), _locked_at(lock.lock_shared()) {}
+        ~ReadGuard() { _lock.unlock_shared(_locked_at); }
+
+    private:
+        ProfiledRWLock &_lock;
+        const uint64_t _locked_at;
+    };
+
+    /**
+     * Holds exclusive side of the lock
+     */
+    class WriteGuard {
+    public:
+        WriteGuard(ProfiledRWLock &lock) : _lock(lock) { _lock.lock(); }
+        ~WriteGuard() { _lock.unlock(); }
+
+    private:
+        ProfiledRWLock &_lock;
+    };
+
+private:
+    pthread_rwlock_t _lock;
+
+    // Exclusive side and time it was taken at if it was profiled, 0 otherwise
+    LockProfile _profile;
+    uint64_t _locked_at;
+
+    // Shared side, by core
+    mutable Concurrency::CoreLocal<LockProfile> _shared;
+};
+
+/**
+ * Turns collection of lock statistics on and off, it is off by default
+ */
+void SetLockProfiling(bool enabled);
+
+bool LockProfiling();
+
+/**
+ * Calls f with the merged statistics of each lock name, in order of names
+ */
+void ForEachLock(const std::function<void(const std::string &, const LockProfile &)> &f);
+
+} // namespace Metrics
+} // namespace Afina
+
+#endif // AFINA_METRICS_LOCKS_H
@@ -0,0 +1,95 @@
+#ifndef AFINA_METRICS_PROBES_H
+#define AFINA_METRICS_PROBES_H
+
+#include <cstdint>
+
+/**
+ * # Static tracepoints
+ * Probes in the format of <sys/sdt.h>, so that perf, bpftrace and SystemTap find them in the binary
+ * by provider "afina":
+ *
+ *     bpftrace -e 'usdt:./afina:afina:storage_evict { @[arg0] = count(); }'
+ *
+ * Probe is a single nop plus a record in the .note.stapsdt ELF section telling its address and where
+ * its arguments live. Tracer attaching to probe replaces nop with a breakpoint, nobody attached costs
+ * nop and keeping arguments in registers. Arguments are passed as 8 byte unsigned integers, strings
+ * as pointers.
+ *
+ * Probes:
+ * - conn_open(id): connection accepted
+ * - conn_close(id, requests, seconds): connection closed, requests it got and its lifetime
+ * - command_parsed(id, command, key_size, value_size, parse_ns): command line or binary header
+ *   parsed; value size is the size of the data block, parse time counts all reads command took
+ * - command_done(id, command, key_size, response_size, execute_ns, lock_wait_ns): command executed
+ * - response_sent(id, commands, write_ns): responses of that many commands handed to the socket,
+ *   write time counts from when the first of them got ready
+ * - storage_get(key_size, value_size, hit): lookup in storage
+ * - storage_put(key_size, value_size): item stored, new or replacing the old one
+ * - storage_evict(key_size, value_size): live item evicted to make room
+ *
+ * Header doesn't need <sys/sdt.h> installed, it writes notes by itself. On targets other than ELF
+ * ones probes compile to nothing
+ */
+
+#if defined(__ELF__) && (defined(__x86_64__) || defined(__aarch64__))
+
+#define AFINA_PROBE_ARG(x) ((uint64_t)(x))
+
+// Note layout is the one of <sys/sdt.h> version 3: probe address, address of .stapsdt.base used
+// to detect prelink adjustments, semaphore address (none), provider, name and argument formats
+#define AFINA_PROBE_(name, args, ...)                                                                                  \
+    __asm__ __volatile__("990: nop\n"                                                                                  \
+                         ".pushsection .note.stapsdt,\"?\",\"note\"\n"                                                 \
+                         ".balign 4\n"                                                                                 \
+                         ".4byte 992f-991f, 994f-993f, 3\n"                                                            \
+                         "991: .asciz \"stapsdt\"\n"                                                                   \
+                         "992: .balign 4\n"                                                                            \
+                         "993: .8byte 990b\n"                                                                          \
+                         ".8byte _.stapsdt.base\n"                                                                     \
+                         ".8byte 0\n"                                                                                  \
+                         ".asciz \"afina\"\n"                                                                          \
+                         ".asciz \"" #name "\"\n"                                                                      \
+                         ".asciz \"" args "\"\n"                                                                       \
+                         "994: .balign 4\n"                                                                            \
+                         ".popsection\n"                                                                               \
+                         ".ifndef _.stapsdt.base\n"                                                                    \
+                         ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"                       \
+                         ".weak _.stapsdt.base\n"                                                                      \
+                         ".hidden _.stapsdt.base\n"                                                                    \
+                         "_.stapsdt.base: .space 1\n"                                                                  \
+                         ".size _.stapsdt.base, 1\n"                                                                   \
+                         ".popsection\n"                                                                               \
+                         ".endif\n"                                                                                    \
+                         :                                                                                             \
+                         : __VA_ARGS__)
+
+#define AFINA_PROBE1(name, a1) AFINA_PROBE_(name, "8@%[p1]", [p1] "nor"(AFINA_PROBE_ARG(a1)))
+
+#define AFINA_PROBE2(name, a1, a2)                                                                                     \
+    AFINA_PROBE_(name, "8@%[p1] 8@%[p2]", [p1] "nor"(AFINA_PROBE_ARG(a1)), [p2] "nor"(AFINA_PROBE_ARG(a2)))
+
+#define AFINA_PROBE3(name, a1, a2, a3)                                                                                 \
+    AFINA_PROBE_(name, "8@%[p1] 8@%[p2] 8@%[p3]", [p1] "nor"(AFINA_PROBE_ARG(a1)), [p2] "nor"(AFINA_PROBE_ARG(a2)),    \
+                 [p3] "nor"(AFINA_PROBE_ARG(a3)))
+
+#define AFINA_PROBE5(name, a1, a2, a3, a4, a5)                                                                         \
+    AFINA_PROBE_(name, "8@%[p1] 8@%[p2] 8@%[p3] 8@%[p4] 8@%[p5]", [p1] "nor"(AFINA_PROBE_ARG(a1)),                     \
+                 [p2] "nor"(AFINA_PROBE_ARG(a2)), [p3] "nor"(AFINA_PROBE_ARG(a3)), [p4] "nor"(AFINA_PROBE_ARG(a4)),    \
+                 [p5] "nor"(AFINA_PROBE_ARG(a5)))
+
+#define AFINA_PROBE6(name, a1, a2, a3, a4, a5, a6)                                                                     \
+    AFINA_PROBE_(name, "8@%[p1] 8@%[p2] 8@%[p3] 8@%[p4] 8@%[p5] 8@%[p6]", [p1] "nor"(AFINA_PROBE_ARG(a1)),             \
+                 [p2] "nor"(AFINA_PROBE_ARG(a2)), [p3] "nor"(AFINA_PROBE_ARG(a3)), [p4] "nor"(AFINA_PROBE_ARG(a4)),    \
+                 [p5] "nor"(AFINA_PROBE_ARG(a5)), [p6] "nor"(AFINA_PROBE_ARG(a6)))
+
+#else
+
+#define AFINA_PROBE1(name, a1)
+#define AFINA_PROBE2(name, a1, a2)
+#define AFINA_PROBE3(name, a1, a2, a3)
+#define AFINA_PROBE5(name, a1, a2, a3, a4, a5)
+#define AFINA_PROBE6(name, a1, a2, a3, a4, a5, a6)
+
+#endif
+
+#endif // AFINA_METRICS_PROBES_H
@@ -0,0 +1,135 @@
+#ifndef AFINA_METRICS_SLOW_LOG_H
+#define AFINA_METRICS_SLOW_LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Afina {
+namespace Metrics {
+
+/**
+ * # Trace of a single request
+ * Plain data with fixed size, so that it could be copied in and out of the ring word by word
+ */
+struct SlowRequest {
+    // Longer keys are truncated, key_size keeps the full size
+    static const std::size_t kMaxKey = 250;
+
+    // Sequence number in the log
+    uint64_t id;
+
+    // Unix time in microseconds request was served at
+    uint64_t time;
+
+    // Kernel id of the thread served request
+    uint64_t worker;
+
+    // Nanoseconds spent in phases, see Latency.h, and in waiting for storage locks while executing.
+    // Write lasts from the response being ready till it is sent to the client as a whole
+    uint64_t parse;
+    uint64_t execute;
+    uint64_t lock_wait;
+    uint64_t write;
+
+    // Bytes of data block sent by the client and of the response
+    uint64_t request_size;
+    uint64_t response_size;
+
+    uint32_t key_size;
+
+    // Request was picked by sampling rather than for being slow
+    bool sampled;
+
+    char command[16];
+    char key[kMaxKey];
+};
+
+/**
+ * # Log of slow and sampled requests
+ * Fixed ring of the latest records. Writers claim a slot with a single atomic increment and never
+ * wait: slot is guarded by its sequence number, odd while being written, and readers drop a record
+ * which sequence number changed while they copied it. Writer lapped by the whole ring in the middle
+ * of its record could still mix it with a newer one, that costs a garbled trace but never an unsafe
+ * read, as records are copied as relaxed atomic words
+ */
+class SlowLog {
+public:
+    static const std::size_t kCapacity = 1024;
+
+    SlowLog();
+
+    /**
+     * @param threshold_us requests served longer than that are recorded, 0 to record none
+     * @param sample_every one of that many requests is recorded at random, whatever its time is,
+     * 0 to sample none
+     */
+    void Configure(uint64_t threshold_us, uint32_t sample_every);
+
+    /**
+     * Whether any request could be recorded at all
+     */
+    bool Enabled() const {
+        return _threshold_ns.load(std::memory_order_relaxed) != 0 || _sample_every.load(std::memory_order_relaxed) != 0;
+    }
+
+    /**
+     * Tells whether request served in the given number of nanoseconds is to be recorded, sampled
+     * is set if it is picked by sampling
+     */
+    bool Wants(uint64_t nanoseconds, bool &sampled) const;
+
+    /**
+     * Adds record, its id is assigned by the log
+     */
+    void Push(SlowRequest &request);
+
+    /**
+     * Copies records starting from the given id, the ones already overwritten are skipped.
+     * Returns id to continue from
+     */
+    uint64_t Read(uint64_t from, std::vector<SlowRequest> &out) const;
+
+    /**
+     * Single line of text describing the record
+     */
+    static std::string Format(const SlowRequest &request);
+
+private:
+    static const std::size_t kWords = (sizeof(SlowRequest) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        std::atomic<uint64_t> words[kWords];
+    };
+
+    std::atomic<uint64_t> _threshold_ns;
+    std::atomic<uint32_t> _sample_every;
+
+    // Id of the next record
+    std::atomic<uint64_t> _head;
+
+    Slot _slots[kCapacity];
+};
+
+/**
+ * Log request processing code writes into
+ */
+SlowLog &SlowRequests();
+
+/**
+ * Storage locks add time they made the calling thread wait to the request it serves
+ */
+void AddLockWait(uint64_t nanoseconds);
+
+/**
+ * Lock wait of the calling thread collected since the last call
+ */
+uint64_t TakeLockWait();
+
+} // namespace Metrics
+} // namespace Afina
+
+#endif // AFINA_METRICS_SLOW_LOG_H
@@ -0,0 +1,70 @@
+#ifndef AFINA_METRICS_STORAGE_GAUGES_H
+#define AFINA_METRICS_STORAGE_GAUGES_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace Afina {
+namespace Metrics {
+
+/**
+ * # Value set by a single thread at a time
+ * Like Counter, but the owner stores the value as it is. Any thread could read it at any moment
+ */
+class Gauge {
+public:
+    Gauge() : _value(0) {}
+
+    void Set(uint64_t value) { _value.store(value, std::memory_order_relaxed); }
+
+    uint64_t Get() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> _value;
+};
+
+/**
+ * # Storage occupancy as the exporter sees it
+ * Storage sets gauges as it changes, under the lock that already guards its state if it has one, so
+ * that reading them takes no lock of the storage and never races with it. Names follow the ones of
+ * Storage::Stats. Size classes are filled by storages made of them only, numbered from 0
+ */
+struct StorageGauges {
+    static const int kClasses = 64;
+
+    struct SizeClass {
+        Gauge chunk_size;
+        Gauge total_pages;
+        Gauge total_chunks;
+        Gauge used_chunks;
+        Gauge items;
+        Gauge evictions;
+    };
+
+    StorageGauges() : classes(0) {}
+
+    // Sets figures every storage has
+    void Publish(uint64_t items, uint64_t bytes, uint64_t evictions) {
+        curr_items.Set(items);
+        this->bytes.Set(bytes);
+        this->evictions.Set(evictions);
+    }
+
+    Gauge curr_items;
+    Gauge bytes;
+    Gauge limit_maxbytes;
+    Gauge evictions;
+
+    // Memory of pages given to size classes and number of pages moved between them
+    Gauge total_malloced;
+    Gauge slabs_moved;
+
+    // Number of size classes below in use, at most kClasses
+    int classes;
+    SizeClass size_classes[kClasses];
+};
+
+} // namespace Metrics
+} // namespace Afina
+
+#endif // AFINA_METRICS_STORAGE_GAUGES_H
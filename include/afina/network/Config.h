@@ -0,0 +1,53 @@
+#ifndef AFINA_NETWORK_CONFIG_H
+#define AFINA_NETWORK_CONFIG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Network layer configuration
+ * Limits server applies to protect itself from connection and request floods
+ */
+class Config {
+public:
+    Config() : listen_backlog(128), max_connections(1024), output_watermark(1 << 20), max_value_size(1 << 20) {}
+
+    /*
+     * Maximum number of connections that kernel keeps waiting for accept()
+     */
+    int listen_backlog;
+
+    /*
+     * Maximum number of client connections served at the same time. Once limit is reached new
+     * connections get "SERVER_ERROR" and closed. Zero means no limit
+     */
+    uint32_t max_connections;
+
+    /*
+     * Maximum number of response bytes that could be queued for a single connection. Once
+     * exceeded server stops reading new commands from the connection until client reads
+     * responses out
+     */
+    std::size_t output_watermark;
+
+    /*
+     * Maximum size of a single value client could send to the server, commands with larger
+     * values are rejected without reading value into the memory
+     */
+    std::size_t max_value_size;
+
+    /*
+     * Path of AF_UNIX socket to accept connections on in addition to TCP port, name started
+     * with '@' denotes socket in the abstract namespace. Empty means no unix socket
+     */
+    std::string unix_socket;
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_CONFIG_H
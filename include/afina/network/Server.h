@@ -4,6 +4,8 @@
 #include <memory>
 #include <vector>
 
+#include <afina/network/Config.h>
+
 namespace Afina {
 class Storage;
 namespace Logging {
@@ -21,6 +23,12 @@ public:
         : pStorage(ps), pLogging(pl) {}
     virtual ~Server() {}
 
+    /**
+     * Replaces network limits. Must be called before Start, changes made after network
+     * started have no effect
+     */
+    void Configure(const Config &cfg) { config = cfg; }
+
     /**
      * Starts network service. After method returns process should
      * listen on the given interface/port pair to process  incomming
@@ -55,6 +63,11 @@ protected:
      * Logging service to be used in order to report application progress
      */
     std::shared_ptr<Afina::Logging::Service> pLogging;
+
+    /**
+     * Limits to be applied to connections
+     */
+    Config config;
 };
 
 } // namespace Network
@@ -0,0 +1,99 @@
+#include <afina/allocator/Arena.h>
+
+#include <cstdint>
+#include <string>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <afina/allocator/Error.h>
+
+namespace Afina {
+namespace Allocator {
+
+// Place mapping at the given address unless something is mapped there already, Linux 4.17+.
+// Older kernels ignore the flag and treat address as a hint, result is checked either way
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+// Size of huge pages on x86-64, larger ones need explicit flags and are not used
+static const std::size_t kHugePageSize = 2 << 20;
+
+static std::size_t RoundUp(std::size_t size, std::size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+Arena::Arena(std::size_t size, bool huge_pages, bool prefault)
+    : _base(nullptr), _size(size), _mapped(nullptr), _mapped_len(0), _huge_tlb(false), _shared(false) {
+    const std::size_t page_size = sysconf(_SC_PAGESIZE);
+    if (size == 0) {
+        size = page_size;
+    }
+
+    if (huge_pages) {
+        _mapped_len = RoundUp(size, kHugePageSize);
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (prefault ? MAP_POPULATE : 0);
+        void *region = mmap(nullptr, _mapped_len, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (region != MAP_FAILED) {
+            _base = _mapped = region;
+            _huge_tlb = true;
+            return;
+        }
+
+        // No reserved huge pages, map extra huge page to align region for transparent ones
+        _mapped_len = RoundUp(size, page_size) + kHugePageSize;
+    } else {
+        _mapped_len = RoundUp(size, page_size);
+    }
+
+    _mapped = mmap(nullptr, _mapped_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (_mapped == MAP_FAILED) {
+        throw AllocError(AllocErrorType::NoMemory, "Failed to map " + std::to_string(_mapped_len) + " bytes");
+    }
+
+    _base = _mapped;
+    if (huge_pages) {
+        _base = reinterpret_cast<void *>(RoundUp(reinterpret_cast<std::uintptr_t>(_mapped), kHugePageSize));
+#ifdef MADV_HUGEPAGE
+        // Advice is a hint only, kernel without THP support just ignores the region
+        madvise(_base, RoundUp(size, page_size), MADV_HUGEPAGE);
+#endif
+    }
+
+    if (prefault) {
+        // Write rather than read: read fault maps shared zero page and the real one comes later
+        volatile char *p = static_cast<char *>(_base);
+        for (std::size_t offset = 0; offset < size; offset += page_size) {
+            p[offset] = 0;
+        }
+    }
+}
+
+Arena::Arena(int fd, std::size_t offset, std::size_t size, void *address, bool prefault)
+    : _base(nullptr), _size(size), _mapped(nullptr), _mapped_len(0), _huge_tlb(false), _shared(true) {
+    const std::size_t page_size = sysconf(_SC_PAGESIZE);
+    _mapped_len = RoundUp(size == 0 ? page_size : size, page_size);
+
+    int flags = MAP_SHARED | (address != nullptr ? MAP_FIXED_NOREPLACE : 0) | (prefault ? MAP_POPULATE : 0);
+    _mapped = mmap(address, _mapped_len, PROT_READ | PROT_WRITE, flags, fd, offset);
+    if (_mapped == MAP_FAILED) {
+        throw AllocError(AllocErrorType::NoMemory, "Failed to map " + std::to_string(_mapped_len) + " bytes of file");
+    } else if (address != nullptr && _mapped != address) {
+        munmap(_mapped, _mapped_len);
+        throw AllocError(AllocErrorType::NoMemory, "Address of file mapping is taken");
+    }
+    _base = _mapped;
+}
+
+Arena::~Arena() { munmap(_mapped, _mapped_len); }
+
+// See Arena.h
+void Arena::sync() {
+    if (_shared) {
+        msync(_mapped, _mapped_len, MS_SYNC);
+    }
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -1,5 +1,6 @@
 #include <afina/allocator/Simple.h>
 
+#include <afina/allocator/Arena.h>
 #include <afina/allocator/Pointer.h>
 
 namespace Afina {
@@ -7,6 +8,11 @@ namespace Allocator {
 
 Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {}
 
+Simple::Simple(size_t size, bool huge_pages, bool prefault)
+    : _arena(new Arena(size, huge_pages, prefault)), _base(_arena->base()), _base_len(size) {}
+
+Simple::~Simple() {}
+
 /**
  * TODO: semantics
  * @param N size_t
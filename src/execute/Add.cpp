@@ -1,5 +1,6 @@
 #include <afina/Storage.h>
 #include <afina/execute/Add.h>
+#include <afina/metrics/Counters.h>
 
 #include <iostream>
 
@@ -10,7 +11,8 @@ namespace Execute {
 // hold data for this key".
 void Add::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Add(" << _key << ")" << args << std::endl;
-    out = storage.PutIfAbsent(_key, args) ? "STORED" : "NOT_STORED";
+    Metrics::Local()[Metrics::Stat::kCmdSet].Add();
+    out = storage.PutIfAbsent(_key, args, ExpireToTTL(_expire)) ? "STORED" : "NOT_STORED";
 }
 
 } // namespace Execute
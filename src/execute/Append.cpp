@@ -1,5 +1,6 @@
 #include <afina/Storage.h>
 #include <afina/execute/Append.h>
+#include <afina/metrics/Counters.h>
 
 #include <iostream>
 
@@ -9,13 +10,14 @@ namespace Execute {
 // memcached protocol: "append" means "add this data to an existing key after existing data".
 void Append::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Append(" << _key << ")" << args << std::endl;
+    Metrics::Local()[Metrics::Stat::kCmdSet].Add();
     std::string value;
     if (!storage.Get(_key, value)) {
         out.assign("NOT_STORED");
         return;
     }
-    storage.Put(_key, value + args);
-    out.assign("STORED");
+    // Plain Set keeps expiration time of the item
+    out.assign(storage.Set(_key, value + args) ? "STORED" : "NOT_STORED");
 }
 
 } // namespace Execute
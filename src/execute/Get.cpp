@@ -1,5 +1,6 @@
 #include <afina/Storage.h>
 #include <afina/execute/Get.h>
+#include <afina/metrics/Counters.h>
 
 #include <iostream>
 #include <iterator>
@@ -28,10 +29,15 @@ void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
 
     std::stringstream outStream;
 
+    Metrics::Counters &counters = Metrics::Local();
     std::string value;
     for (auto &key : _keys) {
-        if (!storage.Get(key, value))
+        counters[Metrics::Stat::kCmdGet].Add();
+        if (!storage.Get(key, value)) {
+            counters[Metrics::Stat::kGetMisses].Add();
             continue;
+        }
+        counters[Metrics::Stat::kGetHits].Add();
         outStream << "VALUE " << key << " 0 " << value.size() << "\r\n";
         outStream << value << "\r\n";
     }
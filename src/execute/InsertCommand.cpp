@@ -0,0 +1,25 @@
+#include <afina/execute/InsertCommand.h>
+
+#include <ctime>
+
+namespace Afina {
+namespace Execute {
+
+// Expiration times above that are treated as unix timestamps, same as memcached does
+static const int32_t kRelativeExpireLimit = 60 * 60 * 24 * 30;
+
+// See InsertCommand.h
+int32_t InsertCommand::ExpireToTTL(int32_t expire) {
+    if (expire <= kRelativeExpireLimit) {
+        return expire;
+    }
+
+    time_t now = std::time(nullptr);
+    if (expire <= now) {
+        return -1;
+    }
+    return int32_t(expire - now);
+}
+
+} // namespace Execute
+} // namespace Afina
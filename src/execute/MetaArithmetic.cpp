@@ -0,0 +1,124 @@
+#include <afina/Storage.h>
+#include <afina/execute/MetaArithmetic.h>
+#include <afina/metrics/Counters.h>
+
+#include <cerrno>
+#include <cstdlib>
+
+namespace Afina {
+namespace Execute {
+
+namespace {
+
+// Parses decimal unsigned 64 bit number, the whole string must be consumed
+bool parse_counter(const std::string &str, uint64_t &result) {
+    if (str.empty() || str[0] < '0' || str[0] > '9') {
+        return false;
+    }
+
+    char *end = nullptr;
+    errno = 0;
+    result = std::strtoull(str.c_str(), &end, 10);
+    return *end == '\0' && errno != ERANGE;
+}
+
+} // namespace
+
+// See MetaArithmetic.h
+void MetaArithmetic::Execute(Storage &storage, const std::string &args, std::string &out) {
+    out.clear();
+
+    std::string mode = "I", delta_str = "1", initial_str = "0";
+    uint64_t delta, initial;
+    int32_t create_ttl = 0, ttl = 0;
+    if (!ValidFlags("cktOqvNJDTM") || (HasFlag('M', &mode) && mode.size() != 1) || !TTLFlag('N', create_ttl) ||
+        !TTLFlag('T', ttl) ||
+        (HasFlag('D', &delta_str) && !parse_counter(delta_str, delta)) ||
+        (HasFlag('J', &initial_str) && !parse_counter(initial_str, initial))) {
+        out.assign("CLIENT_ERROR invalid flag");
+        return;
+    }
+    parse_counter(delta_str, delta);
+    parse_counter(initial_str, initial);
+
+    bool increment;
+    switch (mode[0]) {
+    case 'I':
+    case 'i':
+    case '+':
+        increment = true;
+        break;
+    case 'D':
+    case 'd':
+    case '-':
+        increment = false;
+        break;
+    default:
+        out.assign("CLIENT_ERROR invalid mode for ma");
+        return;
+    }
+
+    uint64_t counter;
+    std::string value;
+    bool exists = storage.Get(_key, value);
+    Metrics::Counters &counters = Metrics::Local();
+    counters[increment ? Metrics::Stat::kCmdIncr : Metrics::Stat::kCmdDecr].Add();
+    if (increment) {
+        counters[exists ? Metrics::Stat::kIncrHits : Metrics::Stat::kIncrMisses].Add();
+    } else {
+        counters[exists ? Metrics::Stat::kDecrHits : Metrics::Stat::kDecrMisses].Add();
+    }
+    if (exists) {
+        if (!parse_counter(value, counter)) {
+            out.assign("CLIENT_ERROR cannot increment or decrement non-numeric value");
+            return;
+        }
+
+        if (increment) {
+            counter += delta;
+        } else {
+            counter = (delta > counter) ? 0 : counter - delta;
+        }
+    } else if (HasFlag('N')) {
+        counter = initial;
+    } else {
+        if (!HasFlag('q')) {
+            out.assign("NF");
+            ReturnFlags(nullptr, out);
+        }
+        return;
+    }
+
+    // Existing item keeps its expiration time unless client asked to update it
+    bool stored;
+    value = std::to_string(counter);
+    if (!exists) {
+        stored = storage.Put(_key, value, create_ttl);
+    } else if (HasFlag('T')) {
+        stored = storage.Set(_key, value, ttl);
+    } else {
+        stored = storage.Set(_key, value);
+    }
+
+    // Item could keep expiration time it had, so it is storage to tell it
+    std::chrono::steady_clock::time_point expire = std::chrono::steady_clock::time_point::min();
+    if (stored && HasFlag('t')) {
+        std::string current;
+        storage.Get(_key, current, expire);
+    }
+
+    if (!stored) {
+        out.assign("NS");
+        ReturnFlags(nullptr, out);
+    } else if (HasFlag('v')) {
+        out.assign("VA ").append(std::to_string(value.size()));
+        ReturnFlags(nullptr, out, expire);
+        out.append("\r\n").append(value);
+    } else if (!HasFlag('q')) {
+        out.assign("HD");
+        ReturnFlags(nullptr, out, expire);
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
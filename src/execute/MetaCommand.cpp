@@ -0,0 +1,94 @@
+#include <afina/execute/MetaCommand.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <afina/execute/InsertCommand.h>
+
+namespace Afina {
+namespace Execute {
+
+// See MetaCommand.h
+bool MetaCommand::ValidFlags(const char *allowed) const {
+    for (auto &flag : _flags) {
+        if (flag.empty() || std::strchr(allowed, flag[0]) == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// See MetaCommand.h
+bool MetaCommand::HasFlag(char name, std::string *token) const {
+    for (auto &flag : _flags) {
+        if (!flag.empty() && flag[0] == name) {
+            if (token != nullptr) {
+                token->assign(flag, 1, std::string::npos);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// See MetaCommand.h
+bool MetaCommand::TTLFlag(char name, int32_t &ttl) const {
+    std::string token;
+    if (!HasFlag(name, &token)) {
+        return true;
+    }
+
+    char *end = nullptr;
+    errno = 0;
+    long value = std::strtol(token.c_str(), &end, 10);
+    if (token.empty() || *end != '\0' || errno == ERANGE || value > INT32_MAX || value < INT32_MIN) {
+        return false;
+    }
+    ttl = InsertCommand::ExpireToTTL(int32_t(value));
+    return true;
+}
+
+// See MetaCommand.h
+void MetaCommand::ReturnFlags(const std::string *value, std::string &out,
+                              std::chrono::steady_clock::time_point expire) const {
+    for (auto &flag : _flags) {
+        switch (flag[0]) {
+        case 'O':
+            out.append(" ").append(flag);
+            break;
+        case 'k':
+            out.append(" k").append(_key);
+            break;
+        case 'c':
+            // CAS isn't supported by storage
+            out.append(" c0");
+            break;
+        case 'f':
+            // Client flags aren't stored
+            out.append(" f0");
+            break;
+        case 's':
+            if (value != nullptr) {
+                out.append(" s").append(std::to_string(value->size()));
+            }
+            break;
+        case 't':
+            if (expire == std::chrono::steady_clock::time_point::max()) {
+                out.append(" t-1");
+            } else if (expire != std::chrono::steady_clock::time_point::min()) {
+                // Rounded up, so that item set with ttl reports it back in full
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    expire - std::chrono::steady_clock::now());
+                out.append(" t").append(std::to_string(std::max<int64_t>(0, (left.count() + 999) / 1000)));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
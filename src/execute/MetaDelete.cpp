@@ -0,0 +1,28 @@
+#include <afina/Storage.h>
+#include <afina/execute/MetaDelete.h>
+#include <afina/metrics/Counters.h>
+
+namespace Afina {
+namespace Execute {
+
+// See MetaDelete.h
+void MetaDelete::Execute(Storage &storage, const std::string &args, std::string &out) {
+    out.clear();
+    if (!ValidFlags("kOq")) {
+        out.assign("CLIENT_ERROR invalid flag");
+        return;
+    }
+
+    bool deleted = storage.Delete(_key);
+    Metrics::Counters &counters = Metrics::Local();
+    counters[Metrics::Stat::kCmdDelete].Add();
+    counters[deleted ? Metrics::Stat::kDeleteHits : Metrics::Stat::kDeleteMisses].Add();
+    if (HasFlag('q')) {
+        return;
+    }
+    out.assign(deleted ? "HD" : "NF");
+    ReturnFlags(nullptr, out);
+}
+
+} // namespace Execute
+} // namespace Afina
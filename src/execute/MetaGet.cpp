@@ -0,0 +1,40 @@
+#include <afina/Storage.h>
+#include <afina/execute/MetaGet.h>
+#include <afina/metrics/Counters.h>
+
+namespace Afina {
+namespace Execute {
+
+// See MetaGet.h
+void MetaGet::Execute(Storage &storage, const std::string &args, std::string &out) {
+    out.clear();
+    if (!ValidFlags("cfkOqstv")) {
+        out.assign("CLIENT_ERROR invalid flag");
+        return;
+    }
+
+    Metrics::Counters &counters = Metrics::Local();
+    counters[Metrics::Stat::kCmdGet].Add();
+    std::string value;
+    std::chrono::steady_clock::time_point expire;
+    if (!storage.Get(_key, value, expire)) {
+        counters[Metrics::Stat::kGetMisses].Add();
+        if (!HasFlag('q')) {
+            out.assign("EN");
+        }
+        return;
+    }
+    counters[Metrics::Stat::kGetHits].Add();
+
+    if (HasFlag('v')) {
+        out.assign("VA ").append(std::to_string(value.size()));
+        ReturnFlags(&value, out, expire);
+        out.append("\r\n").append(value);
+    } else {
+        out.assign("HD");
+        ReturnFlags(&value, out, expire);
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
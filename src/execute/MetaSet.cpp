@@ -0,0 +1,55 @@
+#include <afina/Storage.h>
+#include <afina/execute/MetaSet.h>
+#include <afina/metrics/Counters.h>
+
+namespace Afina {
+namespace Execute {
+
+// See MetaSet.h
+void MetaSet::Execute(Storage &storage, const std::string &args, std::string &out) {
+    out.clear();
+    std::string mode = "S";
+    int32_t ttl = 0;
+    if (!ValidFlags("ckOqTFM") || (HasFlag('M', &mode) && mode.size() != 1) || !TTLFlag('T', ttl)) {
+        out.assign("CLIENT_ERROR invalid flag");
+        return;
+    }
+
+    Metrics::Local()[Metrics::Stat::kCmdSet].Add();
+    bool stored = false;
+    std::string value;
+    switch (mode[0]) {
+    case 'S':
+    case 's':
+        stored = storage.Put(_key, args, ttl);
+        break;
+    case 'E':
+    case 'e':
+        stored = storage.PutIfAbsent(_key, args, ttl);
+        break;
+    case 'R':
+    case 'r':
+        stored = storage.Set(_key, args, ttl);
+        break;
+    case 'A':
+    case 'a':
+        stored = storage.Get(_key, value) && storage.Set(_key, value + args);
+        break;
+    case 'P':
+    case 'p':
+        stored = storage.Get(_key, value) && storage.Set(_key, args + value);
+        break;
+    default:
+        out.assign("CLIENT_ERROR invalid mode for ms");
+        return;
+    }
+
+    if (stored && HasFlag('q')) {
+        return;
+    }
+    out.assign(stored ? "HD" : "NS");
+    ReturnFlags(nullptr, out);
+}
+
+} // namespace Execute
+} // namespace Afina
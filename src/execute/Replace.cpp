@@ -1,5 +1,6 @@
 #include <afina/Storage.h>
 #include <afina/execute/Replace.h>
+#include <afina/metrics/Counters.h>
 
 #include <iostream>
 
@@ -11,13 +12,8 @@ namespace Execute {
 
 void Replace::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Replace(" << _key << "): " << args << std::endl;
-    std::string value;
-    if (storage.Get(_key, value)) {
-        storage.Set(_key, args);
-        out = "STORED";
-    } else {
-        out = "NOT_STORED";
-    }
+    Metrics::Local()[Metrics::Stat::kCmdSet].Add();
+    out = storage.Set(_key, args, ExpireToTTL(_expire)) ? "STORED" : "NOT_STORED";
 }
 
 } // namespace Execute
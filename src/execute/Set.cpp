@@ -1,5 +1,6 @@
 #include <afina/Storage.h>
 #include <afina/execute/Set.h>
+#include <afina/metrics/Counters.h>
 
 #include <iostream>
 
@@ -9,8 +10,8 @@ namespace Execute {
 // memcached protocol: "set" means "store this data".
 void Set::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Set(" << _key << "): " << args << std::endl;
-    storage.Put(_key, args);
-    out = "STORED";
+    Metrics::Local()[Metrics::Stat::kCmdSet].Add();
+    out = storage.Put(_key, args, ExpireToTTL(_expire)) ? "STORED" : "NOT_STORED";
 }
 
 } // namespace Execute
@@ -1,14 +1,157 @@
 #include <afina/Storage.h>
 #include <afina/execute/Stats.h>
+#include <afina/metrics/Connections.h>
+#include <afina/metrics/Counters.h>
+#include <afina/metrics/HotKeys.h>
+#include <afina/metrics/Latency.h>
+#include <afina/metrics/Locks.h>
+#include <afina/metrics/SlowLog.h>
 
-#include <iostream>
-#include <iterator>
-#include <sstream>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
 
 namespace Afina {
 namespace Execute {
 
-void Stats::Execute(Storage &storage, const std::string &args, std::string &out) { out.assign("END"); }
+namespace {
+
+// Keys listed by `stats hotkeys`
+const std::size_t kHotKeys = 20;
+
+// Server start time, as close to the process start as static initialization gets
+const time_t started = std::time(nullptr);
+
+void stat(std::string &out, const std::string &name, const std::string &value) {
+    out.append("STAT ").append(name).append(" ").append(value).append("\r\n");
+}
+
+void stat(std::string &out, const std::string &name, uint64_t value) { stat(out, name, std::to_string(value)); }
+
+// CPU time in memcached format: seconds.microseconds
+std::string cpu_time(const struct timeval &tv) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%ld.%06ld", long(tv.tv_sec), long(tv.tv_usec));
+    return buffer;
+}
+
+// Percentiles of histogram of nanoseconds
+void percentiles(std::string &out, const std::string &prefix, const Metrics::Histogram &histogram) {
+    stat(out, prefix + "p50", histogram.Quantile(0.5));
+    stat(out, prefix + "p99", histogram.Quantile(0.99));
+    stat(out, prefix + "p99.9", histogram.Quantile(0.999));
+    stat(out, prefix + "max", histogram.Max());
+}
+
+} // namespace
+
+// See Stats.h
+void Stats::Execute(Storage &storage, const std::string &args, std::string &out) {
+    Metrics::Local()[Metrics::Stat::kCmdStats].Add();
+    out.clear();
+    auto storage_stat = [&out](const std::string &name, uint64_t value) { stat(out, name, value); };
+
+    if (_group.empty()) {
+        const time_t now = std::time(nullptr);
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        stat(out, "pid", getpid());
+        stat(out, "uptime", now - started);
+        stat(out, "time", now);
+        stat(out, "pointer_size", 8 * sizeof(void *));
+        stat(out, "rusage_user", cpu_time(usage.ru_utime));
+        stat(out, "rusage_system", cpu_time(usage.ru_stime));
+        stat(out, "curr_connections", Metrics::OpenConnections());
+
+        // Counters are summed only now, request processing never writes shared memory for them
+        uint64_t totals[static_cast<int>(Metrics::Stat::kCount)];
+        Metrics::Collect(totals);
+        for (int i = 0; i < static_cast<int>(Metrics::Stat::kCount); i++) {
+            stat(out, Metrics::Name(static_cast<Metrics::Stat>(i)), totals[i]);
+        }
+        storage.Stats(_group, storage_stat);
+    } else if (_group == "items" || _group == "slabs") {
+        storage.Stats(_group, storage_stat);
+    } else if (_group == "conns") {
+        const time_t now = std::time(nullptr);
+        Metrics::ForEachConnection([&out, now](const Metrics::Connection &connection) {
+            const std::string prefix = std::to_string(connection.Id()) + ":";
+            stat(out, prefix + "age", now - connection.Opened());
+            stat(out, prefix + "secs_since_last_cmd", now - connection.LastActive());
+            stat(out, prefix + "requests", connection.Requests());
+        });
+    } else if (_group == "latency") {
+        // Histograms are large enough to keep them off the stack
+        std::unique_ptr<Metrics::Latencies> totals(new Metrics::Latencies());
+        Metrics::Collect(*totals);
+        for (int type = 0; type < static_cast<int>(Metrics::CommandType::kCount); type++) {
+            for (int phase = 0; phase < static_cast<int>(Metrics::Phase::kCount); phase++) {
+                const Metrics::Histogram &histogram = totals->values[type][phase];
+                if (histogram.Count() == 0) {
+                    continue;
+                }
+
+                const std::string prefix = std::string(Metrics::Name(static_cast<Metrics::CommandType>(type))) + ":" +
+                                           Metrics::Name(static_cast<Metrics::Phase>(phase)) + ":";
+                stat(out, prefix + "count", histogram.Count());
+                percentiles(out, prefix, histogram);
+            }
+        }
+    } else if (_group == "slowlog") {
+        std::vector<Metrics::SlowRequest> requests;
+        Metrics::SlowRequests().Read(0, requests);
+        for (const Metrics::SlowRequest &request : requests) {
+            stat(out, "slowlog:" + std::to_string(request.id), Metrics::SlowLog::Format(request));
+        }
+    } else if (_group == "locks" && !_setting.empty()) {
+        if (_setting == "on" || _setting == "off") {
+            Metrics::SetLockProfiling(_setting == "on");
+            out.assign("OK");
+        } else {
+            out.assign("CLIENT_ERROR lock profiling is either on or off");
+        }
+        return;
+    } else if (_group == "locks") {
+        stat(out, "profiling", Metrics::LockProfiling() ? "on" : "off");
+        Metrics::ForEachLock([&out](const std::string &name, const Metrics::LockProfile &profile) {
+            stat(out, name + ":acquisitions", profile.acquisitions.Get());
+            stat(out, name + ":contended", profile.contended.Get());
+            percentiles(out, name + ":wait:", profile.wait);
+            percentiles(out, name + ":hold:", profile.hold);
+        });
+    } else if (_group == "hotkeys" && !_setting.empty()) {
+        char *end;
+        const unsigned long every = std::strtoul(_setting.c_str(), &end, 10);
+        if (*end != '\0' || _setting[0] == '-' || every > UINT32_MAX) {
+            out.assign("CLIENT_ERROR sampling is one of N accesses");
+            return;
+        }
+        Metrics::SetHotKeySampling(every);
+        out.assign("OK");
+        return;
+    } else if (_group == "hotkeys") {
+        uint64_t sampled;
+        std::vector<Metrics::HotKey> keys = Metrics::HotKeys(kHotKeys, sampled);
+        stat(out, "sample_every", Metrics::HotKeySampling());
+        stat(out, "sampled", sampled);
+        for (const Metrics::HotKey &key : keys) {
+            char share[32];
+            std::snprintf(share, sizeof(share), "%.2f", sampled > 0 ? 100.0 * key.count / sampled : 0.0);
+            stat(out, "hotkey:" + key.key,
+                 "count=" + std::to_string(key.count) + " error=" + std::to_string(key.error) + " share=" + share);
+        }
+    } else {
+        out.assign("CLIENT_ERROR unknown stats group");
+        return;
+    }
+    out.append("END");
+}
 
 } // namespace Execute
 } // namespace Afina
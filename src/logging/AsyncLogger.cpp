@@ -0,0 +1,30 @@
+#include <afina/logging/AsyncLogger.h>
+
+namespace Afina {
+namespace Logging {
+
+static_assert(sizeof(Record) == Record::kSize, "Records are laid out by cache lines");
+
+const std::size_t Record::kSize;
+const std::size_t Record::kPayload;
+const std::size_t Ring::kCapacity;
+
+// See AsyncLogger.h
+void AsyncLogger::Write(const Record &record, std::size_t thread_id) {
+    try {
+        spdlog::details::log_msg msg;
+        msg.logger_name = &_name;
+        msg.level = static_cast<spdlog::level::level_enum>(record.level);
+        msg.time = record.time;
+        msg.thread_id = thread_id;
+        record.format(msg.raw, record.pattern, record.payload);
+        _sink_it(msg);
+    } catch (const std::exception &ex) {
+        _err_handler(ex.what());
+    } catch (...) {
+        _err_handler("Unknown exception");
+    }
+}
+
+} // namespace Logging
+} // namespace Afina
@@ -0,0 +1,168 @@
+#include "Drain.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace Afina {
+namespace Logging {
+
+namespace {
+
+// How long the drain sleeps once rings are empty, records wait for it in rings meanwhile
+const std::chrono::milliseconds kIdle(5);
+
+// Records written between looks for new rings and drops
+const std::size_t kBatch = 4096;
+
+// Rings of all threads, the drain is the only one to free them
+std::mutex rings_mutex;
+std::vector<Ring *> rings;
+
+std::atomic<bool> draining(false);
+
+} // namespace
+
+Ring::Ring()
+    : _head(0), _tail_seen(0), _dropped(0), _busy(false), _tail(0), _tail_local(0), _head_seen(0), _dropped_reported(0),
+      _closed(false), _thread_id(spdlog::details::os::thread_id()) {}
+
+// See AsyncLogger.h
+Ring &Ring::Local() {
+    // Marks ring closed once its thread exits
+    struct Owner {
+        Ring *ring = nullptr;
+        ~Owner() {
+            if (ring != nullptr) {
+                ring->_closed.store(true, std::memory_order_release);
+            }
+        }
+    };
+    static thread_local Owner owner;
+
+    if (owner.ring == nullptr) {
+        owner.ring = new Ring();
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        rings.push_back(owner.ring);
+    }
+    return *owner.ring;
+}
+
+// See AsyncLogger.h
+bool Ring::Draining() { return draining.load(); }
+
+Drain::Drain() : _running(false) {}
+
+Drain::~Drain() { Stop(); }
+
+// See Drain.h
+void Drain::Start() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_running) {
+        return;
+    }
+
+    _running = true;
+    _thread = std::thread(&Drain::OnRun, this);
+    draining.store(true);
+}
+
+// See Drain.h
+void Drain::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running) {
+            return;
+        }
+
+        // Calls that saw no drain format by themselves, the ones that saw it are drained before the
+        // thread exits. Drain sees _running reset only after this store
+        draining.store(false);
+        _running = false;
+    }
+    _stopped.notify_all();
+    _thread.join();
+}
+
+// See Drain.h
+void Drain::OnRun() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_running) {
+        lock.unlock();
+        const std::size_t written = Step(kBatch);
+        lock.lock();
+        if (written == 0) {
+            _stopped.wait_for(lock, kIdle, [this]() { return !_running; });
+        }
+    }
+    lock.unlock();
+
+    // Writer could still be in the middle of the record it started before the drain was stopped. Ring
+    // that is idle now either has its record published or sees no drain on the next Enter
+    {
+        std::lock_guard<std::mutex> rings_lock(rings_mutex);
+        for (Ring *ring : rings) {
+            while (ring->_busy.load()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    while (Step(kBatch) > 0) {
+    }
+}
+
+// See Drain.h
+std::size_t Drain::Step(std::size_t limit) {
+    std::vector<Ring *> current;
+    uint64_t dropped = 0;
+    {
+        // Ring closed before it is seen empty got no records in between, so it could be freed
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        auto end = std::remove_if(rings.begin(), rings.end(), [&dropped](Ring *ring) {
+            const bool closed = ring->_closed.load(std::memory_order_acquire);
+            const uint64_t ring_dropped = ring->Dropped();
+            dropped += ring_dropped - ring->_dropped_reported;
+            ring->_dropped_reported = ring_dropped;
+            if (closed && ring->Front() == nullptr) {
+                delete ring;
+                return true;
+            }
+            return false;
+        });
+        rings.erase(end, rings.end());
+        current = rings;
+    }
+
+    if (dropped > 0) {
+        std::shared_ptr<spdlog::logger> root = spdlog::get("root");
+        if (root) {
+            root->warn("Dropped {} log records, logging threads outpaced the drain", dropped);
+        }
+    }
+
+    // Oldest of ring heads goes first, so that records of different threads keep their order
+    std::size_t written = 0;
+    for (; written < limit; written++) {
+        Ring *next = nullptr;
+        const Record *first = nullptr;
+        for (Ring *ring : current) {
+            const Record *record = ring->Front();
+            if (record != nullptr && (first == nullptr || record->time < first->time)) {
+                next = ring;
+                first = record;
+            }
+        }
+        if (next == nullptr) {
+            break;
+        }
+
+        first->logger->Write(*first, next->_thread_id);
+        next->Pop();
+    }
+    return written;
+}
+
+} // namespace Logging
+} // namespace Afina
@@ -0,0 +1,49 @@
+#ifndef AFINA_LOGGING_DRAIN_H
+#define AFINA_LOGGING_DRAIN_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+#include <afina/logging/AsyncLogger.h>
+
+namespace Afina {
+namespace Logging {
+
+/**
+ * # Writes records of all the rings out
+ * Runs its own thread that merges records of thread rings by time, formats and writes them to sinks.
+ * Once rings are empty it sleeps for a while, so that logging threads never have to wake it up.
+ * Drops are reported by the "root" logger.
+ *
+ * There is a single drain in the process, rings are global
+ */
+class Drain {
+public:
+    Drain();
+    ~Drain();
+
+    // Starts the thread, since then AsyncLogger calls go through rings
+    void Start();
+
+    // Writes everything left in rings, records being written meanwhile included, and stops the thread
+    void Stop();
+
+private:
+    // Drains rings, runs in its own thread
+    void OnRun();
+
+    // Writes up to the given number of records, returns how many were written
+    std::size_t Step(std::size_t limit);
+
+    std::mutex _mutex;
+    std::condition_variable _stopped;
+    bool _running;
+    std::thread _thread;
+};
+
+} // namespace Logging
+} // namespace Afina
+
+#endif // AFINA_LOGGING_DRAIN_H
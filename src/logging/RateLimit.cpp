@@ -0,0 +1,39 @@
+#include <afina/logging/RateLimit.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace Afina {
+namespace Logging {
+
+const uint32_t RateLimit::kRate;
+const uint32_t RateLimit::kBurst;
+
+RateLimit::RateLimit(uint32_t rate, uint32_t burst)
+    : _interval(1000000000 / std::max(rate, 1u)), _capacity(_interval * std::max(burst, 1u)), _full_at(0),
+      _suppressed(0) {}
+
+// See RateLimit.h
+bool RateLimit::Take(uint64_t &suppressed) {
+    const uint64_t now =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+
+    // Taking a token pushes the time bucket is full again by one interval, bucket is empty once that
+    // time is more than a whole bucket away
+    uint64_t full_at = _full_at.load(std::memory_order_relaxed);
+    uint64_t taken;
+    do {
+        taken = std::max(full_at, now) + _interval;
+        if (taken - now > _capacity) {
+            _suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    } while (!_full_at.compare_exchange_weak(full_at, taken, std::memory_order_relaxed));
+
+    suppressed = _suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace Logging
+} // namespace Afina
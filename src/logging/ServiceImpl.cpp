@@ -64,9 +64,6 @@ ServiceImpl::~ServiceImpl() = default;
 
 // See ServiceImpl.h
 void ServiceImpl::Start() {
-    // Setup spdlog
-    spdlog::set_async_mode(512, spdlog::async_overflow_policy::block_retry, nullptr, std::chrono::seconds(2));
-
     // First build appenders
     std::map<std::string, spdlog::sink_ptr> results;
     for (auto it = _cfg->appenders.begin(); it != _cfg->appenders.end(); ++it) {
@@ -165,7 +162,7 @@ void ServiceImpl::Start() {
         }
 
         // Create logger
-        std::shared_ptr<spdlog::logger> logger = std::make_shared<spdlog::logger>(name, ptr);
+        std::shared_ptr<AsyncLogger> logger = std::make_shared<AsyncLogger>(name, ptr);
         logger->set_level(lvl);
         logger->set_pattern(pLogger.format);
         logger->flush_on(spdlog::level::err);
@@ -173,23 +170,25 @@ void ServiceImpl::Start() {
     }
 
     // Check that root exists
-    _root = spdlog::get("root");
+    _root = std::static_pointer_cast<AsyncLogger>(spdlog::get("root"));
     if (_root == nullptr) {
         throw std::runtime_error("Root logger not configured");
     }
+    _drain.Start();
 }
 
 // See ServiceImpl.h
-void ServiceImpl::Stop() {}
+void ServiceImpl::Stop() { _drain.Stop(); }
 
 // See ServiceImpl.h
-std::shared_ptr<spdlog::logger> ServiceImpl::select(const std::string &name) noexcept {
+std::shared_ptr<AsyncLogger> ServiceImpl::select(const std::string &name) noexcept {
     std::string tmp_name = name;
     std::shared_ptr<spdlog::logger> result = nullptr;
     do {
+        // Service registers nothing but AsyncLogger
         result = spdlog::get(tmp_name);
         if (result) {
-            return result;
+            return std::static_pointer_cast<AsyncLogger>(result);
         }
 
         std::size_t idx = tmp_name.find_last_of('.');
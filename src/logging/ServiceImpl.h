@@ -4,6 +4,8 @@
 #include <afina/logging/Config.h>
 #include <afina/logging/Service.h>
 
+#include "Drain.h"
+
 namespace Afina {
 namespace Logging {
 
@@ -23,7 +25,7 @@ public:
     void Stop() override;
 
     // See Service.h
-    std::shared_ptr<spdlog::logger> select(const std::string &name) noexcept override;
+    std::shared_ptr<AsyncLogger> select(const std::string &name) noexcept override;
 
     // See Service.h
     std::unique_ptr<spdlog::logger> create(const std::string &name,
@@ -36,7 +38,10 @@ private:
     std::shared_ptr<Config> _cfg;
 
     // TODO: bug: if service not started all select return _root, which is nullptr
-    std::shared_ptr<spdlog::logger> _root;
+    std::shared_ptr<AsyncLogger> _root;
+
+    // Writes out what loggers put in thread rings
+    Drain _drain;
 };
 
 } // namespace Logging
@@ -1,4 +1,5 @@
 #include <chrono>
+#include <fstream>
 #include <iostream>
 #include <memory>
 
@@ -12,16 +13,30 @@
 #include <afina/Storage.h>
 #include <afina/Version.h>
 #include <afina/logging/Service.h>
+#include <afina/metrics/HotKeys.h>
+#include <afina/metrics/Locks.h>
+#include <afina/metrics/SlowLog.h>
 #include <afina/network/Server.h>
 
 #include "logging/ServiceImpl.h"
+#include "metrics/Exporter.h"
+#include "metrics/SlowLogDumper.h"
 #include "network/mt_blocking/ServerImpl.h"
 #include "network/mt_nonblocking/ServerImpl.h"
 #include "network/st_blocking/ServerImpl.h"
 #include "network/st_nonblocking/ServerImpl.h"
 
+#include "replication/Follower.h"
+#include "replication/Leader.h"
+#include "storage/ARC.h"
+#include "storage/ClockCache.h"
+#include "storage/DurableStorage.h"
+#include "storage/HotReplicas.h"
+#include "storage/S3FIFO.h"
+#include "storage/SlabLRU.h"
 #include "storage/SimpleLRU.h"
 #include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TinyLFU.h"
 
 using namespace Afina;
 
@@ -50,14 +65,81 @@ public:
             storage_type = options["storage"].as<std::string>();
         }
 
+        std::size_t memory = 1024;
+        if (options.count("memory") > 0) {
+            memory = options["memory"].as<std::size_t>();
+        }
+
         if (storage_type == "st_lru") {
-            storage = std::make_shared<Afina::Backend::SimpleLRU>();
+            storage = std::make_shared<Afina::Backend::SimpleLRU>(memory);
         } else if (storage_type == "mt_lru") {
-            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>();
+            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>(memory);
+        } else if (storage_type == "st_tinylfu") {
+            storage = std::make_shared<Afina::Backend::TinyLFU>(memory);
+        } else if (storage_type == "clock") {
+            storage = std::make_shared<Afina::Backend::ClockCache>(memory);
+        } else if (storage_type == "s3fifo") {
+            storage = std::make_shared<Afina::Backend::S3FIFO>(memory);
+        } else if (storage_type == "st_arc") {
+            storage = std::make_shared<Afina::Backend::ARC>(memory);
+        } else if (storage_type == "st_slab") {
+            Afina::Backend::SlabLRU::Options slab_options;
+            slab_options.huge_pages = options.count("huge-pages") > 0;
+            slab_options.prefault = options.count("prefault") > 0;
+            if (options.count("persist") > 0) {
+                slab_options.path = options["persist"].as<std::string>();
+            }
+            storage = std::make_shared<Afina::Backend::SlabLRU>(memory, slab_options);
         } else {
             throw std::runtime_error("Unknown storage type");
         }
 
+        if (options.count("oplog") > 0) {
+            std::chrono::milliseconds fsync_interval(100);
+            if (options.count("oplog-fsync-ms") > 0) {
+                fsync_interval = std::chrono::milliseconds(options["oplog-fsync-ms"].as<uint32_t>());
+            }
+            uint64_t compact_size = 64 << 20;
+            if (options.count("oplog-compact-size") > 0) {
+                compact_size = options["oplog-compact-size"].as<uint64_t>();
+            }
+
+            std::unique_ptr<Afina::Backend::OpLog> log(new Afina::Backend::OpLog(
+                options["oplog"].as<std::string>(), fsync_interval, compact_size, logService));
+            storage = std::make_shared<Afina::Backend::DurableStorage>(storage, std::move(log));
+        }
+
+        // Hot keys are found by sampling, one of 100 accesses is enough to tell keys taking a noticeable
+        // share of traffic
+        if (options.count("hot-replicas") > 0) {
+            if (options.count("hotkey-sample") == 0) {
+                Afina::Metrics::SetHotKeySampling(100);
+            }
+            storage = std::make_shared<Afina::Backend::HotReplicas>(storage, options["hot-replicas"].as<std::size_t>());
+        }
+
+        // Replication threads access storage along with the network ones and need its snapshots
+        if ((options.count("replication-port") > 0 || options.count("replicate-from") > 0) &&
+            storage_type != "mt_lru") {
+            throw std::runtime_error("Replication needs mt_lru storage");
+        }
+        if (options.count("replication-port") > 0) {
+            std::size_t backlog_size = 64 << 20;
+            if (options.count("replication-backlog") > 0) {
+                backlog_size = options["replication-backlog"].as<std::size_t>();
+            }
+            storage = std::make_shared<Afina::Replication::Leader>(
+                storage, options["replication-port"].as<uint16_t>(), backlog_size, logService);
+        } else if (options.count("replicate-from") > 0) {
+            std::string leader = options["replicate-from"].as<std::string>();
+            std::size_t colon = leader.rfind(':');
+            if (colon == std::string::npos) {
+                throw std::runtime_error("Leader address must be host:port");
+            }
+            storage = std::make_shared<Afina::Replication::Follower>(storage, leader.substr(0, colon),
+                                                                     std::stoi(leader.substr(colon + 1)));
+        }
+
         // Step 2: Configure network
         std::string network_type = "st_block";
         if (options.count("network") > 0) {
@@ -75,6 +157,50 @@ public:
         } else {
             throw std::runtime_error("Unknown network type");
         }
+
+        Afina::Network::Config network_config;
+        if (options.count("backlog") > 0) {
+            network_config.listen_backlog = options["backlog"].as<int>();
+        }
+        if (options.count("max-connections") > 0) {
+            network_config.max_connections = options["max-connections"].as<uint32_t>();
+        }
+        if (options.count("output-watermark") > 0) {
+            // Connection with nothing allowed to queue would never be read again
+            network_config.output_watermark = options["output-watermark"].as<std::size_t>();
+            if (network_config.output_watermark == 0) {
+                throw std::runtime_error("Output watermark must be above 0");
+            }
+        }
+        if (options.count("max-value-size") > 0) {
+            network_config.max_value_size = options["max-value-size"].as<std::size_t>();
+            if (network_config.max_value_size == 0) {
+                throw std::runtime_error("Max value size must be above 0");
+            }
+        }
+        if (options.count("unix-socket") > 0) {
+            network_config.unix_socket = options["unix-socket"].as<std::string>();
+        }
+        server->Configure(network_config);
+
+        if (options.count("port") > 0) {
+            port = options["port"].as<uint16_t>();
+        }
+
+        // Step 3: Configure metrics endpoint and slow log
+        if (options.count("admin-port") > 0) {
+            exporter.reset(new Afina::Metrics::Exporter(storage, options["admin-port"].as<uint16_t>(), logService));
+        }
+        if (options.count("slow-log-us") > 0 || options.count("trace-sample") > 0) {
+            uint64_t threshold = options.count("slow-log-us") > 0 ? options["slow-log-us"].as<uint64_t>() : 0;
+            uint32_t sample = options.count("trace-sample") > 0 ? options["trace-sample"].as<uint32_t>() : 0;
+            Afina::Metrics::SlowRequests().Configure(threshold, sample);
+            slow_log_dumper.reset(new Afina::Metrics::SlowLogDumper(logService));
+        }
+        Afina::Metrics::SetLockProfiling(options.count("lock-profile") > 0);
+        if (options.count("hotkey-sample") > 0) {
+            Afina::Metrics::SetHotKeySampling(options["hotkey-sample"].as<uint32_t>());
+        }
     }
 
     // Start services in correct order
@@ -82,24 +208,66 @@ public:
         logService->Start();
         auto log = logService->select("root");
         log->warn("Start afina server {}", Afina::get_version());
+        if (slow_log_dumper) {
+            slow_log_dumper->Start();
+        }
 
         log->warn("Start storage");
         storage->Start();
 
-        // TODO: configure network service
-        const uint16_t port = 8080;
         log->warn("Start network on {}", port);
         server->Start(port, 2, 2);
+
+        if (exporter) {
+            exporter->Start();
+            log->warn("Start metrics on {}", exporter->Port());
+        }
+    }
+
+    // Replays key trace through configured storage offline, as a look-aside cache would see it:
+    // get, and set on miss. Trace has one key per line
+    void Simulate(const std::string &path, std::size_t value_size) {
+        std::ifstream trace(path);
+        if (!trace) {
+            throw std::runtime_error("Failed to open trace " + path);
+        }
+
+        storage->Start();
+        const std::string value(value_size, 'v');
+        std::size_t requests = 0, hits = 0;
+        std::string key, result;
+        while (std::getline(trace, key)) {
+            if (key.empty()) {
+                continue;
+            }
+
+            requests++;
+            if (storage->Get(key, result)) {
+                hits++;
+            } else {
+                storage->Put(key, value);
+            }
+        }
+        storage->Stop();
+
+        std::cout << "requests=" << requests << " hits=" << hits << " misses=" << requests - hits
+                  << " hit_ratio=" << (requests > 0 ? double(hits) / requests : 0.0) << std::endl;
     }
 
     // Stop services in correct order
     void Stop() {
         auto log = logService->select("root");
         log->warn("Stop application");
+        if (exporter) {
+            exporter->Stop();
+        }
         server->Stop();
         server->Join();
 
         storage->Stop();
+        if (slow_log_dumper) {
+            slow_log_dumper->Stop();
+        }
         logService->Stop();
     }
 
@@ -109,6 +277,15 @@ private:
 
     std::shared_ptr<Afina::Storage> storage;
     std::shared_ptr<Afina::Network::Server> server;
+
+    // Serves /metrics on the admin port, if asked to
+    std::unique_ptr<Afina::Metrics::Exporter> exporter;
+
+    // Writes slow log into the log, if it is enabled
+    std::unique_ptr<Afina::Metrics::SlowLogDumper> slow_log_dumper;
+
+    // Port to accept clients on
+    uint16_t port = 8080;
 };
 
 // Signal set that to notify application about time to stop
@@ -129,6 +306,47 @@ int main(int argc, char **argv) {
         // and simplify validation below
         options.add_options()("s,storage", "Type of storage service to use", cxxopts::value<std::string>());
         options.add_options()("n,network", "Type of network service to use", cxxopts::value<std::string>());
+        options.add_options()("p,port", "Port to accept clients on", cxxopts::value<uint16_t>());
+        options.add_options()("admin-port", "Port to serve Prometheus /metrics on", cxxopts::value<uint16_t>());
+        options.add_options()("slow-log-us", "Requests served longer than that many microseconds go to slow log",
+                              cxxopts::value<uint64_t>());
+        options.add_options()("trace-sample", "Put one of that many requests picked at random into slow log",
+                              cxxopts::value<uint32_t>());
+        options.add_options()("hot-replicas", "Keep per-core copies of that many hottest keys",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("hotkey-sample", "Count one of that many key accesses for `stats hotkeys`",
+                              cxxopts::value<uint32_t>());
+        options.add_options()("lock-profile", "Collect lock contention statistics from the start, see `stats locks`");
+        options.add_options()("backlog", "Number of connections kernel keeps waiting for accept",
+                              cxxopts::value<int>());
+        options.add_options()("max-connections", "Number of client connections served at the same time, 0 - unlimited",
+                              cxxopts::value<uint32_t>());
+        options.add_options()("output-watermark", "Bytes of queued responses after which connection is not read",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("max-value-size", "Largest value in bytes client could store, larger ones are rejected",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("unix-socket", "Path of unix socket to accept connections on, @name for abstract one",
+                              cxxopts::value<std::string>());
+        options.add_options()("memory", "Bytes of keys and values storage could hold", cxxopts::value<std::size_t>());
+        options.add_options()("huge-pages", "Back item memory with huge pages, st_slab only");
+        options.add_options()("prefault", "Touch all item memory at startup, st_slab only");
+        options.add_options()("persist", "File to keep items in between restarts, st_slab only",
+                              cxxopts::value<std::string>());
+        options.add_options()("oplog", "Directory to log changes to, storage is restored from it on start",
+                              cxxopts::value<std::string>());
+        options.add_options()("oplog-fsync-ms", "How often logged changes are synced to disk",
+                              cxxopts::value<uint32_t>());
+        options.add_options()("oplog-compact-size", "Log size in bytes that triggers its compaction into snapshot",
+                              cxxopts::value<uint64_t>());
+        options.add_options()("replication-port", "Port to stream changes to followers on, mt_lru only",
+                              cxxopts::value<uint16_t>());
+        options.add_options()("replication-backlog", "Bytes of recent changes kept for followers to catch up",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("replicate-from", "Leader host:port to follow as read-only replica, mt_lru only",
+                              cxxopts::value<std::string>());
+        options.add_options()("simulate", "Replay file of keys through storage and print hit ratio, no network",
+                              cxxopts::value<std::string>());
+        options.add_options()("value-size", "Size of values stored by --simulate", cxxopts::value<std::size_t>());
         options.add_options()("h,help", "Print usage info");
         options.parse(argc, argv);
 
@@ -145,6 +363,12 @@ int main(int argc, char **argv) {
     Application app;
     app.Configure(options);
 
+    if (options.count("simulate") > 0) {
+        std::size_t value_size = options.count("value-size") > 0 ? options["value-size"].as<std::size_t>() : 100;
+        app.Simulate(options["simulate"].as<std::string>(), value_size);
+        return 0;
+    }
+
     // POSIX specific staff
     {
         // Using semaphore for communication between main thread AND signal handler
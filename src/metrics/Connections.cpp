@@ -0,0 +1,45 @@
+#include <afina/metrics/Connections.h>
+#include <afina/metrics/Probes.h>
+
+#include <mutex>
+#include <set>
+
+namespace Afina {
+namespace Metrics {
+
+// Connections are registered on open and close only, requests never take the lock
+static std::mutex connections_mutex;
+static std::set<const Connection *> connections;
+static std::atomic<uint64_t> last_id(0);
+
+// Kept apart from the set, so that reading the number never takes the lock
+static std::atomic<std::size_t> open_connections(0);
+
+Connection::Connection() : _id(++last_id), _opened(std::time(nullptr)), _last_active(_opened) {
+    Local()[Stat::kTotalConnections].Add();
+    AFINA_PROBE1(conn_open, _id);
+    open_connections.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(connections_mutex);
+    connections.insert(this);
+}
+
+Connection::~Connection() {
+    AFINA_PROBE3(conn_close, _id, Requests(), std::time(nullptr) - _opened);
+    open_connections.fetch_sub(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(connections_mutex);
+    connections.erase(this);
+}
+
+// See Connections.h
+void ForEachConnection(const std::function<void(const Connection &)> &f) {
+    std::lock_guard<std::mutex> lock(connections_mutex);
+    for (const Connection *connection : connections) {
+        f(*connection);
+    }
+}
+
+// See Connections.h
+std::size_t OpenConnections() { return open_connections.load(std::memory_order_relaxed); }
+
+} // namespace Metrics
+} // namespace Afina
@@ -0,0 +1,52 @@
+#include <afina/metrics/Counters.h>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Metrics {
+
+// Must follow the order of Stat
+static const char *kNames[] = {
+    "cmd_get",
+    "get_hits",
+    "get_misses",
+    "cmd_set",
+    "cmd_delete",
+    "delete_hits",
+    "delete_misses",
+    "cmd_incr",
+    "incr_hits",
+    "incr_misses",
+    "cmd_decr",
+    "decr_hits",
+    "decr_misses",
+    "cmd_stats",
+    "bytes_read",
+    "bytes_written",
+    "total_connections",
+};
+static_assert(sizeof(kNames) / sizeof(kNames[0]) == static_cast<int>(Stat::kCount), "Name of each Stat is required");
+
+// Counters are never updated through a shared location, they are summed only once asked for
+static Concurrency::ThreadLocal<Counters> counters;
+
+// See Counters.h
+const char *Name(Stat stat) { return kNames[static_cast<int>(stat)]; }
+
+// See Counters.h
+Counters &Local() { return counters.Get(); }
+
+// See Counters.h
+void Collect(uint64_t *totals) {
+    for (int i = 0; i < static_cast<int>(Stat::kCount); i++) {
+        totals[i] = 0;
+    }
+    counters.ForEach([totals](const Counters &local) {
+        for (int i = 0; i < static_cast<int>(Stat::kCount); i++) {
+            totals[i] += local.values[i].Get();
+        }
+    });
+}
+
+} // namespace Metrics
+} // namespace Afina
@@ -0,0 +1,17 @@
+#include <afina/metrics/EventLoop.h>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Metrics {
+
+static Concurrency::ThreadLocal<EventLoop> loops;
+
+// See EventLoop.h
+EventLoop &LocalEventLoop() { return loops.Get(); }
+
+// See EventLoop.h
+void ForEachEventLoop(const std::function<void(const EventLoop &)> &f) { loops.ForEach(f); }
+
+} // namespace Metrics
+} // namespace Afina
@@ -0,0 +1,318 @@
+#include "Exporter.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Service.h>
+#include <afina/metrics/Connections.h>
+#include <afina/metrics/Counters.h>
+#include <afina/metrics/EventLoop.h>
+#include <afina/metrics/Latency.h>
+#include <afina/metrics/Locks.h>
+#include <afina/metrics/StorageGauges.h>
+
+namespace Afina {
+namespace Metrics {
+
+namespace {
+
+// Scraper sending nothing or reading nothing must not hold the exporter for long
+const struct timeval kSocketTimeout = {1, 0};
+
+// Largest request header accepted
+const std::size_t kMaxRequest = 8 << 10;
+
+// Pause after failed accept, so that running out of descriptors doesn't turn into a busy loop
+const std::chrono::milliseconds kAcceptBackoff(100);
+
+// Prometheus wants samples of a family to go together after its TYPE line, families are printed
+// in the order they first appear
+class Families {
+public:
+    void Add(const std::string &family, const char *type, const std::string &suffix, const std::string &labels,
+             const std::string &value) {
+        auto it = _index.find(family);
+        if (it == _index.end()) {
+            it = _index.emplace(family, _families.size()).first;
+            _families.push_back(Family{"# TYPE " + family + " " + type + "\n", std::string()});
+        }
+
+        std::string &samples = _families[it->second].samples;
+        samples.append(family).append(suffix);
+        if (!labels.empty()) {
+            samples.append("{").append(labels).append("}");
+        }
+        samples.append(" ").append(value).append("\n");
+    }
+
+    std::string Text() const {
+        std::string text;
+        for (const Family &family : _families) {
+            text.append(family.type).append(family.samples);
+        }
+        return text;
+    }
+
+private:
+    struct Family {
+        std::string type;
+        std::string samples;
+    };
+
+    std::vector<Family> _families;
+    std::map<std::string, std::size_t> _index;
+};
+
+std::string number(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    return buffer;
+}
+
+std::string seconds(uint64_t nanoseconds) { return number(nanoseconds / 1e9); }
+
+// Histogram of nanoseconds as a summary in seconds
+void summary(Families &out, const std::string &family, const std::string &labels, const Histogram &histogram) {
+    static const std::pair<double, const char *> kQuantiles[] = {{0.5, "0.5"}, {0.99, "0.99"}, {0.999, "0.999"}};
+
+    const std::string prefix = labels.empty() ? std::string() : labels + ",";
+    for (const auto &quantile : kQuantiles) {
+        out.Add(family, "summary", "", prefix + "quantile=\"" + quantile.second + "\"",
+                seconds(histogram.Quantile(quantile.first)));
+    }
+    out.Add(family, "summary", "_sum", labels, seconds(histogram.Sum()));
+    out.Add(family, "summary", "_count", labels, std::to_string(histogram.Count()));
+}
+
+bool send_all(int socket, const std::string &data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n == -1 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+} // namespace
+
+Exporter::Exporter(std::shared_ptr<Afina::Storage> storage, uint16_t port,
+                   std::shared_ptr<Afina::Logging::Service> logging)
+    : _storage(storage), _logging(logging), _port(port), _server_socket(-1), _running(false) {}
+
+Exporter::~Exporter() { Stop(); }
+
+// See Exporter.h
+void Exporter::Start() {
+    if (_logging) {
+        _logger = _logging->select("metrics");
+    }
+
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(_port);
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+
+    _server_socket = socket(PF_INET, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open metrics socket");
+    }
+
+    int opts = 1;
+    socklen_t addr_len = sizeof(server_addr);
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1 ||
+        bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1 ||
+        listen(_server_socket, 16) == -1 ||
+        getsockname(_server_socket, (struct sockaddr *)&server_addr, &addr_len) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Failed to listen for scrapes: " + std::string(std::strerror(errno)));
+    }
+    _port = ntohs(server_addr.sin_port);
+
+    _running.store(true);
+    _thread = std::thread(&Exporter::OnRun, this);
+}
+
+// See Exporter.h
+void Exporter::Stop() {
+    if (!_running.exchange(false)) {
+        return;
+    }
+
+    shutdown(_server_socket, SHUT_RDWR);
+    _thread.join();
+    close(_server_socket);
+}
+
+// See Exporter.h
+std::string Exporter::Render() {
+    Families out;
+
+    uint64_t totals[static_cast<int>(Stat::kCount)];
+    Collect(totals);
+    for (int i = 0; i < static_cast<int>(Stat::kCount); i++) {
+        // total_connections reads better as connections_total the way Prometheus names counters
+        std::string name = Name(static_cast<Stat>(i));
+        if (name.compare(0, 6, "total_") == 0) {
+            name = name.substr(6);
+        }
+        out.Add("afina_" + name + "_total", "counter", "", "", std::to_string(totals[i]));
+    }
+
+    const uint64_t gets = totals[static_cast<int>(Stat::kCmdGet)];
+    const uint64_t hits = totals[static_cast<int>(Stat::kGetHits)];
+    out.Add("afina_hit_ratio", "gauge", "", "", number(gets > 0 ? double(hits) / gets : 0.0));
+    out.Add("afina_curr_connections", "gauge", "", "", std::to_string(OpenConnections()));
+
+    // Storage figures come from its gauges, scrape never takes storage locks
+    const StorageGauges *gauges = _storage->Gauges();
+    if (gauges != nullptr) {
+        out.Add("afina_curr_items", "gauge", "", "", std::to_string(gauges->curr_items.Get()));
+        out.Add("afina_bytes", "gauge", "", "", std::to_string(gauges->bytes.Get()));
+        out.Add("afina_limit_maxbytes", "gauge", "", "", std::to_string(gauges->limit_maxbytes.Get()));
+        out.Add("afina_evictions_total", "counter", "", "", std::to_string(gauges->evictions.Get()));
+    }
+
+    // Classes are numbered from 1, as `stats slabs` does. Gauges are read one by one, so used chunks
+    // could be a bit ahead of the total ones
+    if (gauges != nullptr && gauges->classes > 0) {
+        out.Add("afina_slabs_moved_total", "counter", "", "", std::to_string(gauges->slabs_moved.Get()));
+        out.Add("afina_total_malloced", "gauge", "", "", std::to_string(gauges->total_malloced.Get()));
+
+        uint64_t active = 0;
+        for (int cls = 0; cls < gauges->classes; cls++) {
+            const StorageGauges::SizeClass &size_class = gauges->size_classes[cls];
+            const uint64_t pages = size_class.total_pages.Get();
+            if (pages == 0) {
+                continue;
+            }
+
+            const std::string labels = "class=\"" + std::to_string(cls + 1) + "\"";
+            const uint64_t chunk_size = size_class.chunk_size.Get();
+            const uint64_t total = size_class.total_chunks.Get();
+            const uint64_t used = size_class.used_chunks.Get();
+            out.Add("afina_slab_chunk_size", "gauge", "", labels, std::to_string(chunk_size));
+            out.Add("afina_slab_total_pages", "gauge", "", labels, std::to_string(pages));
+            out.Add("afina_slab_total_chunks", "gauge", "", labels, std::to_string(total));
+            out.Add("afina_slab_used_chunks", "gauge", "", labels, std::to_string(used));
+            out.Add("afina_slab_free_chunks", "gauge", "", labels, std::to_string(total > used ? total - used : 0));
+            out.Add("afina_slab_items", "gauge", "", labels, std::to_string(size_class.items.Get()));
+            out.Add("afina_slab_evictions_total", "counter", "", labels,
+                    std::to_string(size_class.evictions.Get()));
+            out.Add("afina_slab_allocated_bytes", "gauge", "", labels, std::to_string(chunk_size * total));
+            out.Add("afina_slab_used_bytes", "gauge", "", labels, std::to_string(chunk_size * used));
+            active++;
+        }
+        out.Add("afina_active_slabs", "gauge", "", "", std::to_string(active));
+    }
+
+    std::unique_ptr<Latencies> latencies(new Latencies());
+    Collect(*latencies);
+    for (int type = 0; type < static_cast<int>(CommandType::kCount); type++) {
+        for (int phase = 0; phase < static_cast<int>(Phase::kCount); phase++) {
+            const Histogram &histogram = latencies->values[type][phase];
+            if (histogram.Count() > 0) {
+                summary(out, "afina_command_duration_seconds",
+                        std::string("command=\"") + Name(static_cast<CommandType>(type)) + "\",phase=\"" +
+                            Name(static_cast<Phase>(phase)) + "\"",
+                        histogram);
+            }
+        }
+    }
+
+    ForEachLock([&out](const std::string &name, const LockProfile &profile) {
+        const std::string labels = "lock=\"" + name + "\"";
+        out.Add("afina_lock_acquisitions_total", "counter", "", labels, std::to_string(profile.acquisitions.Get()));
+        out.Add("afina_lock_contended_total", "counter", "", labels, std::to_string(profile.contended.Get()));
+        summary(out, "afina_lock_wait_seconds", labels, profile.wait);
+        summary(out, "afina_lock_hold_seconds", labels, profile.hold);
+    });
+
+    int worker = 0;
+    ForEachEventLoop([&out, &worker](const EventLoop &loop) {
+        const std::string labels = "worker=\"" + std::to_string(worker++) + "\"";
+        summary(out, "afina_event_loop_duration_seconds", labels, loop.busy);
+        out.Add("afina_event_loop_ready_events", "gauge", "", labels,
+                std::to_string(loop.ready.load(std::memory_order_relaxed)));
+    });
+
+    return out.Text();
+}
+
+// See Exporter.h
+void Exporter::OnRun() {
+    while (_running.load()) {
+        int socket = accept4(_server_socket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (socket == -1) {
+            const int error = errno;
+            if (error != EINTR && error != ECONNABORTED && _running.load()) {
+                if (_logger) {
+                    AFINA_LOG_LIMITED(_logger, err, "Failed to accept scrape: {}", std::strerror(error));
+                }
+                std::this_thread::sleep_for(kAcceptBackoff);
+            }
+            continue;
+        }
+
+        setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &kSocketTimeout, sizeof(kSocketTimeout));
+        setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &kSocketTimeout, sizeof(kSocketTimeout));
+        Serve(socket);
+        close(socket);
+    }
+}
+
+// See Exporter.h
+void Exporter::Serve(int socket) {
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos) {
+        ssize_t n = recv(socket, buffer, sizeof(buffer), 0);
+        if (n == -1 && errno == EINTR) {
+            continue;
+        } else if (n <= 0 || request.size() + n > kMaxRequest) {
+            return;
+        }
+        request.append(buffer, n);
+    }
+
+    // Only the request line matters, query string is ignored
+    const std::string line = request.substr(0, request.find("\r\n"));
+    std::string status = "200 OK";
+    std::string body;
+    if (line.compare(0, 4, "GET ") != 0) {
+        status = "405 Method Not Allowed";
+        body = "Only GET is supported\n";
+    } else if (line.compare(4, 9, "/metrics ") != 0 && line.compare(4, 9, "/metrics?") != 0) {
+        status = "404 Not Found";
+        body = "Metrics are at /metrics\n";
+    } else {
+        body = Render();
+    }
+
+    std::string response = "HTTP/1.1 " + status + "\r\n" +
+                           "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n" +
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n" +
+                           "Connection: close\r\n\r\n";
+    response.append(body);
+    send_all(socket, response);
+}
+
+} // namespace Metrics
+} // namespace Afina
@@ -0,0 +1,73 @@
+#ifndef AFINA_METRICS_EXPORTER_H
+#define AFINA_METRICS_EXPORTER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace Afina {
+class Storage;
+namespace Logging {
+class AsyncLogger;
+class Service;
+} // namespace Logging
+namespace Metrics {
+
+/**
+ * # Prometheus endpoint
+ * Minimal HTTP server that answers `GET /metrics` with server metrics in Prometheus text format:
+ * request counters and hit ratio, storage occupancy and evictions, memory of each slab class,
+ * latency summaries of commands, per worker epoll loop time and ready events, connections, contention
+ * of profiled locks.
+ *
+ * Runs in its own thread and serves one scrape at a time. Request counters, histograms and loop
+ * state are read right out of the per-thread instances their owners write, nothing on the request
+ * path waits for the scrape. Storage figures come from the gauges storage keeps as it changes, see
+ * Storage::Gauges, so scrape takes no storage locks either
+ */
+class Exporter {
+public:
+    /**
+     * @param storage to report occupancy of
+     * @param port to listen on, 0 to pick any free one
+     * @param logging service to report failures to, may be null
+     */
+    Exporter(std::shared_ptr<Afina::Storage> storage, uint16_t port,
+             std::shared_ptr<Afina::Logging::Service> logging = nullptr);
+    ~Exporter();
+
+    // Begins to accept scrapes
+    void Start();
+
+    // Stops accepting scrapes, waits for the current one
+    void Stop();
+
+    // Port scrapes are accepted on, known once exporter is started
+    uint16_t Port() const { return _port; }
+
+    // Current metrics in Prometheus text format
+    std::string Render();
+
+private:
+    // Accepts and serves scrapes, runs in its own thread
+    void OnRun();
+
+    // Answers single HTTP request
+    void Serve(int socket);
+
+    std::shared_ptr<Afina::Storage> _storage;
+    std::shared_ptr<Afina::Logging::Service> _logging;
+    std::shared_ptr<Afina::Logging::AsyncLogger> _logger;
+
+    uint16_t _port;
+    int _server_socket;
+    std::atomic<bool> _running;
+    std::thread _thread;
+};
+
+} // namespace Metrics
+} // namespace Afina
+
+#endif // AFINA_METRICS_EXPORTER_H
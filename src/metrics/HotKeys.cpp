@@ -0,0 +1,230 @@
+#include <afina/metrics/HotKeys.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Metrics {
+
+namespace {
+
+// Counters of a single worker, keys that take a noticeable share of traffic stand out well below that
+const std::size_t kWorkerCapacity = 128;
+
+// Summary of a single thread. Owner takes the lock only for sampled accesses, so it is contended
+// only while stats are collected
+struct Sampled {
+    Sampled() : sketch(kWorkerCapacity), generation(0), decays(0) {}
+
+    mutable std::mutex mutex;
+    SpaceSaving sketch;
+
+    // Summary is dropped once sampling changes
+    uint64_t generation;
+
+    // Decays applied to the summary. Collector can't change summaries, so owner catches up on
+    // the next sample and collector decays a copy meanwhile
+    uint64_t decays;
+};
+
+Concurrency::ThreadLocal<Sampled> summaries;
+std::atomic<uint32_t> sample_every(0);
+std::atomic<uint64_t> generation(0);
+std::atomic<uint64_t> decays(0);
+
+// Count of any key is gone after that many decays
+const uint64_t kMaxDecays = 64;
+
+void decay(SpaceSaving &sketch, uint64_t times) {
+    if (times >= kMaxDecays) {
+        sketch.Clear();
+        return;
+    }
+    for (uint64_t i = 0; i < times; i++) {
+        sketch.Decay();
+    }
+}
+
+// Accesses the calling thread skips before the next sample
+thread_local uint32_t skip = 0;
+
+bool more_frequent(const HotKey &a, const HotKey &b) { return a.count > b.count; }
+
+} // namespace
+
+SpaceSaving::SpaceSaving(std::size_t capacity) : _capacity(capacity), _total(0) {}
+
+// See HotKeys.h
+void SpaceSaving::Add(const std::string &key, uint64_t count) {
+    _total += count;
+    auto it = _index.find(key);
+    if (it != _index.end()) {
+        _counters[it->second].count += count;
+        return;
+    }
+
+    if (_counters.size() < _capacity) {
+        _index.emplace(key, _counters.size());
+        _counters.push_back(HotKey{key, count, 0});
+        return;
+    }
+
+    // Capacity is small and only sampled keys get here, so the scan is cheaper than keeping
+    // counters ordered on every hit
+    std::size_t min = std::min_element(_counters.begin(), _counters.end(), [](const HotKey &a, const HotKey &b) {
+                          return a.count < b.count;
+                      }) - _counters.begin();
+    HotKey &victim = _counters[min];
+    _index.erase(victim.key);
+    victim.key = key;
+    victim.error = victim.count;
+    victim.count += count;
+    _index.emplace(key, min);
+}
+
+// See HotKeys.h
+void SpaceSaving::Merge(const SpaceSaving &other) {
+    const uint64_t floor = Floor();
+    const uint64_t other_floor = other.Floor();
+
+    std::vector<HotKey> merged;
+    for (const HotKey &counter : _counters) {
+        auto it = other._index.find(counter.key);
+        if (it != other._index.end()) {
+            const HotKey &match = other._counters[it->second];
+            merged.push_back(HotKey{counter.key, counter.count + match.count, counter.error + match.error});
+        } else {
+            merged.push_back(HotKey{counter.key, counter.count + other_floor, counter.error + other_floor});
+        }
+    }
+    for (const HotKey &counter : other._counters) {
+        if (_index.find(counter.key) == _index.end()) {
+            merged.push_back(HotKey{counter.key, counter.count + floor, counter.error + floor});
+        }
+    }
+
+    // Keys beyond capacity are the least frequent ones
+    std::sort(merged.begin(), merged.end(), more_frequent);
+    if (merged.size() > _capacity) {
+        merged.resize(_capacity);
+    }
+
+    _total += other._total;
+    _counters.swap(merged);
+    _index.clear();
+    for (std::size_t i = 0; i < _counters.size(); i++) {
+        _index.emplace(_counters[i].key, i);
+    }
+}
+
+// See HotKeys.h
+std::vector<HotKey> SpaceSaving::Top(std::size_t n) const {
+    std::vector<HotKey> top(_counters);
+    std::sort(top.begin(), top.end(), more_frequent);
+    if (top.size() > n) {
+        top.resize(n);
+    }
+    return top;
+}
+
+// See HotKeys.h
+void SpaceSaving::Decay() {
+    _total /= 2;
+    std::vector<HotKey> decayed;
+    for (const HotKey &counter : _counters) {
+        if (counter.count / 2 > 0) {
+            decayed.push_back(HotKey{counter.key, counter.count / 2, counter.error / 2});
+        }
+    }
+
+    _counters.swap(decayed);
+    _index.clear();
+    for (std::size_t i = 0; i < _counters.size(); i++) {
+        _index.emplace(_counters[i].key, i);
+    }
+}
+
+// See HotKeys.h
+void SpaceSaving::Clear() {
+    _total = 0;
+    _counters.clear();
+    _index.clear();
+}
+
+// See HotKeys.h
+uint64_t SpaceSaving::Floor() const {
+    if (_counters.size() < _capacity) {
+        return 0;
+    }
+    return std::min_element(_counters.begin(), _counters.end(), [](const HotKey &a, const HotKey &b) {
+               return a.count < b.count;
+           })->count;
+}
+
+// See HotKeys.h
+void SetHotKeySampling(uint32_t every) {
+    generation.fetch_add(1, std::memory_order_relaxed);
+    sample_every.store(every, std::memory_order_relaxed);
+}
+
+// See HotKeys.h
+uint32_t HotKeySampling() { return sample_every.load(std::memory_order_relaxed); }
+
+// See HotKeys.h
+void SampleKey(const char *key, std::size_t size) {
+    const uint32_t every = sample_every.load(std::memory_order_relaxed);
+    if (every == 0 || (skip > 0 && --skip > 0)) {
+        return;
+    }
+
+    // Gap to the next sample is random with mean of every, so that periodic access patterns
+    // don't get in step with sampling
+    static thread_local std::minstd_rand random(std::random_device{}());
+    skip = 1 + random() % (2 * uint64_t(every) - 1);
+
+    Sampled &local = summaries.Get();
+    std::lock_guard<std::mutex> lock(local.mutex);
+    const uint64_t current = generation.load(std::memory_order_relaxed);
+    const uint64_t decayed = decays.load(std::memory_order_relaxed);
+    if (local.generation != current) {
+        local.sketch.Clear();
+        local.generation = current;
+    } else {
+        decay(local.sketch, decayed - local.decays);
+    }
+    local.decays = decayed;
+    local.sketch.Add(std::string(key, size));
+}
+
+// See HotKeys.h
+std::vector<HotKey> HotKeys(std::size_t n, uint64_t &sampled) {
+    const uint64_t current = generation.load(std::memory_order_relaxed);
+    const uint64_t decayed = decays.load(std::memory_order_relaxed);
+    SpaceSaving merged(kWorkerCapacity);
+    summaries.ForEach([&merged, current, decayed](const Sampled &local) {
+        std::lock_guard<std::mutex> lock(local.mutex);
+        if (local.generation != current) {
+            return;
+        }
+        if (local.decays == decayed) {
+            merged.Merge(local.sketch);
+        } else {
+            SpaceSaving sketch(local.sketch);
+            decay(sketch, decayed - local.decays);
+            merged.Merge(sketch);
+        }
+    });
+
+    sampled = merged.Total();
+    return merged.Top(n);
+}
+
+// See HotKeys.h
+void DecayHotKeys() { decays.fetch_add(1, std::memory_order_relaxed); }
+
+} // namespace Metrics
+} // namespace Afina
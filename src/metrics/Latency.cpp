@@ -0,0 +1,46 @@
+#include <afina/metrics/Latency.h>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Metrics {
+
+// Must follow the order of CommandType
+static const char *kTypeNames[] = {
+    "get", "set", "delete", "arithmetic", "stats", "other",
+};
+static_assert(sizeof(kTypeNames) / sizeof(kTypeNames[0]) == static_cast<int>(CommandType::kCount),
+              "Name of each CommandType is required");
+
+// Must follow the order of Phase
+static const char *kPhaseNames[] = {
+    "parse", "execute", "write",
+};
+static_assert(sizeof(kPhaseNames) / sizeof(kPhaseNames[0]) == static_cast<int>(Phase::kCount),
+              "Name of each Phase is required");
+
+// Each worker records into its own histograms, they are merged only once asked for
+static Concurrency::ThreadLocal<Latencies> latencies;
+
+// See Latency.h
+const char *Name(CommandType type) { return kTypeNames[static_cast<int>(type)]; }
+
+// See Latency.h
+const char *Name(Phase phase) { return kPhaseNames[static_cast<int>(phase)]; }
+
+// See Latency.h
+Latencies &LocalLatencies() { return latencies.Get(); }
+
+// See Latency.h
+void Collect(Latencies &totals) {
+    latencies.ForEach([&totals](const Latencies &local) {
+        for (int type = 0; type < static_cast<int>(CommandType::kCount); type++) {
+            for (int phase = 0; phase < static_cast<int>(Phase::kCount); phase++) {
+                totals.values[type][phase].Merge(local.values[type][phase]);
+            }
+        }
+    });
+}
+
+} // namespace Metrics
+} // namespace Afina
@@ -0,0 +1,187 @@
+#include <afina/metrics/Locks.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+
+#include <afina/metrics/SlowLog.h>
+
+namespace Afina {
+namespace Metrics {
+
+namespace {
+
+std::atomic<bool> profiling(false);
+
+uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Locks could be created during static initialization, so the registry is created on first use
+std::mutex &registry_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::set<const ProfiledLock *> &registry() {
+    static std::set<const ProfiledLock *> locks;
+    return locks;
+}
+
+} // namespace
+
+// See Locks.h
+void ProfiledLock::Register() {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    registry().insert(this);
+}
+
+// See Locks.h
+void ProfiledLock::Unregister() {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    registry().erase(this);
+}
+
+// See Locks.h
+uint64_t ProfiledLock::Wait(const std::function<void()> &lock) {
+    const uint64_t wait_start = now();
+    lock();
+    const uint64_t wait = now() - wait_start;
+    AddLockWait(wait);
+    return wait;
+}
+
+// See Locks.h
+uint64_t ProfiledLock::Acquired(LockProfile &profile, uint64_t wait, bool contended) {
+    if (!profiling.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+
+    profile.acquisitions.Add();
+    if (contended) {
+        profile.contended.Add();
+    }
+    profile.wait.Record(wait);
+    return now();
+}
+
+// See Locks.h
+void ProfiledLock::Released(LockProfile &profile, uint64_t locked_at) {
+    if (locked_at != 0) {
+        profile.hold.Record(now() - locked_at);
+    }
+}
+
+// See Locks.h
+void ProfiledMutex::lock() {
+    if (_mutex.try_lock()) {
+        _locked_at = Acquired(_profile, 0, false);
+        return;
+    }
+    const uint64_t wait = Wait([this]() { _mutex.lock(); });
+    _locked_at = Acquired(_profile, wait, true);
+}
+
+// See Locks.h
+bool ProfiledMutex::try_lock() {
+    if (!_mutex.try_lock()) {
+        return false;
+    }
+    _locked_at = Acquired(_profile, 0, false);
+    return true;
+}
+
+// See Locks.h
+void ProfiledMutex::unlock() {
+    Released(_profile, _locked_at);
+    _locked_at = 0;
+    _mutex.unlock();
+}
+
+ProfiledRWLock::ProfiledRWLock(const std::string &name) : ProfiledLock(name), _locked_at(0) {
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    int err = pthread_rwlock_init(&_lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+    if (err != 0) {
+        throw std::runtime_error("Failed to init rwlock");
+    }
+    Register();
+}
+
+ProfiledRWLock::~ProfiledRWLock() {
+    Unregister();
+    pthread_rwlock_destroy(&_lock);
+}
+
+// See Locks.h
+void ProfiledRWLock::lock() {
+    if (pthread_rwlock_trywrlock(&_lock) == 0) {
+        _locked_at = Acquired(_profile, 0, false);
+        return;
+    }
+    const uint64_t wait = Wait([this]() { pthread_rwlock_wrlock(&_lock); });
+    _locked_at = Acquired(_profile, wait, true);
+}
+
+// See Locks.h
+void ProfiledRWLock::unlock() {
+    Released(_profile, _locked_at);
+    _locked_at = 0;
+    pthread_rwlock_unlock(&_lock);
+}
+
+// See Locks.h
+uint64_t ProfiledRWLock::lock_shared() {
+    if (pthread_rwlock_tryrdlock(&_lock) == 0) {
+        return Acquired(_shared.Get(), 0, false);
+    }
+    const uint64_t wait = Wait([this]() { pthread_rwlock_rdlock(&_lock); });
+    return Acquired(_shared.Get(), wait, true);
+}
+
+// See Locks.h
+void ProfiledRWLock::unlock_shared(uint64_t locked_at) {
+    Released(_shared.Get(), locked_at);
+    pthread_rwlock_unlock(&_lock);
+}
+
+// See Locks.h
+void ProfiledRWLock::Collect(LockProfile &profile) const {
+    profile.Merge(_profile);
+    _shared.ForEach([&profile](const LockProfile &shared) { profile.Merge(shared); });
+}
+
+// See Locks.h
+void SetLockProfiling(bool enabled) { profiling.store(enabled, std::memory_order_relaxed); }
+
+// See Locks.h
+bool LockProfiling() { return profiling.load(std::memory_order_relaxed); }
+
+// See Locks.h
+void ForEachLock(const std::function<void(const std::string &, const LockProfile &)> &f) {
+    // Profiles are large, so they are merged on the heap
+    std::map<std::string, std::unique_ptr<LockProfile>> merged;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        for (const ProfiledLock *lock : registry()) {
+            std::unique_ptr<LockProfile> &profile = merged[lock->Name()];
+            if (!profile) {
+                profile.reset(new LockProfile());
+            }
+            lock->Collect(*profile);
+        }
+    }
+
+    for (const auto &profile : merged) {
+        f(profile.first, *profile.second);
+    }
+}
+
+} // namespace Metrics
+} // namespace Afina
@@ -0,0 +1,138 @@
+#include <afina/metrics/SlowLog.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <type_traits>
+
+namespace Afina {
+namespace Metrics {
+
+static_assert(std::is_trivially_copyable<SlowRequest>::value, "SlowRequest is copied word by word");
+
+const std::size_t SlowRequest::kMaxKey;
+const std::size_t SlowLog::kCapacity;
+
+static SlowLog slow_requests;
+
+// Lock wait of the request thread serves
+static thread_local uint64_t lock_wait = 0;
+
+SlowLog::SlowLog() : _threshold_ns(0), _sample_every(0), _head(0) {
+    for (Slot &slot : _slots) {
+        slot.sequence.store(0);
+    }
+}
+
+// See SlowLog.h
+void SlowLog::Configure(uint64_t threshold_us, uint32_t sample_every) {
+    _threshold_ns.store(threshold_us * 1000, std::memory_order_relaxed);
+    _sample_every.store(sample_every, std::memory_order_relaxed);
+}
+
+// See SlowLog.h
+bool SlowLog::Wants(uint64_t nanoseconds, bool &sampled) const {
+    const uint64_t threshold = _threshold_ns.load(std::memory_order_relaxed);
+    const uint32_t sample_every = _sample_every.load(std::memory_order_relaxed);
+    sampled = false;
+    if (threshold != 0 && nanoseconds >= threshold) {
+        return true;
+    } else if (sample_every == 0) {
+        return false;
+    }
+
+    static thread_local std::minstd_rand random(std::random_device{}());
+    sampled = (random() % sample_every == 0);
+    return sampled;
+}
+
+// See SlowLog.h
+void SlowLog::Push(SlowRequest &request) {
+    const uint64_t id = _head.fetch_add(1, std::memory_order_relaxed);
+    request.id = id;
+
+    uint64_t words[kWords] = {0};
+    std::memcpy(words, &request, sizeof(request));
+
+    // Writer lapped by the others while it was slow to start gives the slot up to the newer record,
+    // sequence of a slot never goes back
+    Slot &slot = _slots[id % kCapacity];
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    do {
+        if (sequence > 2 * id) {
+            return;
+        }
+    } while (!slot.sequence.compare_exchange_weak(sequence, 2 * id + 1, std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < kWords; i++) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    sequence = 2 * id + 1;
+    slot.sequence.compare_exchange_strong(sequence, 2 * id + 2, std::memory_order_release, std::memory_order_relaxed);
+}
+
+// See SlowLog.h
+uint64_t SlowLog::Read(uint64_t from, std::vector<SlowRequest> &out) const {
+    const uint64_t head = _head.load(std::memory_order_acquire);
+    if (head > from + kCapacity) {
+        from = head - kCapacity;
+    }
+
+    uint64_t id = from;
+    for (; id < head; id++) {
+        const Slot &slot = _slots[id % kCapacity];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence < 2 * id + 2) {
+            // Still being written, the next read starts from it
+            break;
+        } else if (sequence != 2 * id + 2) {
+            continue;
+        }
+
+        uint64_t words[kWords];
+        for (std::size_t i = 0; i < kWords; i++) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+
+        out.emplace_back();
+        std::memcpy(&out.back(), words, sizeof(SlowRequest));
+    }
+    return id;
+}
+
+// See SlowLog.h
+std::string SlowLog::Format(const SlowRequest &request) {
+    const std::size_t key_size = request.key_size < SlowRequest::kMaxKey ? request.key_size : SlowRequest::kMaxKey;
+    char buffer[512];
+    std::snprintf(buffer, sizeof(buffer),
+                  "time=%" PRIu64 ".%06" PRIu64 " command=%.*s key=%.*s key_size=%" PRIu32 " request_size=%" PRIu64
+                  " response_size=%" PRIu64 " parse_us=%.3f execute_us=%.3f lock_wait_us=%.3f write_us=%.3f"
+                  " worker=%" PRIu64 " sampled=%d",
+                  request.time / 1000000, request.time % 1000000, int(sizeof(request.command)), request.command,
+                  int(key_size), request.key, request.key_size, request.request_size, request.response_size,
+                  request.parse / 1e3, request.execute / 1e3, request.lock_wait / 1e3, request.write / 1e3,
+                  request.worker, int(request.sampled));
+    return buffer;
+}
+
+// See SlowLog.h
+SlowLog &SlowRequests() { return slow_requests; }
+
+// See SlowLog.h
+void AddLockWait(uint64_t nanoseconds) { lock_wait += nanoseconds; }
+
+// See SlowLog.h
+uint64_t TakeLockWait() {
+    const uint64_t result = lock_wait;
+    lock_wait = 0;
+    return result;
+}
+
+} // namespace Metrics
+} // namespace Afina
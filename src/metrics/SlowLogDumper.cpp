@@ -0,0 +1,68 @@
+#include "SlowLogDumper.h"
+
+#include <chrono>
+#include <vector>
+
+#include <spdlog/logger.h>
+
+#include <afina/logging/Service.h>
+#include <afina/metrics/SlowLog.h>
+
+namespace Afina {
+namespace Metrics {
+
+// How often the ring is polled, it keeps SlowLog::kCapacity records meanwhile
+static const std::chrono::milliseconds kPollInterval(200);
+
+SlowLogDumper::SlowLogDumper(std::shared_ptr<Afina::Logging::Service> logging)
+    : _logging(logging), _next(0), _running(false) {}
+
+SlowLogDumper::~SlowLogDumper() { Stop(); }
+
+// See SlowLogDumper.h
+void SlowLogDumper::Start() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_running) {
+        return;
+    }
+
+    _logger = _logging->select("slowlog");
+    _running = true;
+    _thread = std::thread(&SlowLogDumper::OnRun, this);
+}
+
+// See SlowLogDumper.h
+void SlowLogDumper::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running) {
+            return;
+        }
+        _running = false;
+    }
+    _stopped.notify_all();
+    _thread.join();
+}
+
+// See SlowLogDumper.h
+void SlowLogDumper::OnRun() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_running) {
+        _stopped.wait_for(lock, kPollInterval, [this]() { return !_running; });
+        lock.unlock();
+        Dump();
+        lock.lock();
+    }
+}
+
+// See SlowLogDumper.h
+void SlowLogDumper::Dump() {
+    std::vector<SlowRequest> requests;
+    _next = SlowRequests().Read(_next, requests);
+    for (const SlowRequest &request : requests) {
+        _logger->warn("{}", SlowLog::Format(request));
+    }
+}
+
+} // namespace Metrics
+} // namespace Afina
@@ -0,0 +1,59 @@
+#ifndef AFINA_METRICS_SLOW_LOG_DUMPER_H
+#define AFINA_METRICS_SLOW_LOG_DUMPER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Logging {
+class Service;
+} // namespace Logging
+namespace Metrics {
+
+/**
+ * # Writes slow log into the "slowlog" logger
+ * Polls the ring once in a while from its own thread, so that request processing never waits for
+ * logging. Records overwritten before they were polled are lost, `stats slowlog` still shows the
+ * latest ones
+ */
+class SlowLogDumper {
+public:
+    SlowLogDumper(std::shared_ptr<Afina::Logging::Service> logging);
+    ~SlowLogDumper();
+
+    // Starts thread that polls the log
+    void Start();
+
+    // Writes what is left and stops the thread
+    void Stop();
+
+private:
+    // Polls the log, runs in its own thread
+    void OnRun();
+
+    // Writes records appeared since the last call
+    void Dump();
+
+    std::shared_ptr<Afina::Logging::Service> _logging;
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Id of the next record to write
+    uint64_t _next;
+
+    std::mutex _mutex;
+    std::condition_variable _stopped;
+    bool _running;
+    std::thread _thread;
+};
+
+} // namespace Metrics
+} // namespace Afina
+
+#endif // AFINA_METRICS_SLOW_LOG_DUMPER_H
@@ -0,0 +1,72 @@
+#include "UnixSocket.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+
+// See UnixSocket.h
+int open_unix_socket(const std::string &path, int backlog) {
+    // For unix sockets we use struct sockaddr_un:
+    // struct sockaddr_un {
+    //     sa_family_t sun_family;    // Address family, AF_UNIX
+    //     char        sun_path[108]; // Pathname, abstract one starts with zero byte
+    // };
+    struct sockaddr_un server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(server_addr.sun_path)) {
+        throw std::runtime_error("Invalid unix socket path: " + path);
+    }
+    std::memcpy(server_addr.sun_path, path.data(), path.size());
+
+    // Abstract socket address length counts only bytes of the name, no trailing zero
+    socklen_t addr_len = offsetof(struct sockaddr_un, sun_path) + path.size();
+    if (path[0] == '@') {
+        server_addr.sun_path[0] = '\0';
+    } else {
+        addr_len += 1;
+
+        // Remove socket left by previous run, but never touch anything else
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+            unlink(path.c_str());
+        }
+    }
+
+    int sfd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sfd == -1) {
+        throw std::runtime_error("Failed to open unix socket: " + std::string(strerror(errno)));
+    }
+
+    if (bind(sfd, (struct sockaddr *)&server_addr, addr_len) == -1) {
+        close(sfd);
+        throw std::runtime_error("Unix socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(sfd, backlog) == -1) {
+        close(sfd);
+        throw std::runtime_error("Unix socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    return sfd;
+}
+
+// See UnixSocket.h
+void close_unix_socket(int sfd, const std::string &path) {
+    close(sfd);
+    if (!path.empty() && path[0] != '@') {
+        unlink(path.c_str());
+    }
+}
+
+} // namespace Network
+} // namespace Afina
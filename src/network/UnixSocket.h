@@ -0,0 +1,30 @@
+#ifndef AFINA_NETWORK_UNIX_SOCKET_H
+#define AFINA_NETWORK_UNIX_SOCKET_H
+
+#include <string>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * Creates AF_UNIX stream socket listening on the given path. Path started with '@' denotes
+ * socket in the linux abstract namespace, that has no file in the filesystem. Stale socket
+ * file left by previous server run gets replaced.
+ *
+ * Method throws std::runtime_error in case of failure
+ *
+ * @param path filesystem path or @name to bind socket to
+ * @param backlog number of connections kernel keeps waiting for accept
+ * @return listening socket descriptor
+ */
+int open_unix_socket(const std::string &path, int backlog);
+
+/**
+ * Closes socket created by open_unix_socket and removes its file from the filesystem
+ */
+void close_unix_socket(int sfd, const std::string &path);
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_UNIX_SOCKET_H
@@ -5,23 +5,26 @@
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <system_error>
 
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <pthread.h>
 #include <signal.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
 
-#include <spdlog/logger.h>
+#include <afina/logging/AsyncLogger.h>
 
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
 
-#include "protocol/Parser.h"
+#include "network/UnixSocket.h"
+#include "protocol/Session.h"
 
 namespace Afina {
 namespace Network {
@@ -67,11 +70,22 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
         throw std::runtime_error("Socket bind() failed");
     }
 
-    if (listen(_server_socket, 5) == -1) {
+    if (listen(_server_socket, config.listen_backlog) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket listen() failed");
     }
 
+    // Co-located clients could connect through unix socket avoiding TCP stack overhead
+    _unix_socket = -1;
+    if (!config.unix_socket.empty()) {
+        try {
+            _unix_socket = open_unix_socket(config.unix_socket, config.listen_backlog);
+        } catch (std::runtime_error &ex) {
+            close(_server_socket);
+            throw;
+        }
+    }
+
     running.store(true);
     _thread = std::thread(&ServerImpl::OnRun, this);
 }
@@ -80,6 +94,16 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
 void ServerImpl::Stop() {
     running.store(false);
     shutdown(_server_socket, SHUT_RDWR);
+    if (_unix_socket != -1) {
+        shutdown(_unix_socket, SHUT_RDWR);
+    }
+
+    // Stop reading new commands from clients, connection threads exit once current
+    // command response is sent
+    std::unique_lock<std::mutex> lock(_connections_mutex);
+    for (int client_socket : _client_sockets) {
+        shutdown(client_socket, SHUT_RD);
+    }
 }
 
 // See Server.h
@@ -87,27 +111,43 @@ void ServerImpl::Join() {
     assert(_thread.joinable());
     _thread.join();
     close(_server_socket);
+    if (_unix_socket != -1) {
+        close_unix_socket(_unix_socket, config.unix_socket);
+    }
+
+    std::unique_lock<std::mutex> lock(_connections_mutex);
+    while (!_client_sockets.empty()) {
+        _connections_closed.wait(lock);
+    }
 }
 
 // See Server.h
 void ServerImpl::OnRun() {
-    // Here is connection state
-    // - parser: parse state of the stream
-    // - command_to_execute: last command parsed out of stream
-    // - arg_remains: how many bytes to read from stream to get command argument
-    // - argument_for_command: buffer stores argument
-    std::size_t arg_remains;
-    Protocol::Parser parser;
-    std::string argument_for_command;
-    std::unique_ptr<Execute::Command> command_to_execute;
     while (running.load()) {
         _logger->debug("waiting for connection...");
 
+        // Wait for incoming connection on any of listening sockets
+        int listen_socket = _server_socket;
+        if (_unix_socket != -1) {
+            struct pollfd fds[2];
+            fds[0].fd = _server_socket;
+            fds[0].events = POLLIN;
+            fds[1].fd = _unix_socket;
+            fds[1].events = POLLIN;
+            if (poll(fds, 2, -1) == -1) {
+                continue;
+            }
+
+            if (fds[0].revents == 0 && fds[1].revents != 0) {
+                listen_socket = _unix_socket;
+            }
+        }
+
         // The call to accept() blocks until the incoming connection arrives
         int client_socket;
         struct sockaddr client_addr;
         socklen_t client_addr_len = sizeof(client_addr);
-        if ((client_socket = accept(_server_socket, (struct sockaddr *)&client_addr, &client_addr_len)) == -1) {
+        if ((client_socket = accept(listen_socket, (struct sockaddr *)&client_addr, &client_addr_len)) == -1) {
             continue;
         }
 
@@ -132,12 +172,29 @@ void ServerImpl::OnRun() {
             setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof tv);
         }
 
-        // TODO: Start new thread and process data from/to connection
+        // Each connection costs a thread, so do not let clients to exhaust them
         {
-            static const std::string msg = "TODO: start new thread and process memcached protocol instead";
-            if (send(client_socket, msg.data(), msg.size(), 0) <= 0) {
-                _logger->error("Failed to write response to client: {}", strerror(errno));
+            std::unique_lock<std::mutex> lock(_connections_mutex);
+            if (config.max_connections > 0 && _client_sockets.size() >= config.max_connections) {
+                lock.unlock();
+                AFINA_LOG_LIMITED(_logger, warn, "Reject connection on descriptor {}: too many open connections",
+                                  client_socket);
+
+                static const std::string msg = "SERVER_ERROR too many open connections\r\n";
+                send(client_socket, msg.data(), msg.size(), MSG_DONTWAIT);
+                close(client_socket);
+                continue;
             }
+            _client_sockets.insert(client_socket);
+        }
+
+        try {
+            std::thread(&ServerImpl::OnConnection, this, client_socket).detach();
+        } catch (std::system_error &ex) {
+            AFINA_LOG_LIMITED(_logger, err, "Failed to start connection thread: {}", ex.what());
+
+            std::unique_lock<std::mutex> lock(_connections_mutex);
+            _client_sockets.erase(client_socket);
             close(client_socket);
         }
     }
@@ -146,6 +203,59 @@ void ServerImpl::OnRun() {
     _logger->warn("Network stopped");
 }
 
+// See ServerImpl.h
+void ServerImpl::OnConnection(int client_socket) {
+    // Process connection:
+    // - read commands until socket alive
+    // - execute each command
+    // - send response
+    //
+    // Here is connection state, see Session.h for details
+    Protocol::Session session(pStorage, config.max_value_size);
+    try {
+        int readed_bytes = -1;
+        char client_buffer[4096];
+        while ((readed_bytes = read(client_socket, client_buffer, sizeof(client_buffer))) > 0) {
+            _logger->debug("Got {} bytes from socket", readed_bytes);
+
+            std::string result;
+            bool keep_alive = session.Process(client_buffer, readed_bytes, result);
+
+            // Send responses, blocking send holds reading of next commands until client
+            // fetch responses for already executed
+            if (!result.empty()) {
+                if (send(client_socket, result.data(), result.size(), 0) <= 0) {
+                    throw std::runtime_error("Failed to send response");
+                }
+                session.Sent();
+            }
+
+            // Malformed input or client asks to quit
+            if (!keep_alive) {
+                _logger->debug("Stop reading commands on descriptor {}", client_socket);
+                readed_bytes = 0;
+                break;
+            }
+        }
+
+        if (readed_bytes == 0) {
+            _logger->debug("Connection closed");
+        } else {
+            throw std::runtime_error(std::string(strerror(errno)));
+        }
+    } catch (std::runtime_error &ex) {
+        AFINA_LOG_LIMITED(_logger, err, "Failed to process connection on descriptor {}: {}", client_socket, ex.what());
+    }
+
+    // We are done with this connection
+    std::unique_lock<std::mutex> lock(_connections_mutex);
+    _client_sockets.erase(client_socket);
+    close(client_socket);
+    if (_client_sockets.empty()) {
+        _connections_closed.notify_all();
+    }
+}
+
 } // namespace MTblocking
 } // namespace Network
 } // namespace Afina
@@ -2,15 +2,17 @@
 #define AFINA_NETWORK_MT_BLOCKING_SERVER_H
 
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
 #include <thread>
 
 #include <afina/network/Server.h>
 
-namespace spdlog {
-class logger;
-}
-
 namespace Afina {
+namespace Logging {
+class AsyncLogger;
+} // namespace Logging
 namespace Network {
 namespace MTblocking {
 
@@ -38,9 +40,14 @@ protected:
      */
     void OnRun();
 
+    /**
+     * Method is running in the thread spawned for the connection
+     */
+    void OnConnection(int client_socket);
+
 private:
     // Logger instance
-    std::shared_ptr<spdlog::logger> _logger;
+    std::shared_ptr<Logging::AsyncLogger> _logger;
 
     // Atomic flag to notify threads when it is time to stop. Note that
     // flag must be atomic in order to safely publisj changes cross thread
@@ -50,8 +57,20 @@ private:
     // Server socket to accept connections on
     int _server_socket;
 
+    // Unix socket to accept connections on, -1 if not configured
+    int _unix_socket;
+
     // Thread to run network on
     std::thread _thread;
+
+    // Protects set of the client connections below
+    std::mutex _connections_mutex;
+
+    // Sockets of connections that are currently served, each by its own thread
+    std::set<int> _client_sockets;
+
+    // Signals once last connection thread finished
+    std::condition_variable _connections_closed;
 };
 
 } // namespace MTblocking
@@ -1,25 +1,132 @@
 #include "Connection.h"
 
-#include <iostream>
+#include <algorithm>
+#include <cerrno>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <afina/logging/AsyncLogger.h>
 
 namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
 // See Connection.h
-void Connection::Start() { std::cout << "Start" << std::endl; }
+void Connection::Start() {
+    _logger->debug("Start connection on descriptor {}", _socket);
+    _is_alive = true;
+    _input_closed = false;
+    UpdateEvents();
+}
 
 // See Connection.h
-void Connection::OnError() { std::cout << "OnError" << std::endl; }
+void Connection::OnError() {
+    _logger->debug("Error on descriptor {}", _socket);
+    _is_alive = false;
+}
 
 // See Connection.h
-void Connection::OnClose() { std::cout << "OnClose" << std::endl; }
+void Connection::OnClose() {
+    _logger->debug("Close connection on descriptor {}", _socket);
+    _is_alive = false;
+    _output.clear();
+    _output_size = 0;
+}
 
 // See Connection.h
-void Connection::DoRead() { std::cout << "DoRead" << std::endl; }
+void Connection::DoRead() {
+    char client_buffer[4096];
+
+    // Do not read more commands than client is able to fetch responses for
+    while (!_input_closed && _output_size < _output_watermark) {
+        int readed_bytes = read(_socket, client_buffer, sizeof(client_buffer));
+        if (readed_bytes > 0) {
+            _logger->debug("Got {} bytes from socket", readed_bytes);
+
+            std::string result;
+            if (!_session.Process(client_buffer, readed_bytes, result)) {
+                // Close connection once response with the reason is delivered
+                _logger->debug("Stop reading commands on descriptor {}", _socket);
+                _input_closed = true;
+            }
+
+            if (!result.empty()) {
+                _output_size += result.size();
+                _output.push_back(std::move(result));
+            }
+        } else if (readed_bytes == 0) {
+            _logger->debug("Connection closed by client");
+            _input_closed = true;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if (errno != EINTR) {
+            AFINA_LOG_LIMITED(_logger, err, "Failed to read connection on descriptor {}: {}", _socket, strerror(errno));
+            _input_closed = true;
+        }
+    }
+
+    UpdateEvents();
+}
 
 // See Connection.h
-void Connection::DoWrite() { std::cout << "DoWrite" << std::endl; }
+void Connection::DoWrite() {
+    while (!_output.empty()) {
+        struct iovec iov[64];
+        std::size_t iov_count = 0;
+        for (auto it = _output.begin(); it != _output.end() && iov_count < 64; it++, iov_count++) {
+            iov[iov_count].iov_base = &(*it)[0];
+            iov[iov_count].iov_len = it->size();
+        }
+        iov[0].iov_base = static_cast<char *>(iov[0].iov_base) + _output_offset;
+        iov[0].iov_len -= _output_offset;
+
+        ssize_t written = writev(_socket, iov, iov_count);
+        if (written == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            } else if (errno != EINTR) {
+                AFINA_LOG_LIMITED(_logger, err, "Failed to write response on descriptor {}: {}", _socket,
+                                  strerror(errno));
+                OnError();
+                return;
+            }
+            continue;
+        }
+
+        // Drop responses those are completely sent
+        _output_size -= written;
+        written += _output_offset;
+        while (!_output.empty() && std::size_t(written) >= _output.front().size()) {
+            written -= _output.front().size();
+            _output.pop_front();
+            _session.Sent();
+        }
+        _output_offset = written;
+    }
+
+    UpdateEvents();
+}
+
+// See Connection.h
+void Connection::UpdateEvents() {
+    if (!_is_alive) {
+        return;
+    }
+
+    if (_input_closed && _output.empty()) {
+        _is_alive = false;
+        return;
+    }
+
+    _event.events = 0;
+    if (!_input_closed && _output_size < _output_watermark) {
+        _event.events |= EPOLLIN | EPOLLRDHUP;
+    }
+    if (!_output.empty()) {
+        _event.events |= EPOLLOUT;
+    }
+}
 
 } // namespace MTnonblock
 } // namespace Network
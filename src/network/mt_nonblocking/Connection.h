@@ -2,21 +2,32 @@
 #define AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 
 #include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
 
 #include <sys/epoll.h>
 
+#include "protocol/Session.h"
+
 namespace Afina {
+namespace Logging {
+class AsyncLogger;
+} // namespace Logging
 namespace Network {
 namespace MTnonblock {
 
 class Connection {
 public:
-    Connection(int s) : _socket(s) {
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::AsyncLogger> pl,
+               std::size_t output_watermark, std::size_t max_value_size)
+        : _socket(s), _logger(pl), _is_alive(false), _input_closed(false), _session(ps, max_value_size),
+          _output_offset(0), _output_size(0), _output_watermark(output_watermark) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _event.data.ptr = this;
     }
 
-    inline bool isAlive() const { return true; }
+    inline bool isAlive() const { return _is_alive; }
 
     void Start();
 
@@ -30,8 +41,38 @@ private:
     friend class Worker;
     friend class ServerImpl;
 
+    /**
+     * Recalculates events connection waits for based on its state. Once client closed input
+     * and all responses are sent connection is dead
+     */
+    void UpdateEvents();
+
     int _socket;
     struct epoll_event _event;
+
+    // Logger to be used
+    std::shared_ptr<Logging::AsyncLogger> _logger;
+
+    // Connection is alive until client gone or all responses sent after client stop sending commands
+    bool _is_alive;
+
+    // No more commands will be read from the connection
+    bool _input_closed;
+
+    // Parse and execute state of the connection
+    Protocol::Session _session;
+
+    // Responses waiting to be written into the socket
+    std::deque<std::string> _output;
+
+    // Number of bytes of the first response in the queue that are already written
+    std::size_t _output_offset;
+
+    // Total number of bytes queued in responses
+    std::size_t _output_size;
+
+    // Once queued responses exceed that number of bytes connection stops reading commands
+    std::size_t _output_watermark;
 };
 
 } // namespace MTnonblock
@@ -16,7 +16,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
-#include <spdlog/logger.h>
+#include <afina/logging/AsyncLogger.h>
 
 #include <afina/Storage.h>
 #include <afina/logging/Service.h>
@@ -24,6 +24,7 @@
 #include "Connection.h"
 #include "Utils.h"
 #include "Worker.h"
+#include "network/UnixSocket.h"
 
 namespace Afina {
 namespace Network {
@@ -65,17 +66,35 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
     }
 
+    // Let restarted server to bind while connections of the previous one are in TIME_WAIT
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
     if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
     }
 
     make_socket_non_blocking(_server_socket);
-    if (listen(_server_socket, 5) == -1) {
+    if (listen(_server_socket, config.listen_backlog) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
     }
 
+    // Co-located clients could connect through unix socket avoiding TCP stack overhead
+    _unix_socket = -1;
+    if (!config.unix_socket.empty()) {
+        try {
+            _unix_socket = open_unix_socket(config.unix_socket, config.listen_backlog);
+            make_socket_non_blocking(_unix_socket);
+        } catch (std::runtime_error &ex) {
+            close(_server_socket);
+            throw;
+        }
+    }
+
     // Start IO workers
     _data_epoll_fd = epoll_create1(0);
     if (_data_epoll_fd == -1) {
@@ -96,7 +115,7 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
 
     _workers.reserve(n_workers);
     for (int i = 0; i < n_workers; i++) {
-        _workers.emplace_back(pStorage, pLogging);
+        _workers.emplace_back(pStorage, pLogging, this);
         _workers.back().Start(_data_epoll_fd);
     }
 
@@ -130,6 +149,36 @@ void ServerImpl::Join() {
     for (auto &w : _workers) {
         w.Join();
     }
+
+    // Workers are stopped, drop connections those are still alive
+    std::unique_lock<std::mutex> lock(_connections_mutex);
+    for (Connection *pc : _connections) {
+        close(pc->_socket);
+        pc->OnClose();
+        delete pc;
+    }
+    _connections.clear();
+
+    close(_server_socket);
+    if (_unix_socket != -1) {
+        close_unix_socket(_unix_socket, config.unix_socket);
+    }
+    close(_data_epoll_fd);
+    close(_event_fd);
+}
+
+// See ServerImpl.h
+void ServerImpl::CloseConnection(Connection *pc) {
+    if (epoll_ctl(_data_epoll_fd, EPOLL_CTL_DEL, pc->_socket, &pc->_event)) {
+        AFINA_LOG_LIMITED(_logger, err, "Failed to delete connection from epoll");
+    }
+
+    close(pc->_socket);
+    pc->OnClose();
+
+    std::unique_lock<std::mutex> lock(_connections_mutex);
+    _connections.erase(pc);
+    delete pc;
 }
 
 // See ServerImpl.h
@@ -147,6 +196,15 @@ void ServerImpl::OnRun() {
         throw std::runtime_error("Failed to add file descriptor to epoll");
     }
 
+    if (_unix_socket != -1) {
+        struct epoll_event unix_event;
+        unix_event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        unix_event.data.fd = _unix_socket;
+        if (epoll_ctl(acceptor_epoll, EPOLL_CTL_ADD, _unix_socket, &unix_event)) {
+            throw std::runtime_error("Failed to add file descriptor to epoll");
+        }
+    }
+
     struct epoll_event event2;
     event2.events = EPOLLIN;
     event2.data.fd = _event_fd;
@@ -174,12 +232,12 @@ void ServerImpl::OnRun() {
 
                 // No need to make these sockets non blocking since accept4() takes care of it.
                 in_len = sizeof in_addr;
-                int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                int infd = accept4(current_event.data.fd, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
                 if (infd == -1) {
                     if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
                         break; // We have processed all incoming connections.
                     } else {
-                        _logger->error("Failed to accept socket");
+                        AFINA_LOG_LIMITED(_logger, err, "Failed to accept socket");
                         break;
                     }
                 }
@@ -192,11 +250,26 @@ void ServerImpl::OnRun() {
                     _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
                 }
 
-                // Register the new FD to be monitored by epoll.
-                Connection *pc = new Connection(infd);
+                // Register the new FD to be monitored by epoll, unless clients are about to exhaust
+                // memory and descriptors
+                std::unique_lock<std::mutex> lock(_connections_mutex);
+                if (config.max_connections > 0 && _connections.size() >= config.max_connections) {
+                    lock.unlock();
+                    AFINA_LOG_LIMITED(_logger, warn, "Reject connection on descriptor {}: too many open connections",
+                                      infd);
+
+                    static const std::string msg = "SERVER_ERROR too many open connections\r\n";
+                    send(infd, msg.data(), msg.size(), 0);
+                    close(infd);
+                    continue;
+                }
+
+                Connection *pc = new (std::nothrow)
+                    Connection(infd, pStorage, _logger, config.output_watermark, config.max_value_size);
                 if (pc == nullptr) {
                     throw std::runtime_error("Failed to allocate connection");
                 }
+                _connections.insert(pc);
 
                 // Register connection in worker's epoll
                 pc->Start();
@@ -204,14 +277,19 @@ void ServerImpl::OnRun() {
                     pc->_event.events |= EPOLLONESHOT;
                     int epoll_ctl_retval;
                     if ((epoll_ctl_retval = epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event))) {
-                        _logger->debug("epoll_ctl failed during connection register in workers'epoll: error {}", epoll_ctl_retval);
+                        AFINA_LOG_LIMITED(_logger, debug,
+                                          "epoll_ctl failed during connection register in workers'epoll: error {}",
+                                          epoll_ctl_retval);
                         pc->OnError();
+                        _connections.erase(pc);
+                        close(pc->_socket);
                         delete pc;
                     }
                 }
             }
         }
     }
+    close(acceptor_epoll);
     _logger->warn("Acceptor stopped");
 }
 
@@ -1,22 +1,26 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 #define AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 
+#include <mutex>
+#include <set>
 #include <thread>
 #include <vector>
 
 #include <afina/network/Server.h>
 
-namespace spdlog {
-class logger;
-}
-
 namespace Afina {
+namespace Logging {
+class AsyncLogger;
+} // namespace Logging
 namespace Network {
 namespace MTnonblock {
 
 // Forward declaration, see Worker.h
 class Worker;
 
+// Forward declaration, see Connection.h
+class Connection;
+
 /**
  * # Network resource manager implementation
  * Epoll based server
@@ -40,8 +44,14 @@ protected:
     void OnNewConnection();
 
 private:
+    friend class Worker;
+
+    // Removes connection from workers' epoll, closes its socket and release all resources
+    // allocated for it
+    void CloseConnection(Connection *);
+
     // logger to use
-    std::shared_ptr<spdlog::logger> _logger;
+    std::shared_ptr<Logging::AsyncLogger> _logger;
 
     // Port to listen for new connections, permits access only from
     // inside of accept_thread
@@ -51,6 +61,9 @@ private:
     // Socket to accept new connection on, shared between acceptors
     int _server_socket;
 
+    // Unix socket to accept new connection on, shared between acceptors, -1 if not configured
+    int _unix_socket;
+
     // Threads that accepts new connections, each has private epoll instance
     // but share global server socket
     std::vector<std::thread> _acceptors;
@@ -63,6 +76,12 @@ private:
 
     // threads serving read/write requests
     std::vector<Worker> _workers;
+
+    // Protects set of connections below
+    std::mutex _connections_mutex;
+
+    // Connections those are currently served by workers
+    std::set<Connection *> _connections;
 };
 
 } // namespace MTnonblock
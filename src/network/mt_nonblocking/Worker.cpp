@@ -1,6 +1,7 @@
 #include "Worker.h"
 
 #include <cassert>
+#include <chrono>
 #include <functional>
 #include <iostream>
 
@@ -9,11 +10,13 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 
-#include <spdlog/logger.h>
+#include <afina/logging/AsyncLogger.h>
 
 #include <afina/logging/Service.h>
+#include <afina/metrics/EventLoop.h>
 
 #include "Connection.h"
+#include "ServerImpl.h"
 #include "Utils.h"
 
 namespace Afina {
@@ -21,8 +24,8 @@ namespace Network {
 namespace MTnonblock {
 
 // See Worker.h
-Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
-    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1) {
+Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl, ServerImpl *server)
+    : _pStorage(ps), _pLogging(pl), _server(server), isRunning(false), _epoll_fd(-1) {
     // TODO: implementation here
 }
 
@@ -40,6 +43,7 @@ Worker &Worker::operator=(Worker &&other) {
     _pLogging = std::move(other._pLogging);
     _logger = std::move(other._logger);
     _thread = std::move(other._thread);
+    _server = other._server;
     _epoll_fd = other._epoll_fd;
 
     other._epoll_fd = -1;
@@ -76,9 +80,12 @@ void Worker::OnRun() {
     // for events to avoid thundering herd type behavior.
     int timeout = -1;
     std::array<struct epoll_event, 64> mod_list;
+    Metrics::EventLoop &loop = Metrics::LocalEventLoop();
     while (isRunning) {
         int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), timeout);
         _logger->debug("Worker wokeup: {} events", nmod);
+        const auto loop_start = std::chrono::steady_clock::now();
+        loop.Begin(nmod > 0 ? nmod : 0);
 
         for (int i = 0; i < nmod; i++) {
             struct epoll_event &current_event = mod_list[i];
@@ -95,12 +102,10 @@ void Worker::OnRun() {
             if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
                 _logger->debug("Got EPOLLERR or EPOLLHUP, value of returned events: {}", current_event.events);
                 pconn->OnError();
-            } else if (current_event.events & EPOLLRDHUP) {
-                _logger->debug("Got EPOLLRDHUP, value of returned events: {}", current_event.events);
-                pconn->OnClose();
             } else {
-                // Depends on what connection wants...
-                if (current_event.events & EPOLLIN) {
+                // Depends on what connection wants... Note that client closing its side
+                // of connection could still have commands to be read before EOF
+                if (current_event.events & (EPOLLIN | EPOLLRDHUP)) {
                     _logger->trace("Got EPOLLIN");
                     pconn->DoRead();
                 }
@@ -115,19 +120,19 @@ void Worker::OnRun() {
                 pconn->_event.events |= EPOLLONESHOT;
                 int epoll_ctl_retval;
                 if ((epoll_ctl_retval = epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event))) {
-                    _logger->debug("epoll_ctl failed during connection rearm: error {}", epoll_ctl_retval);
+                    AFINA_LOG_LIMITED(_logger, debug, "epoll_ctl failed during connection rearm: error {}",
+                                      epoll_ctl_retval);
                     pconn->OnError();
-                    delete pconn;
+                    _server->CloseConnection(pconn);
                 }
             }
             // Or delete closed one
             else {
-                if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event)) {
-                    std::cerr << "Failed to delete connection!" << std::endl;
-                }
-                delete pconn;
+                _server->CloseConnection(pconn);
             }
         }
+        const auto loop_time = std::chrono::steady_clock::now() - loop_start;
+        loop.End(std::chrono::duration_cast<std::chrono::nanoseconds>(loop_time).count());
         // TODO: Select timeout...
     }
     _logger->warn("Worker stopped");
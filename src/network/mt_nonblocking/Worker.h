@@ -5,21 +5,21 @@
 #include <memory>
 #include <thread>
 
-namespace spdlog {
-class logger;
-}
-
 namespace Afina {
 
 // Forward declaration, see afina/Storage.h
 class Storage;
 namespace Logging {
+class AsyncLogger;
 class Service;
-}
+} // namespace Logging
 
 namespace Network {
 namespace MTnonblock {
 
+// Forward declaration, see ServerImpl.h
+class ServerImpl;
+
 /**
  * # Thread running epoll
  * On Start spaws background thread that is doing epoll on the given server
@@ -27,7 +27,7 @@ namespace MTnonblock {
  */
 class Worker {
 public:
-    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl);
+    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl, ServerImpl *server);
     ~Worker();
 
     Worker(Worker &&);
@@ -71,7 +71,10 @@ private:
     std::shared_ptr<Afina::Logging::Service> _pLogging;
 
     // Logger to be used
-    std::shared_ptr<spdlog::logger> _logger;
+    std::shared_ptr<Afina::Logging::AsyncLogger> _logger;
+
+    // Server owning connections worker serves
+    ServerImpl *_server;
 
     // Flag signals that thread should continue to operate
     std::atomic<bool> isRunning;
@@ -9,19 +9,21 @@
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <pthread.h>
 #include <signal.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
 
-#include <spdlog/logger.h>
+#include <afina/logging/AsyncLogger.h>
 
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
 
-#include "protocol/Parser.h"
+#include "network/UnixSocket.h"
+#include "protocol/Session.h"
 
 namespace Afina {
 namespace Network {
@@ -96,11 +98,22 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
     // connections that we'll allow to queue up. Note that listen() doesn't block until
     // incoming connections arrive. It just makesthe OS aware that this process is willing
     // to accept connections on this socket (which is bound to a specific IP and port)
-    if (listen(_server_socket, 5) == -1) {
+    if (listen(_server_socket, config.listen_backlog) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket listen() failed");
     }
 
+    // Co-located clients could connect through unix socket avoiding TCP stack overhead
+    _unix_socket = -1;
+    if (!config.unix_socket.empty()) {
+        try {
+            _unix_socket = open_unix_socket(config.unix_socket, config.listen_backlog);
+        } catch (std::runtime_error &ex) {
+            close(_server_socket);
+            throw;
+        }
+    }
+
     running.store(true);
     _thread = std::thread(&ServerImpl::OnRun, this);
 }
@@ -109,6 +122,9 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
 void ServerImpl::Stop() {
     running.store(false);
     shutdown(_server_socket, SHUT_RDWR);
+    if (_unix_socket != -1) {
+        shutdown(_unix_socket, SHUT_RDWR);
+    }
 }
 
 // See Server.h
@@ -116,27 +132,38 @@ void ServerImpl::Join() {
     assert(_thread.joinable());
     _thread.join();
     close(_server_socket);
+    if (_unix_socket != -1) {
+        close_unix_socket(_unix_socket, config.unix_socket);
+    }
 }
 
 // See Server.h
 void ServerImpl::OnRun() {
-    // Here is connection state
-    // - parser: parse state of the stream
-    // - command_to_execute: last command parsed out of stream
-    // - arg_remains: how many bytes to read from stream to get command argument
-    // - argument_for_command: buffer stores argument
-    std::size_t arg_remains;
-    Protocol::Parser parser;
-    std::string argument_for_command;
-    std::unique_ptr<Execute::Command> command_to_execute;
     while (running.load()) {
         _logger->debug("waiting for connection...");
 
+        // Wait for incoming connection on any of listening sockets
+        int listen_socket = _server_socket;
+        if (_unix_socket != -1) {
+            struct pollfd fds[2];
+            fds[0].fd = _server_socket;
+            fds[0].events = POLLIN;
+            fds[1].fd = _unix_socket;
+            fds[1].events = POLLIN;
+            if (poll(fds, 2, -1) == -1) {
+                continue;
+            }
+
+            if (fds[0].revents == 0 && fds[1].revents != 0) {
+                listen_socket = _unix_socket;
+            }
+        }
+
         // The call to accept() blocks until the incoming connection arrives
         int client_socket;
         struct sockaddr client_addr;
         socklen_t client_addr_len = sizeof(client_addr);
-        if ((client_socket = accept(_server_socket, (struct sockaddr *)&client_addr, &client_addr_len)) == -1) {
+        if ((client_socket = accept(listen_socket, (struct sockaddr *)&client_addr, &client_addr_len)) == -1) {
             continue;
         }
 
@@ -165,72 +192,33 @@ void ServerImpl::OnRun() {
         // - read commands until socket alive
         // - execute each command
         // - send response
+        //
+        // Here is connection state, see Session.h for details
+        Protocol::Session session(pStorage, config.max_value_size);
         try {
             int readed_bytes = -1;
             char client_buffer[4096];
             while ((readed_bytes = read(client_socket, client_buffer, sizeof(client_buffer))) > 0) {
                 _logger->debug("Got {} bytes from socket", readed_bytes);
 
-                // Single block of data readed from the socket could trigger inside actions a multiple times,
-                // for example:
-                // - read#0: [<command1 start>]
-                // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
-                while (readed_bytes > 0) {
-                    _logger->debug("Process {} bytes", readed_bytes);
-                    // There is no command yet
-                    if (!command_to_execute) {
-                        std::size_t parsed = 0;
-                        if (parser.Parse(client_buffer, readed_bytes, parsed)) {
-                            // There is no command to be launched, continue to parse input stream
-                            // Here we are, current chunk finished some command, process it
-                            _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
-                            command_to_execute = parser.Build(arg_remains);
-                            if (arg_remains > 0) {
-                                arg_remains += 2;
-                            }
-                        }
-
-                        // Parsed might fails to consume any bytes from input stream. In real life that could happens,
-                        // for example, because we are working with UTF-16 chars and only 1 byte left in stream
-                        if (parsed == 0) {
-                            break;
-                        } else {
-                            std::memmove(client_buffer, client_buffer + parsed, readed_bytes - parsed);
-                            readed_bytes -= parsed;
-                        }
-                    }
-
-                    // There is command, but we still wait for argument to arrive...
-                    if (command_to_execute && arg_remains > 0) {
-                        _logger->debug("Fill argument: {} bytes of {}", readed_bytes, arg_remains);
-                        // There is some parsed command, and now we are reading argument
-                        std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
-                        argument_for_command.append(client_buffer, to_read);
-
-                        std::memmove(client_buffer, client_buffer + to_read, readed_bytes - to_read);
-                        arg_remains -= to_read;
-                        readed_bytes -= to_read;
-                    }
-
-                    // Thre is command & argument - RUN!
-                    if (command_to_execute && arg_remains == 0) {
-                        _logger->debug("Start command execution");
-
-                        std::string result;
-                        command_to_execute->Execute(*pStorage, argument_for_command, result);
+                std::string result;
+                bool keep_alive = session.Process(client_buffer, readed_bytes, result);
 
-                        // Send response
-                        result += "\r\n";
-                        if (send(client_socket, result.data(), result.size(), 0) <= 0) {
-                            throw std::runtime_error("Failed to send response");
-                        }
-
-                        // Prepare for the next command
-                        command_to_execute.reset();
-                        argument_for_command.resize(0);
-                        parser.Reset();
+                // Send responses, blocking send holds reading of next commands until client
+                // fetch responses for already executed
+                if (!result.empty()) {
+                    if (send(client_socket, result.data(), result.size(), 0) <= 0) {
+                        throw std::runtime_error("Failed to send response");
                     }
-                } // while (readed_bytes)
+                    session.Sent();
+                }
+
+                // Malformed input or client asks to quit
+                if (!keep_alive) {
+                    _logger->debug("Stop reading commands on descriptor {}", client_socket);
+                    readed_bytes = 0;
+                    break;
+                }
             }
 
             if (readed_bytes == 0) {
@@ -239,16 +227,12 @@ void ServerImpl::OnRun() {
                 throw std::runtime_error(std::string(strerror(errno)));
             }
         } catch (std::runtime_error &ex) {
-            _logger->error("Failed to process connection on descriptor {}: {}", client_socket, ex.what());
+            AFINA_LOG_LIMITED(_logger, err, "Failed to process connection on descriptor {}: {}", client_socket,
+                              ex.what());
         }
 
         // We are done with this connection
         close(client_socket);
-
-        // Prepare for the next command: just in case if connection was closed in the middle of executing something
-        command_to_execute.reset();
-        argument_for_command.resize(0);
-        parser.Reset();
     }
 
     // Cleanup on exit...
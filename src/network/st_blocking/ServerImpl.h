@@ -6,11 +6,10 @@
 
 #include <afina/network/Server.h>
 
-namespace spdlog {
-class logger;
-}
-
 namespace Afina {
+namespace Logging {
+class AsyncLogger;
+} // namespace Logging
 namespace Network {
 namespace STblocking {
 
@@ -40,7 +39,7 @@ protected:
 
 private:
     // Logger instance
-    std::shared_ptr<spdlog::logger> _logger;
+    std::shared_ptr<Logging::AsyncLogger> _logger;
 
     // Atomic flag to notify threads when it is time to stop. Note that
     // flag must be atomic in order to safely publisj changes cross thread
@@ -50,6 +49,9 @@ private:
     // Server socket to accept connections on
     int _server_socket;
 
+    // Unix socket to accept connections on, -1 if not configured
+    int _unix_socket;
+
     // Thread to run network on
     std::thread _thread;
 };
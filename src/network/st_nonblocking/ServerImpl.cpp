@@ -1,6 +1,7 @@
 #include "ServerImpl.h"
 
 #include <cassert>
+#include <chrono>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -16,13 +17,15 @@
 #include <sys/types.h>
 #include <unistd.h>
 
-#include <spdlog/logger.h>
+#include <afina/logging/AsyncLogger.h>
 
 #include <afina/Storage.h>
 #include <afina/logging/Service.h>
+#include <afina/metrics/EventLoop.h>
 
 #include "Connection.h"
 #include "Utils.h"
+#include "network/UnixSocket.h"
 
 namespace Afina {
 namespace Network {
@@ -64,17 +67,35 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
     }
 
+    // Let restarted server to bind while connections of the previous one are in TIME_WAIT
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
     if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
     }
 
     make_socket_non_blocking(_server_socket);
-    if (listen(_server_socket, 5) == -1) {
+    if (listen(_server_socket, config.listen_backlog) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
     }
 
+    // Co-located clients could connect through unix socket avoiding TCP stack overhead
+    _unix_socket = -1;
+    if (!config.unix_socket.empty()) {
+        try {
+            _unix_socket = open_unix_socket(config.unix_socket, config.listen_backlog);
+            make_socket_non_blocking(_unix_socket);
+        } catch (std::runtime_error &ex) {
+            close(_server_socket);
+            throw;
+        }
+    }
+
     _event_fd = eventfd(0, EFD_NONBLOCK);
     if (_event_fd == -1) {
         throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
@@ -97,6 +118,11 @@ void ServerImpl::Stop() {
 void ServerImpl::Join() {
     // Wait for work to be complete
     _work_thread.join();
+    close(_server_socket);
+    if (_unix_socket != -1) {
+        close_unix_socket(_unix_socket, config.unix_socket);
+    }
+    close(_event_fd);
 }
 
 // See ServerImpl.h
@@ -114,6 +140,15 @@ void ServerImpl::OnRun() {
         throw std::runtime_error("Failed to add file descriptor to epoll");
     }
 
+    if (_unix_socket != -1) {
+        struct epoll_event unix_event;
+        unix_event.events = EPOLLIN;
+        unix_event.data.fd = _unix_socket;
+        if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, _unix_socket, &unix_event)) {
+            throw std::runtime_error("Failed to add file descriptor to epoll");
+        }
+    }
+
     struct epoll_event event2;
     event2.events = EPOLLIN;
     event2.data.fd = _event_fd;
@@ -123,9 +158,12 @@ void ServerImpl::OnRun() {
 
     bool run = true;
     std::array<struct epoll_event, 64> mod_list;
+    Metrics::EventLoop &loop = Metrics::LocalEventLoop();
     while (run) {
         int nmod = epoll_wait(epoll_descr, &mod_list[0], mod_list.size(), -1);
         _logger->debug("Acceptor wokeup: {} events", nmod);
+        const auto loop_start = std::chrono::steady_clock::now();
+        loop.Begin(nmod > 0 ? nmod : 0);
 
         for (int i = 0; i < nmod; i++) {
             struct epoll_event &current_event = mod_list[i];
@@ -133,8 +171,8 @@ void ServerImpl::OnRun() {
                 _logger->debug("Break acceptor due to stop signal");
                 run = false;
                 continue;
-            } else if (current_event.data.fd == _server_socket) {
-                OnNewConnection(epoll_descr);
+            } else if (current_event.data.fd == _server_socket || current_event.data.fd == _unix_socket) {
+                OnNewConnection(epoll_descr, current_event.data.fd);
                 continue;
             }
 
@@ -144,11 +182,10 @@ void ServerImpl::OnRun() {
             auto old_mask = pc->_event.events;
             if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
                 pc->OnError();
-            } else if (current_event.events & EPOLLRDHUP) {
-                pc->OnClose();
             } else {
-                // Depends on what connection wants...
-                if (current_event.events & EPOLLIN) {
+                // Depends on what connection wants... Note that client closing its side
+                // of connection could still have commands to be read before EOF
+                if (current_event.events & (EPOLLIN | EPOLLRDHUP)) {
                     pc->DoRead();
                 }
                 if (current_event.events & EPOLLOUT) {
@@ -159,41 +196,51 @@ void ServerImpl::OnRun() {
             // Does it alive?
             if (!pc->isAlive()) {
                 if (epoll_ctl(epoll_descr, EPOLL_CTL_DEL, pc->_socket, &pc->_event)) {
-                    _logger->error("Failed to delete connection from epoll");
+                    AFINA_LOG_LIMITED(_logger, err, "Failed to delete connection from epoll");
                 }
 
-                close(pc->_socket);
-                pc->OnClose();
-
-                delete pc;
+                CloseConnection(pc);
             } else if (pc->_event.events != old_mask) {
                 if (epoll_ctl(epoll_descr, EPOLL_CTL_MOD, pc->_socket, &pc->_event)) {
-                    _logger->error("Failed to change connection event mask");
-
-                    close(pc->_socket);
-                    pc->OnClose();
+                    AFINA_LOG_LIMITED(_logger, err, "Failed to change connection event mask");
 
-                    delete pc;
+                    CloseConnection(pc);
                 }
             }
         }
+        const auto loop_time = std::chrono::steady_clock::now() - loop_start;
+        loop.End(std::chrono::duration_cast<std::chrono::nanoseconds>(loop_time).count());
     }
+
+    // Server is stopping, drop connections those are still alive
+    while (!_connections.empty()) {
+        CloseConnection(*_connections.begin());
+    }
+    close(epoll_descr);
     _logger->warn("Acceptor stopped");
 }
 
-void ServerImpl::OnNewConnection(int epoll_descr) {
+void ServerImpl::CloseConnection(Connection *pc) {
+    close(pc->_socket);
+    pc->OnClose();
+
+    _connections.erase(pc);
+    delete pc;
+}
+
+void ServerImpl::OnNewConnection(int epoll_descr, int listen_socket) {
     for (;;) {
         struct sockaddr in_addr;
         socklen_t in_len;
 
         // No need to make these sockets non blocking since accept4() takes care of it.
         in_len = sizeof in_addr;
-        int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        int infd = accept4(listen_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
         if (infd == -1) {
             if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
                 break; // We have processed all incoming connections.
             } else {
-                _logger->error("Failed to accept socket");
+                AFINA_LOG_LIMITED(_logger, err, "Failed to accept socket");
                 break;
             }
         }
@@ -206,18 +253,30 @@ void ServerImpl::OnNewConnection(int epoll_descr) {
             _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
         }
 
+        // Do not let clients to exhaust memory and descriptors
+        if (config.max_connections > 0 && _connections.size() >= config.max_connections) {
+            AFINA_LOG_LIMITED(_logger, warn, "Reject connection on descriptor {}: too many open connections", infd);
+
+            static const std::string msg = "SERVER_ERROR too many open connections\r\n";
+            send(infd, msg.data(), msg.size(), 0);
+            close(infd);
+            continue;
+        }
+
         // Register the new FD to be monitored by epoll.
-        Connection *pc = new(std::nothrow) Connection(infd);
+        Connection *pc = new (std::nothrow)
+            Connection(infd, pStorage, _logger, config.output_watermark, config.max_value_size);
         if (pc == nullptr) {
             throw std::runtime_error("Failed to allocate connection");
         }
+        _connections.insert(pc);
 
         // Register connection in worker's epoll
         pc->Start();
         if (pc->isAlive()) {
             if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
                 pc->OnError();
-                delete pc;
+                CloseConnection(pc);
             }
         }
     }
@@ -1,21 +1,21 @@
 #ifndef AFINA_NETWORK_ST_NONBLOCKING_SERVER_H
 #define AFINA_NETWORK_ST_NONBLOCKING_SERVER_H
 
+#include <set>
 #include <thread>
 #include <vector>
 
 #include <afina/network/Server.h>
 
-namespace spdlog {
-class logger;
-}
-
 namespace Afina {
+namespace Logging {
+class AsyncLogger;
+} // namespace Logging
 namespace Network {
 namespace STnonblock {
 
-// Forward declaration, see Worker.h
-class Worker;
+// Forward declaration, see Connection.h
+class Connection;
 
 /**
  * # Network resource manager implementation
@@ -37,11 +37,14 @@ public:
 
 protected:
     void OnRun();
-    void OnNewConnection(int);
+    void OnNewConnection(int, int);
+
+    // Closes connection socket and release all resources allocated for it
+    void CloseConnection(Connection *);
 
 private:
     // logger to use
-    std::shared_ptr<spdlog::logger> _logger;
+    std::shared_ptr<Logging::AsyncLogger> _logger;
 
     // Port to listen for new connections, permits access only from
     // inside of accept_thread
@@ -51,11 +54,17 @@ private:
     // Socket to accept new connection on, shared between acceptors
     int _server_socket;
 
+    // Unix socket to accept new connection on, -1 if not configured
+    int _unix_socket;
+
     // Curstom event "device" used to wakeup workers
     int _event_fd;
 
     // IO thread
     std::thread _work_thread;
+
+    // Connections those are currently served, permits access only from inside of IO thread
+    std::set<Connection *> _connections;
 };
 
 } // namespace STnonblock
@@ -0,0 +1,76 @@
+#include "BinaryParser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <endian.h>
+
+namespace Afina {
+namespace Protocol {
+
+// See BinaryParser.h
+bool BinaryParser::Parse(const char *input, const std::size_t size, std::size_t &parsed) {
+    parsed = 0;
+
+    // Fixed size header goes first
+    if (_header_size < Binary::kHeaderSize) {
+        std::size_t to_read = std::min(Binary::kHeaderSize - _header_size, size);
+        std::memcpy(_header + _header_size, input, to_read);
+        _header_size += to_read;
+        parsed += to_read;
+
+        if (_header_size < Binary::kHeaderSize) {
+            return false;
+        }
+
+        if (uint8_t(_header[0]) != Binary::kMagicRequest) {
+            throw std::runtime_error("Invalid magic of binary request");
+        }
+
+        uint16_t key_length;
+        std::memcpy(&key_length, _header + 2, sizeof(key_length));
+        _key_length = be16toh(key_length);
+        _extras_length = uint8_t(_header[4]);
+
+        uint32_t body_length;
+        std::memcpy(&body_length, _header + 8, sizeof(body_length));
+        _body_length = be32toh(body_length);
+
+        // Opaque is echoed back as is, so keep it in the network order
+        std::memcpy(&_opaque, _header + 12, sizeof(_opaque));
+
+        uint64_t cas;
+        std::memcpy(&cas, _header + 16, sizeof(cas));
+        _cas = be64toh(cas);
+
+        if (std::size_t(_key_length) + _extras_length > _body_length) {
+            throw std::runtime_error("Invalid body length of binary request");
+        }
+        if (_body_length > _max_body_size) {
+            throw std::length_error("object too large for cache");
+        }
+        _body.reserve(_body_length);
+    }
+
+    // ...then body of known size
+    std::size_t to_read = std::min(std::size_t(_body_length) - _body.size(), size - parsed);
+    _body.append(input + parsed, to_read);
+    parsed += to_read;
+
+    return _body.size() == _body_length;
+}
+
+// See BinaryParser.h
+void BinaryParser::Reset() {
+    _header_size = 0;
+    _key_length = 0;
+    _extras_length = 0;
+    _body_length = 0;
+    _opaque = 0;
+    _cas = 0;
+    _body.clear();
+}
+
+} // namespace Protocol
+} // namespace Afina
@@ -0,0 +1,136 @@
+#ifndef AFINA_PROTOCOL_BINARY_PARSER_H
+#define AFINA_PROTOCOL_BINARY_PARSER_H
+
+#include <string>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Afina {
+namespace Protocol {
+
+/**
+ * # Memcached binary protocol wire format
+ * Each packet starts with fixed 24 bytes header, all integers are in network byte order:
+ *
+ *   Byte/     0       |       1       |       2       |       3       |
+ *      /              |               |               |               |
+ *     +---------------+---------------+---------------+---------------+
+ *    0| Magic         | Opcode        | Key length                    |
+ *    4| Extras length | Data type     | vbucket id / status           |
+ *    8| Total body length                                             |
+ *   12| Opaque                                                        |
+ *   16| CAS                                                           |
+ *     +---------------+---------------+---------------+---------------+
+ *
+ * Body follows the header and consists of extras, key and value in that order
+ */
+namespace Binary {
+
+const std::size_t kHeaderSize = 24;
+
+const uint8_t kMagicRequest = 0x80;
+const uint8_t kMagicResponse = 0x81;
+
+enum Opcode : uint8_t {
+    kGet = 0x00,
+    kSet = 0x01,
+    kAdd = 0x02,
+    kReplace = 0x03,
+    kDelete = 0x04,
+    kIncrement = 0x05,
+    kDecrement = 0x06,
+    kQuit = 0x07,
+    kGetQ = 0x09,
+    kNoop = 0x0a,
+    kGetK = 0x0c,
+    kGetKQ = 0x0d,
+    kAppend = 0x0e,
+    kPrepend = 0x0f,
+    kStat = 0x10,
+    kSetQ = 0x11,
+    kAddQ = 0x12,
+    kReplaceQ = 0x13,
+    kDeleteQ = 0x14,
+    kIncrementQ = 0x15,
+    kDecrementQ = 0x16,
+    kQuitQ = 0x17,
+    kAppendQ = 0x19,
+    kPrependQ = 0x1a,
+};
+
+enum Status : uint16_t {
+    kNoError = 0x0000,
+    kKeyNotFound = 0x0001,
+    kKeyExists = 0x0002,
+    kValueTooLarge = 0x0003,
+    kInvalidArguments = 0x0004,
+    kItemNotStored = 0x0005,
+    kNonNumericValue = 0x0006,
+    kUnknownCommand = 0x0081,
+};
+
+} // namespace Binary
+
+/**
+ * # Memcached binary protocol parser
+ * Collects request packet out of the input stream, see Binary namespace above for the format
+ */
+class BinaryParser {
+public:
+    BinaryParser(std::size_t max_body_size) : _max_body_size(max_body_size) { Reset(); }
+
+    /**
+     * Push given bytes into parser input. Method returns true once whole request packet, header
+     * and body, has been collected. Throws std::runtime_error if input isn't a request packet
+     *
+     * @param input string to be added to the parsed input
+     * @param size number of bytes in the input buffer that could be read
+     * @param parsed output parameter tells how many bytes was consumed from the string
+     * @return true if request has been parsed out
+     */
+    bool Parse(const char *input, const std::size_t size, std::size_t &parsed);
+
+    /**
+     * Reset parser so that it could be used to parse out new request
+     */
+    void Reset();
+
+    inline uint8_t Opcode() const { return uint8_t(_header[1]); }
+    inline uint32_t Opaque() const { return _opaque; }
+    inline uint64_t Cas() const { return _cas; }
+
+    inline const char *Extras() const { return _body.data(); }
+    inline std::size_t ExtrasLength() const { return _extras_length; }
+
+    inline std::string Key() const { return _body.substr(_extras_length, _key_length); }
+    inline std::string Value() const { return _body.substr(_extras_length + _key_length); }
+
+    // Key and value without copying them out of the body
+    inline const char *KeyData() const { return _body.data() + _extras_length; }
+    inline std::size_t KeyLength() const { return _key_length; }
+    inline std::size_t ValueLength() const { return _body.size() - _extras_length - _key_length; }
+
+private:
+    // Largest body allowed to be received
+    std::size_t _max_body_size;
+
+    // Raw request header collected so far
+    char _header[Binary::kHeaderSize];
+    std::size_t _header_size;
+
+    // Decoded header fields
+    uint16_t _key_length;
+    uint8_t _extras_length;
+    uint32_t _body_length;
+    uint32_t _opaque;
+    uint64_t _cas;
+
+    // Request body collected so far
+    std::string _body;
+};
+
+} // namespace Protocol
+} // namespace Afina
+
+#endif // AFINA_PROTOCOL_BINARY_PARSER_H
@@ -9,6 +9,11 @@
 #include <afina/execute/Command.h>
 #include <afina/execute/Delete.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/MetaArithmetic.h>
+#include <afina/execute/MetaDelete.h>
+#include <afina/execute/MetaGet.h>
+#include <afina/execute/MetaNoop.h>
+#include <afina/execute/MetaSet.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
 
@@ -32,9 +37,13 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                     state = State::spKey;
                 } else if (name == "get" || name == "gets") {
                     state = State::sgKey;
-                } else if (name == "stats") {
-                    state = State::sLF;
-                    continue;
+                } else if (name == "stats" || name == "mg" || name == "ms" || name == "md" || name == "ma" ||
+                           name == "mn") {
+                    if (c == '\r') {
+                        state = State::sLF;
+                    } else {
+                        state = State::smArgs;
+                    }
                 } else {
                     throw std::runtime_error("Unknown command name: " + name);
                 }
@@ -77,6 +86,22 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
             break;
         }
 
+        case State::smArgs: {
+            if (c == ' ' || c == '\r') {
+                // Meta commands allow several spaces between tokens
+                if (!curKey.empty()) {
+                    keys.push_back(curKey);
+                    curKey.clear();
+                }
+                if (c == '\r') {
+                    state = State::sLF;
+                }
+            } else {
+                curKey.push_back(c);
+            }
+            break;
+        }
+
         case State::spFlags: {
             if (c == ' ') {
                 negative = false;
@@ -109,19 +134,19 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                 state = State::spBytes;
                 // std::cout << "parser debug: ExprTime='" << exprtime << "'" << std::endl;
             } else if (c >= '0' && c <= '9') {
-                int32_t et = exprtime;
+                int64_t et = int64_t(exprtime) * 10;
                 if (negative) {
                     et -= (c - '0');
-                    if (et > exprtime) {
+                    if (et < INT32_MIN) {
                         throw std::runtime_error("Expire time field overflow");
                     }
                 } else {
                     et += (c - '0');
-                    if (et < exprtime) {
+                    if (et > INT32_MAX) {
                         throw std::runtime_error("Expire time field overflow");
                     }
                 }
-                exprtime = et;
+                exprtime = int32_t(et);
             }
             break;
         }
@@ -177,12 +202,47 @@ std::unique_ptr<Execute::Command> Parser::Build(size_t &body_size) const {
     } else if (name == "get") {
         return std::unique_ptr<Execute::Command>(new Execute::Get(keys));
     } else if (name == "stats") {
-        return std::unique_ptr<Execute::Command>(new Execute::Stats());
+        return std::unique_ptr<Execute::Command>(new Execute::Stats(keys.empty() ? std::string() : keys[0],
+                                                                    keys.size() < 2 ? std::string() : keys[1]));
+    } else if (name == "mn") {
+        return std::unique_ptr<Execute::Command>(new Execute::MetaNoop());
+    }
+
+    // Rest are meta commands: <name> <key> [<datalen>] <flags>*
+    if (keys.empty()) {
+        throw std::runtime_error("Client provides no key for " + name);
+    }
+    std::vector<std::string> meta_flags(keys.begin() + 1, keys.end());
+    if (name == "mg") {
+        return std::unique_ptr<Execute::Command>(new Execute::MetaGet(keys[0], meta_flags));
+    } else if (name == "md") {
+        return std::unique_ptr<Execute::Command>(new Execute::MetaDelete(keys[0], meta_flags));
+    } else if (name == "ma") {
+        return std::unique_ptr<Execute::Command>(new Execute::MetaArithmetic(keys[0], meta_flags));
+    } else if (name == "ms") {
+        if (meta_flags.empty() || meta_flags[0].empty() ||
+            meta_flags[0].find_first_not_of("0123456789") != std::string::npos || meta_flags[0].size() > 10) {
+            throw std::runtime_error("Bad data chunk size for ms");
+        }
+        body_size = std::stoul(meta_flags[0]);
+        meta_flags.erase(meta_flags.begin());
+        return std::unique_ptr<Execute::Command>(new Execute::MetaSet(keys[0], meta_flags));
     } else {
         throw std::runtime_error("Unsupported command");
     }
 }
 
+// See Parse.h
+bool Parser::HasBody() const {
+    return name == "set" || name == "add" || name == "append" || name == "prepend" || name == "ms";
+}
+
+// See Parse.h
+const std::string &Parser::Key() const {
+    static const std::string none;
+    return keys.empty() ? none : keys[0];
+}
+
 // See Parse.h
 void Parser::Reset() {
     state = State::sName;
@@ -53,16 +53,33 @@ public:
      */
     void Reset();
 
+    /**
+     * Returns true if parsed command is followed by the data block, which is terminated by \r\n
+     * even if it is empty
+     */
+    bool HasBody() const;
+
     inline const std::string &Name() const { return name; }
 
+    /**
+     * First key or argument of the parsed command, empty if there is none
+     */
+    const std::string &Key() const;
+
+    /**
+     * Keys of the retrieval command, arguments of the others
+     */
+    inline const std::vector<std::string> &Keys() const { return keys; }
+
 private:
     /**
      * State of the command parser. Prefixes are:
      * - s: state for PUT and GET commands
      * - sp: for PUT commands only
      * - sg: for GET commands only
+     * - sm: for meta commands, arguments are kept in keys
      */
-    enum State : uint16_t { sCR, sLF, sName, spKey, spFlags, spExprTimeStart, spExprTime, spBytes, sgKey };
+    enum State : uint16_t { sCR, sLF, sName, spKey, spFlags, spExprTimeStart, spExprTime, spBytes, sgKey, smArgs };
 
     // Current parser state
     State state;
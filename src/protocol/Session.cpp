@@ -0,0 +1,634 @@
+#include "Session.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <endian.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <afina/Storage.h>
+#include <afina/execute/Command.h>
+#include <afina/execute/InsertCommand.h>
+#include <afina/execute/Stats.h>
+#include <afina/metrics/Counters.h>
+#include <afina/metrics/HotKeys.h>
+#include <afina/metrics/Probes.h>
+#include <afina/metrics/SlowLog.h>
+
+namespace Afina {
+namespace Protocol {
+
+namespace {
+
+// Largest key and extras binary request could have, see BinaryParser.h
+const std::size_t kMaxBinaryKeyAndExtras = 0xffff + 0xff;
+
+// Appends binary response packet to the output. CAS isn't supported so it is always zero
+void binary_response(std::string &out, uint8_t opcode, uint16_t status, uint32_t opaque, const char *extras,
+                     std::size_t extras_length, const std::string &key, const std::string &value) {
+    char header[Binary::kHeaderSize];
+    std::memset(header, 0, sizeof(header));
+    header[0] = Binary::kMagicResponse;
+    header[1] = opcode;
+
+    uint16_t key_length = htobe16(uint16_t(key.size()));
+    std::memcpy(header + 2, &key_length, sizeof(key_length));
+    header[4] = uint8_t(extras_length);
+
+    uint16_t status_be = htobe16(status);
+    std::memcpy(header + 6, &status_be, sizeof(status_be));
+
+    uint32_t body_length = htobe32(uint32_t(extras_length + key.size() + value.size()));
+    std::memcpy(header + 8, &body_length, sizeof(body_length));
+    std::memcpy(header + 12, &opaque, sizeof(opaque));
+
+    out.append(header, sizeof(header));
+    out.append(extras, extras_length);
+    out.append(key);
+    out.append(value);
+}
+
+// Appends binary response having no body
+void binary_response(std::string &out, uint8_t opcode, uint16_t status, uint32_t opaque) {
+    binary_response(out, opcode, status, opaque, nullptr, 0, std::string(), std::string());
+}
+
+// Appends binary response with error message as a value
+void binary_error(std::string &out, uint8_t opcode, uint16_t status, uint32_t opaque, const std::string &message) {
+    binary_response(out, opcode, status, opaque, nullptr, 0, std::string(), message);
+}
+
+// Reads integer in network byte order from binary extras
+uint64_t read_be64(const char *p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return be64toh(v);
+}
+
+// Latency of the text command is accounted under
+Metrics::CommandType text_command_type(const std::string &name) {
+    if (name == "get" || name == "gets" || name == "mg") {
+        return Metrics::CommandType::kGet;
+    } else if (name == "set" || name == "add" || name == "append" || name == "prepend" || name == "ms") {
+        return Metrics::CommandType::kSet;
+    } else if (name == "md") {
+        return Metrics::CommandType::kDelete;
+    } else if (name == "ma") {
+        return Metrics::CommandType::kArithmetic;
+    } else if (name == "stats") {
+        return Metrics::CommandType::kStats;
+    }
+    return Metrics::CommandType::kOther;
+}
+
+// Latency of the binary request is accounted under
+Metrics::CommandType binary_command_type(uint8_t opcode) {
+    switch (opcode) {
+    case Binary::kGet:
+    case Binary::kGetQ:
+    case Binary::kGetK:
+    case Binary::kGetKQ:
+        return Metrics::CommandType::kGet;
+    case Binary::kSet:
+    case Binary::kSetQ:
+    case Binary::kAdd:
+    case Binary::kAddQ:
+    case Binary::kReplace:
+    case Binary::kReplaceQ:
+    case Binary::kAppend:
+    case Binary::kAppendQ:
+    case Binary::kPrepend:
+    case Binary::kPrependQ:
+        return Metrics::CommandType::kSet;
+    case Binary::kDelete:
+    case Binary::kDeleteQ:
+        return Metrics::CommandType::kDelete;
+    case Binary::kIncrement:
+    case Binary::kIncrementQ:
+    case Binary::kDecrement:
+    case Binary::kDecrementQ:
+        return Metrics::CommandType::kArithmetic;
+    case Binary::kStat:
+        return Metrics::CommandType::kStats;
+    default:
+        return Metrics::CommandType::kOther;
+    }
+}
+
+uint64_t nanoseconds(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+}
+
+} // namespace
+
+// See Session.h
+Session::Session(std::shared_ptr<Afina::Storage> ps, std::size_t max_value_size)
+    : _pStorage(ps), _max_value_size(max_value_size), _mode(Mode::kUnknown),
+      _binary_parser(max_value_size + kMaxBinaryKeyAndExtras), _arg_remains(0), _parse_time(clock::duration::zero()) {}
+
+// See Session.h
+Session::~Session() {
+    // Responses client never got still count as written till the connection is closed
+    const clock::time_point now = clock::now();
+    for (Batch &batch : _unsent) {
+        Flush(batch.traces, now - batch.ready);
+    }
+}
+
+// See Session.h
+bool Session::Process(const char *input, std::size_t size, std::string &out) {
+    if (size == 0) {
+        return true;
+    }
+
+    Metrics::Counters &counters = Metrics::Local();
+    counters[Metrics::Stat::kBytesRead].Add(size);
+    _connection.Active();
+
+    // Binary requests always start with magic byte, which is never a first char of text command
+    if (_mode == Mode::kUnknown) {
+        _mode = (uint8_t(input[0]) == Binary::kMagicRequest) ? Mode::kBinary : Mode::kText;
+    }
+
+    const std::size_t out_size = out.size();
+    bool keep_alive = false;
+    try {
+        if (_mode == Mode::kBinary) {
+            keep_alive = ProcessBinary(input, size, out);
+        } else {
+            ProcessText(input, size, out);
+            keep_alive = true;
+        }
+    } catch (std::length_error &ex) {
+        if (_mode == Mode::kBinary) {
+            binary_error(out, _binary_parser.Opcode(), Binary::kValueTooLarge, _binary_parser.Opaque(), ex.what());
+        } else {
+            out.append("SERVER_ERROR ").append(ex.what()).append("\r\n");
+        }
+    } catch (std::runtime_error &ex) {
+        if (_mode == Mode::kBinary) {
+            binary_error(out, _binary_parser.Opcode(), Binary::kInvalidArguments, _binary_parser.Opaque(), ex.what());
+        } else {
+            out.append("CLIENT_ERROR ").append(ex.what()).append("\r\n");
+        }
+    }
+
+    counters[Metrics::Stat::kBytesWritten].Add(out.size() - out_size);
+
+    // Network sends output of each call as a whole, so call is a unit of write latency
+    if (out.size() != out_size) {
+        _unsent.push_back(Batch{clock::now(), std::move(_responded), std::move(_traced)});
+    } else {
+        Flush(_traced, clock::duration::zero());
+    }
+    _responded.clear();
+    _traced.clear();
+    return keep_alive;
+}
+
+// See Session.h
+void Session::ProcessText(const char *input, std::size_t size, std::string &out) {
+    // Single block of data could trigger inside actions a multiple times, for example:
+    // - block#0: [<command1 start>]
+    // - block#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
+    while (size > 0) {
+        // There is no command yet
+        if (!_command) {
+            std::size_t parsed = 0;
+            const clock::time_point parse_start = clock::now();
+            if (_parser.Parse(input, size, parsed)) {
+                _command = _parser.Build(_arg_remains);
+                if (_arg_remains > _max_value_size) {
+                    throw std::length_error("object too large for cache");
+                }
+
+                // Argument is followed by \r\n, even an empty one
+                if (_parser.HasBody()) {
+                    _arg_remains += 2;
+                }
+            }
+            _parse_time += clock::now() - parse_start;
+            if (_command) {
+                AFINA_PROBE5(command_parsed, _connection.Id(), _parser.Name().c_str(), _parser.Key().size(),
+                             _parser.HasBody() ? _arg_remains - 2 : 0, nanoseconds(_parse_time));
+            }
+
+            // Parser might fail to consume any bytes from input stream
+            if (parsed == 0) {
+                break;
+            }
+            input += parsed;
+            size -= parsed;
+        }
+
+        // There is command, but we still wait for argument to arrive...
+        if (_command && _arg_remains > 0) {
+            std::size_t to_read = std::min(_arg_remains, size);
+            _argument.append(input, to_read);
+
+            input += to_read;
+            size -= to_read;
+            _arg_remains -= to_read;
+        }
+
+        // There is command & argument - RUN!
+        if (_command && _arg_remains == 0) {
+            if (!_argument.empty()) {
+                if (_argument.compare(_argument.size() - 2, 2, "\r\n") != 0) {
+                    throw std::runtime_error("bad data chunk");
+                }
+                _argument.resize(_argument.size() - 2);
+            }
+
+            // Quiet commands could have nothing to say
+            std::string result;
+            Metrics::TakeLockWait();
+            const clock::time_point execute_start = clock::now();
+            _command->Execute(*_pStorage, _argument, result);
+            const clock::duration execute = clock::now() - execute_start;
+            Trace(_parser.Name(), _parser.Key().data(), _parser.Key().size(), _argument.size(), result.size(), execute);
+            const Metrics::CommandType type = text_command_type(_parser.Name());
+            RecordLatency(type, execute, !result.empty());
+            if (type != Metrics::CommandType::kStats && type != Metrics::CommandType::kOther &&
+                Metrics::HotKeySampling() != 0) {
+                // Retrieval command could ask for several keys, meta ones have flags after the key
+                const std::vector<std::string> &keys = _parser.Keys();
+                const bool multi = (_parser.Name() == "get" || _parser.Name() == "gets");
+                for (std::size_t i = 0; i < keys.size() && (multi || i == 0); i++) {
+                    Metrics::SampleKey(keys[i].data(), keys[i].size());
+                }
+            }
+            if (!result.empty()) {
+                out.append(result);
+                out.append("\r\n");
+            }
+
+            // Prepare for the next command
+            Reset();
+        }
+    }
+}
+
+// See Session.h
+bool Session::ProcessBinary(const char *input, std::size_t size, std::string &out) {
+    // Unlike text one binary parser knows exact size of request, so it consumes only what request
+    // needs leaving the rest for the following requests
+    while (size > 0) {
+        std::size_t parsed = 0;
+        const clock::time_point parse_start = clock::now();
+        bool complete = _binary_parser.Parse(input, size, parsed);
+        _parse_time += clock::now() - parse_start;
+        input += parsed;
+        size -= parsed;
+
+        if (complete) {
+            const std::size_t out_size = out.size();
+            const Metrics::CommandType type = binary_command_type(_binary_parser.Opcode());
+            AFINA_PROBE5(command_parsed, _connection.Id(), Metrics::Name(type), _binary_parser.KeyLength(),
+                         _binary_parser.ValueLength(), nanoseconds(_parse_time));
+            Metrics::TakeLockWait();
+            const clock::time_point execute_start = clock::now();
+            bool keep_alive = ExecuteBinary(out);
+            const clock::duration execute = clock::now() - execute_start;
+            Trace(Metrics::Name(type), _binary_parser.KeyData(), _binary_parser.KeyLength(),
+                  _binary_parser.ValueLength(), out.size() - out_size, execute);
+            RecordLatency(type, execute, out.size() != out_size);
+            if (type != Metrics::CommandType::kStats && type != Metrics::CommandType::kOther &&
+                _binary_parser.KeyLength() > 0) {
+                Metrics::SampleKey(_binary_parser.KeyData(), _binary_parser.KeyLength());
+            }
+            _binary_parser.Reset();
+            if (!keep_alive) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// See Session.h
+bool Session::ExecuteBinary(std::string &out) {
+    const BinaryParser &request = _binary_parser;
+    const uint8_t opcode = request.Opcode();
+    const uint32_t opaque = request.Opaque();
+    Metrics::Counters &counters = Metrics::Local();
+
+    switch (opcode) {
+    case Binary::kGet:
+    case Binary::kGetQ:
+    case Binary::kGetK:
+    case Binary::kGetKQ: {
+        const bool quiet = (opcode == Binary::kGetQ || opcode == Binary::kGetKQ);
+        const bool with_key = (opcode == Binary::kGetK || opcode == Binary::kGetKQ);
+        std::string key = request.Key();
+        if (request.ExtrasLength() != 0 || key.empty()) {
+            binary_error(out, opcode, Binary::kInvalidArguments, opaque, "Invalid arguments");
+            break;
+        }
+
+        std::string value;
+        const bool found = _pStorage->Get(key, value);
+        counters[Metrics::Stat::kCmdGet].Add();
+        counters[found ? Metrics::Stat::kGetHits : Metrics::Stat::kGetMisses].Add();
+        if (found) {
+            // Flags aren't stored, so always zero
+            const char flags[4] = {0, 0, 0, 0};
+            binary_response(out, opcode, Binary::kNoError, opaque, flags, sizeof(flags),
+                            with_key ? key : std::string(), value);
+        } else if (!quiet) {
+            binary_response(out, opcode, Binary::kKeyNotFound, opaque, nullptr, 0, with_key ? key : std::string(),
+                            "Not found");
+        }
+        break;
+    }
+
+    case Binary::kSet:
+    case Binary::kSetQ:
+    case Binary::kAdd:
+    case Binary::kAddQ:
+    case Binary::kReplace:
+    case Binary::kReplaceQ: {
+        std::string key = request.Key();
+        if (request.ExtrasLength() != 8 || key.empty()) {
+            binary_error(out, opcode, Binary::kInvalidArguments, opaque, "Invalid arguments");
+            break;
+        }
+
+        // Extras are: flags (4 bytes), expiration (4 bytes)
+        uint32_t expire;
+        std::memcpy(&expire, request.Extras() + 4, sizeof(expire));
+        const int32_t ttl = Execute::InsertCommand::ExpireToTTL(int32_t(be32toh(expire)));
+
+        counters[Metrics::Stat::kCmdSet].Add();
+        bool stored = false;
+        uint16_t status = Binary::kItemNotStored;
+        if (opcode == Binary::kSet || opcode == Binary::kSetQ) {
+            stored = _pStorage->Put(key, request.Value(), ttl);
+        } else if (opcode == Binary::kAdd || opcode == Binary::kAddQ) {
+            stored = _pStorage->PutIfAbsent(key, request.Value(), ttl);
+            status = Binary::kKeyExists;
+        } else {
+            stored = _pStorage->Set(key, request.Value(), ttl);
+            status = Binary::kKeyNotFound;
+        }
+
+        const bool quiet = (opcode == Binary::kSetQ || opcode == Binary::kAddQ || opcode == Binary::kReplaceQ);
+        if (!stored) {
+            binary_error(out, opcode, status, opaque, "Not stored");
+        } else if (!quiet) {
+            binary_response(out, opcode, Binary::kNoError, opaque);
+        }
+        break;
+    }
+
+    case Binary::kAppend:
+    case Binary::kAppendQ:
+    case Binary::kPrepend:
+    case Binary::kPrependQ: {
+        std::string key = request.Key();
+        if (request.ExtrasLength() != 0 || key.empty()) {
+            binary_error(out, opcode, Binary::kInvalidArguments, opaque, "Invalid arguments");
+            break;
+        }
+
+        counters[Metrics::Stat::kCmdSet].Add();
+        std::string value;
+        if (!_pStorage->Get(key, value)) {
+            binary_error(out, opcode, Binary::kItemNotStored, opaque, "Not stored");
+            break;
+        }
+
+        if (opcode == Binary::kAppend || opcode == Binary::kAppendQ) {
+            value.append(request.Value());
+        } else {
+            value.insert(0, request.Value());
+        }
+
+        // Plain Set keeps expiration time of the item
+        if (!_pStorage->Set(key, value)) {
+            binary_error(out, opcode, Binary::kItemNotStored, opaque, "Not stored");
+        } else if (opcode == Binary::kAppend || opcode == Binary::kPrepend) {
+            binary_response(out, opcode, Binary::kNoError, opaque);
+        }
+        break;
+    }
+
+    case Binary::kDelete:
+    case Binary::kDeleteQ: {
+        std::string key = request.Key();
+        if (request.ExtrasLength() != 0 || key.empty()) {
+            binary_error(out, opcode, Binary::kInvalidArguments, opaque, "Invalid arguments");
+            break;
+        }
+
+        const bool deleted = _pStorage->Delete(key);
+        counters[Metrics::Stat::kCmdDelete].Add();
+        counters[deleted ? Metrics::Stat::kDeleteHits : Metrics::Stat::kDeleteMisses].Add();
+        if (!deleted) {
+            binary_error(out, opcode, Binary::kKeyNotFound, opaque, "Not found");
+        } else if (opcode == Binary::kDelete) {
+            binary_response(out, opcode, Binary::kNoError, opaque);
+        }
+        break;
+    }
+
+    case Binary::kIncrement:
+    case Binary::kIncrementQ:
+    case Binary::kDecrement:
+    case Binary::kDecrementQ: {
+        // Extras are: delta (8 bytes), initial value (8 bytes), expiration (4 bytes)
+        std::string key = request.Key();
+        if (request.ExtrasLength() != 20 || key.empty()) {
+            binary_error(out, opcode, Binary::kInvalidArguments, opaque, "Invalid arguments");
+            break;
+        }
+
+        const uint64_t delta = read_be64(request.Extras());
+        const uint64_t initial = read_be64(request.Extras() + 8);
+        const bool create = std::memcmp(request.Extras() + 16, "\xff\xff\xff\xff", 4) != 0;
+        uint32_t expire;
+        std::memcpy(&expire, request.Extras() + 16, sizeof(expire));
+
+        const bool incr = (opcode == Binary::kIncrement || opcode == Binary::kIncrementQ);
+        uint64_t counter;
+        std::string value;
+        bool exists = _pStorage->Get(key, value);
+        counters[incr ? Metrics::Stat::kCmdIncr : Metrics::Stat::kCmdDecr].Add();
+        if (incr) {
+            counters[exists ? Metrics::Stat::kIncrHits : Metrics::Stat::kIncrMisses].Add();
+        } else {
+            counters[exists ? Metrics::Stat::kDecrHits : Metrics::Stat::kDecrMisses].Add();
+        }
+        if (exists) {
+            // Counters are kept as decimal strings, the same way text protocol does
+            char *end = nullptr;
+            errno = 0;
+            counter = std::strtoull(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0' || errno == ERANGE) {
+                binary_error(out, opcode, Binary::kNonNumericValue, opaque,
+                             "Non-numeric server-side value for incr or decr");
+                break;
+            }
+
+            if (incr) {
+                counter += delta;
+            } else {
+                counter = (delta > counter) ? 0 : counter - delta;
+            }
+        } else if (create) {
+            counter = initial;
+        } else {
+            binary_error(out, opcode, Binary::kKeyNotFound, opaque, "Not found");
+            break;
+        }
+
+        // Existing counter keeps its expiration time, new one gets it from the request
+        bool stored = exists ? _pStorage->Set(key, std::to_string(counter))
+                             : _pStorage->Put(key, std::to_string(counter),
+                                              Execute::InsertCommand::ExpireToTTL(int32_t(be32toh(expire))));
+        if (!stored) {
+            binary_error(out, opcode, Binary::kItemNotStored, opaque, "Not stored");
+        } else if (opcode == Binary::kIncrement || opcode == Binary::kDecrement) {
+            uint64_t counter_be = htobe64(counter);
+            binary_response(out, opcode, Binary::kNoError, opaque, nullptr, 0, std::string(),
+                            std::string(reinterpret_cast<const char *>(&counter_be), sizeof(counter_be)));
+        }
+        break;
+    }
+
+    case Binary::kNoop: {
+        // Client uses noop to terminate batch of quiet requests, all responses for them
+        // are already in the output, so just confirm
+        binary_response(out, opcode, Binary::kNoError, opaque);
+        break;
+    }
+
+    case Binary::kStat: {
+        // Each "STAT <name> <value>" line of text stats becomes a separate packet, empty one
+        // terminates the sequence
+        // Key names the group, the same way text `stats <group>` does
+        std::string args, result;
+        Execute::Stats stats(request.Key());
+        stats.Execute(*_pStorage, args, result);
+
+        std::size_t pos = 0;
+        while (pos < result.size()) {
+            std::size_t eol = result.find("\r\n", pos);
+            std::string line = result.substr(pos, eol == std::string::npos ? std::string::npos : eol - pos);
+            pos = (eol == std::string::npos) ? result.size() : eol + 2;
+
+            if (line.compare(0, 5, "STAT ") != 0) {
+                continue;
+            }
+
+            std::size_t sep = line.find(' ', 5);
+            std::string name = line.substr(5, sep == std::string::npos ? std::string::npos : sep - 5);
+            std::string value = (sep == std::string::npos) ? std::string() : line.substr(sep + 1);
+            binary_response(out, opcode, Binary::kNoError, opaque, nullptr, 0, name, value);
+        }
+        binary_response(out, opcode, Binary::kNoError, opaque);
+        break;
+    }
+
+    case Binary::kQuit:
+    case Binary::kQuitQ: {
+        if (opcode == Binary::kQuit) {
+            binary_response(out, opcode, Binary::kNoError, opaque);
+        }
+        return false;
+    }
+
+    default:
+        binary_error(out, opcode, Binary::kUnknownCommand, opaque, "Unknown command");
+        break;
+    }
+
+    return true;
+}
+
+// See Session.h
+void Session::RecordLatency(Metrics::CommandType type, clock::duration execute, bool responded) {
+    Metrics::Latencies &latencies = Metrics::LocalLatencies();
+    latencies(type, Metrics::Phase::kParse).Record(nanoseconds(_parse_time));
+    latencies(type, Metrics::Phase::kExecute).Record(nanoseconds(execute));
+    _parse_time = clock::duration::zero();
+
+    // Quiet commands have no response to wait for
+    if (responded) {
+        _responded.push_back(type);
+    }
+}
+
+// See Session.h
+void Session::Trace(const std::string &command, const char *key, std::size_t key_size, std::size_t request_size,
+                    std::size_t response_size, clock::duration execute) {
+    const uint64_t lock_wait = Metrics::TakeLockWait();
+    AFINA_PROBE6(command_done, _connection.Id(), command.c_str(), key_size, response_size, nanoseconds(execute),
+                 lock_wait);
+    if (!Metrics::SlowRequests().Enabled()) {
+        return;
+    }
+
+    // Whether request is slow is known only once its response is sent
+    _traced.emplace_back();
+    Metrics::SlowRequest &request = _traced.back();
+    std::memset(&request, 0, sizeof(request));
+    const auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+    request.time = std::chrono::duration_cast<std::chrono::microseconds>(since_epoch).count();
+    request.worker = syscall(SYS_gettid);
+    request.parse = nanoseconds(_parse_time);
+    request.execute = nanoseconds(execute);
+    request.lock_wait = lock_wait;
+    request.request_size = request_size;
+    request.response_size = response_size;
+    request.key_size = key_size;
+    std::strncpy(request.command, command.c_str(), sizeof(request.command));
+    std::memcpy(request.key, key, std::min(key_size, Metrics::SlowRequest::kMaxKey));
+}
+
+// See Session.h
+void Session::Flush(std::vector<Metrics::SlowRequest> &traces, clock::duration write) {
+    for (Metrics::SlowRequest &request : traces) {
+        request.write = nanoseconds(write);
+        bool sampled;
+        if (Metrics::SlowRequests().Wants(request.parse + request.execute + request.write, sampled)) {
+            request.sampled = sampled;
+            Metrics::SlowRequests().Push(request);
+        }
+    }
+    traces.clear();
+}
+
+// See Session.h
+void Session::Reset() {
+    _command.reset();
+    _argument.resize(0);
+    _arg_remains = 0;
+    _parse_time = clock::duration::zero();
+    _parser.Reset();
+    _binary_parser.Reset();
+}
+
+// See Session.h
+void Session::Sent() {
+    if (_unsent.empty()) {
+        return;
+    }
+
+    const clock::time_point now = clock::now();
+    const uint64_t write = nanoseconds(now - _unsent.front().ready);
+    Metrics::Latencies &latencies = Metrics::LocalLatencies();
+    for (Metrics::CommandType type : _unsent.front().commands) {
+        latencies(type, Metrics::Phase::kWrite).Record(write);
+    }
+    AFINA_PROBE3(response_sent, _connection.Id(), _unsent.front().commands.size(), write);
+    Flush(_unsent.front().traces, now - _unsent.front().ready);
+    _unsent.pop_front();
+}
+
+} // namespace Protocol
+} // namespace Afina
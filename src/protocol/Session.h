@@ -0,0 +1,140 @@
+#ifndef AFINA_PROTOCOL_SESSION_H
+#define AFINA_PROTOCOL_SESSION_H
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+
+#include <afina/metrics/Connections.h>
+#include <afina/metrics/Latency.h>
+#include <afina/metrics/SlowLog.h>
+
+#include "BinaryParser.h"
+#include "Parser.h"
+
+namespace Afina {
+class Storage;
+namespace Execute {
+class Command;
+} // namespace Execute
+namespace Protocol {
+
+/**
+ * # Request processing state of a single client connection
+ * Accumulates input read from the client, parses commands out of it, executes them over
+ * storage and collects responses to be sent back to the client.
+ *
+ * Both text and binary memcached protocols are supported, which one client speaks is detected
+ * by the first byte it sends: binary requests always start with 0x80 magic
+ */
+class Session {
+public:
+    Session(std::shared_ptr<Afina::Storage> ps, std::size_t max_value_size);
+    ~Session();
+
+    /**
+     * Push given block of client input into session. Each command completed by the input gets
+     * executed and its response appended to the output. Whole input is always consumed, incomplete
+     * command is kept inside of session until the rest of it arrives.
+     *
+     * If input is malformed or client asks to quit, error response, if any, is appended to the output
+     * and method returns false. After that session must not be used anymore and connection should be
+     * closed once output is sent
+     *
+     * @param input bytes read from the client
+     * @param size number of bytes in the input
+     * @param out string to append responses to
+     * @return false if connection must be closed
+     */
+    bool Process(const char *input, std::size_t size, std::string &out);
+
+    /**
+     * Drop partially received command, if any
+     */
+    void Reset();
+
+    /**
+     * Notify that output appended by the oldest Process call not reported yet is completely
+     * written to the client. Calls that appended nothing don't count. Only used to measure how
+     * long responses wait for the client, slow log gets requests once their responses are sent
+     */
+    void Sent();
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    // Protocol client speaks
+    enum class Mode { kUnknown, kText, kBinary };
+
+    // Responses appended by a single Process call and traces of their requests, see Trace
+    struct Batch {
+        clock::time_point ready;
+        std::vector<Metrics::CommandType> commands;
+        std::vector<Metrics::SlowRequest> traces;
+    };
+
+    // Process input of text protocol client, see Process
+    void ProcessText(const char *input, std::size_t size, std::string &out);
+
+    // Process input of binary protocol client, see Process
+    bool ProcessBinary(const char *input, std::size_t size, std::string &out);
+
+    // Execute request collected by binary parser
+    bool ExecuteBinary(std::string &out);
+
+    // Records parse and execute time of the command, accumulated parse time is reset
+    void RecordLatency(Metrics::CommandType type, clock::duration execute, bool responded);
+
+    // Keeps trace of the command while slow log is on, see Flush
+    void Trace(const std::string &command, const char *key, std::size_t key_size, std::size_t request_size,
+               std::size_t response_size, clock::duration execute);
+
+    // Puts traces into slow log, the ones that took long enough with their write time or got sampled
+    void Flush(std::vector<Metrics::SlowRequest> &traces, clock::duration write);
+
+    // Storage commands get executed on
+    std::shared_ptr<Afina::Storage> _pStorage;
+
+    // Largest command argument allowed to be received
+    std::size_t _max_value_size;
+
+    // Protocol of the client, unknown until first byte arrives
+    Mode _mode;
+
+    // Parse state of the text input stream
+    Parser _parser;
+
+    // Parse state of the binary input stream
+    BinaryParser _binary_parser;
+
+    // Last command parsed out of text stream
+    std::unique_ptr<Execute::Command> _command;
+
+    // How many bytes to read from text stream to get command argument
+    std::size_t _arg_remains;
+
+    // Argument of the command received so far
+    std::string _argument;
+
+    // Listing of the client in `stats conns`
+    Metrics::Connection _connection;
+
+    // Time spent so far in parsing the current command
+    clock::duration _parse_time;
+
+    // Commands responded to by the current Process call and their traces
+    std::vector<Metrics::CommandType> _responded;
+    std::vector<Metrics::SlowRequest> _traced;
+
+    // Responses not sent yet, oldest first
+    std::deque<Batch> _unsent;
+};
+
+} // namespace Protocol
+} // namespace Afina
+
+#endif // AFINA_PROTOCOL_SESSION_H
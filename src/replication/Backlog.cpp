@@ -0,0 +1,62 @@
+#include "Backlog.h"
+
+#include <algorithm>
+
+namespace Afina {
+namespace Replication {
+
+Backlog::Backlog(std::size_t capacity) : _capacity(capacity), _start(0), _closed(false) {}
+
+// See Backlog.h
+void Backlog::Append(const Backend::OpLog::Record &record) {
+    // Encoding happens out of the lock into a buffer each thread reuses
+    static thread_local std::string data;
+    data.clear();
+    Backend::OpLog::Encode(record, data);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _data.append(data);
+
+    // Old bytes are dropped in large chunks, so that cost of the move is amortized
+    if (_data.size() > 2 * _capacity) {
+        const std::size_t drop = _data.size() - _capacity;
+        _data.erase(0, drop);
+        _start += drop;
+    }
+    _appended.notify_all();
+}
+
+// See Backlog.h
+uint64_t Backlog::End() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _start + _data.size();
+}
+
+// See Backlog.h
+bool Backlog::Keeps(uint64_t offset) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return !_closed && offset >= _start && offset <= _start + _data.size();
+}
+
+// See Backlog.h
+bool Backlog::Read(uint64_t offset, std::size_t max_size, std::string &out, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _appended.wait_for(lock, timeout, [this, offset]() { return _closed || offset != _start + _data.size(); });
+    if (_closed || offset < _start || offset > _start + _data.size()) {
+        return false;
+    }
+
+    const std::size_t from = offset - _start;
+    out.assign(_data, from, std::min(max_size, _data.size() - from));
+    return true;
+}
+
+// See Backlog.h
+void Backlog::Close() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _closed = true;
+    _appended.notify_all();
+}
+
+} // namespace Replication
+} // namespace Afina
@@ -0,0 +1,69 @@
+#ifndef AFINA_REPLICATION_BACKLOG_H
+#define AFINA_REPLICATION_BACKLOG_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "storage/OpLog.h"
+
+namespace Afina {
+namespace Replication {
+
+/**
+ * # Recent changes of the leader
+ * Stream of encoded OpLog records, every byte of it has an offset counted from the leader start.
+ * Only the last capacity bytes are kept, follower that fell behind them has to sync from scratch.
+ *
+ * Appends and reads are thread safe, readers wait for new records without polling
+ */
+class Backlog {
+public:
+    Backlog(std::size_t capacity);
+    ~Backlog() {}
+
+    /**
+     * Appends record to the stream
+     */
+    void Append(const Backend::OpLog::Record &record);
+
+    /**
+     * Offset records appended next get
+     */
+    uint64_t End();
+
+    /**
+     * Returns true if stream from the offset on is still kept
+     */
+    bool Keeps(uint64_t offset);
+
+    /**
+     * Copies at most max_size bytes starting at the offset into out, waiting up to timeout for
+     * them to appear. Returns false if offset is no longer kept or backlog is closed
+     */
+    bool Read(uint64_t offset, std::size_t max_size, std::string &out, std::chrono::milliseconds timeout);
+
+    /**
+     * Wakes up all readers, subsequent reads fail
+     */
+    void Close();
+
+private:
+    const std::size_t _capacity;
+
+    std::mutex _mutex;
+    std::condition_variable _appended;
+
+    // Kept part of the stream and offset of its first byte
+    std::string _data;
+    uint64_t _start;
+
+    bool _closed;
+};
+
+} // namespace Replication
+} // namespace Afina
+
+#endif // AFINA_REPLICATION_BACKLOG_H
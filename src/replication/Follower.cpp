@@ -0,0 +1,207 @@
+#include "Follower.h"
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <unordered_set>
+#include <vector>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "Socket.h"
+#include "storage/OpLog.h"
+
+namespace Afina {
+namespace Replication {
+
+// How long to wait before connecting to the leader once again
+static const std::chrono::milliseconds kReconnectDelay(1000);
+
+// Snapshot frames larger than that are considered damaged
+static const uint32_t kMaxFrame = 64 << 20;
+
+Follower::Follower(std::shared_ptr<Afina::Storage> storage, const std::string &host, uint16_t port)
+    : _storage(storage), _host(host), _port(port), _offset(0), _full_syncs(0), _running(false), _socket(-1) {}
+
+Follower::~Follower() { Stop(); }
+
+// See Follower.h
+void Follower::Start() {
+    _storage->Start();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _running = true;
+    _thread = std::thread(&Follower::OnRun, this);
+}
+
+// See Follower.h
+void Follower::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running) {
+            return;
+        }
+        _running = false;
+        if (_socket != -1) {
+            shutdown(_socket, SHUT_RDWR);
+        }
+    }
+    _stopped.notify_all();
+    _thread.join();
+    _storage->Stop();
+}
+
+// See Follower.h
+void Follower::OnRun() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_running) {
+        lock.unlock();
+        int socket = Connect();
+        lock.lock();
+
+        if (socket != -1 && _running) {
+            _socket = socket;
+            lock.unlock();
+
+            std::string request = "SYNC " + (_run_id.empty() ? std::string("?") : _run_id) + " " +
+                                  std::to_string(_offset.load()) + "\r\n";
+            std::string reply;
+            char run_id[64];
+            uint64_t offset;
+            if (send_all(socket, request.data(), request.size()) && read_line(socket, reply, 256)) {
+                if (std::sscanf(reply.c_str(), "+CONTINUE %63s %" SCNu64, run_id, &offset) == 2) {
+                    Stream(socket);
+                } else if (std::sscanf(reply.c_str(), "+FULLSYNC %63s %" SCNu64, run_id, &offset) == 2 &&
+                           FullSync(socket)) {
+                    // Position is remembered only once snapshot is complete, broken one is repeated
+                    _run_id = run_id;
+                    _offset = offset;
+                    Stream(socket);
+                }
+            }
+
+            lock.lock();
+            _socket = -1;
+        }
+        if (socket != -1) {
+            close(socket);
+        }
+
+        // Leader is down or went away, try once again a bit later
+        _stopped.wait_for(lock, kReconnectDelay, [this]() { return !_running; });
+    }
+}
+
+// See Follower.h
+int Follower::Connect() {
+    struct addrinfo hints, *addrs;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(_host.c_str(), std::to_string(_port).c_str(), &hints, &addrs) != 0) {
+        return -1;
+    }
+
+    int result = -1;
+    for (struct addrinfo *addr = addrs; addr != nullptr && result == -1; addr = addr->ai_next) {
+        int socket = ::socket(addr->ai_family, addr->ai_socktype | SOCK_CLOEXEC, addr->ai_protocol);
+        if (socket == -1) {
+            continue;
+        } else if (connect(socket, addr->ai_addr, addr->ai_addrlen) == -1) {
+            close(socket);
+            continue;
+        }
+
+        // Leader is silent while there are no changes, keepalive notices if its host is gone
+        int opts = 1;
+        setsockopt(socket, SOL_SOCKET, SO_KEEPALIVE, &opts, sizeof(opts));
+        result = socket;
+    }
+    freeaddrinfo(addrs);
+    return result;
+}
+
+// See Follower.h
+bool Follower::FullSync(int socket) {
+    // Replica could have keys leader doesn't have anymore, they are found once snapshot is over
+    std::unordered_set<std::string> keys;
+    std::string frame;
+    Backend::OpLog::Record record;
+    while (true) {
+        uint32_t size;
+        if (!read_all(socket, reinterpret_cast<char *>(&size), sizeof(size)) || size > kMaxFrame) {
+            return false;
+        } else if (size == 0) {
+            break;
+        }
+
+        frame.resize(size);
+        if (!read_all(socket, &frame[0], size)) {
+            return false;
+        }
+
+        const char *data = frame.data();
+        const char *end = data + frame.size();
+        while (data != end) {
+            if (Backend::OpLog::Decode(data, end, record) != 1) {
+                return false;
+            }
+            Backend::OpLog::Apply(*_storage, record);
+            keys.insert(record.key);
+        }
+    }
+
+    std::vector<std::string> stale;
+    _storage->Snapshot([&keys, &stale](const std::string &key, const std::string &, int32_t) {
+        if (keys.find(key) == keys.end()) {
+            stale.push_back(key);
+        }
+        return true;
+    });
+    for (const std::string &key : stale) {
+        _storage->Delete(key);
+    }
+
+    _full_syncs++;
+    return true;
+}
+
+// See Follower.h
+void Follower::Stream(int socket) {
+    std::string buffer;
+    char chunk[64 << 10];
+    Backend::OpLog::Record record;
+    while (true) {
+        ssize_t n = recv(socket, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            return;
+        }
+        buffer.append(chunk, n);
+
+        // Everything received at once is applied at once, last record could be incomplete yet
+        const char *data = buffer.data();
+        const char *end = data + buffer.size();
+        int status;
+        while ((status = Backend::OpLog::Decode(data, end, record)) == 1) {
+            Backend::OpLog::Apply(*_storage, record);
+        }
+        if (status < 0) {
+            return;
+        }
+
+        const std::size_t applied = data - buffer.data();
+        buffer.erase(0, applied);
+        _offset += applied;
+    }
+}
+
+} // namespace Replication
+} // namespace Afina
@@ -0,0 +1,113 @@
+#ifndef AFINA_REPLICATION_FOLLOWER_H
+#define AFINA_REPLICATION_FOLLOWER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Replication {
+
+/**
+ * # Read-only replica of the leader storage
+ * Background thread keeps connection to the leader and applies changes it streams, see Leader.h
+ * for the protocol. Clients could only read, all the changes come from the leader.
+ *
+ * Follower remembers leader run and offset it got to, so after reconnect it continues where it
+ * stopped and only gets a full snapshot again if leader has restarted or doesn't keep that offset
+ * anymore. Keys that are not in a repeated full snapshot are removed, so wrapped storage must
+ * support snapshots and be thread safe
+ */
+class Follower : public Afina::Storage {
+public:
+    /**
+     * @param storage to keep replica in
+     * @param host leader address
+     * @param port leader replication port
+     */
+    Follower(std::shared_ptr<Afina::Storage> storage, const std::string &host, uint16_t port);
+    ~Follower();
+
+    // Starts wrapped storage and connects to the leader
+    void Start() override;
+
+    // Disconnects from the leader and stops wrapped storage
+    void Stop() override;
+
+    // Replica is read-only, always fails
+    bool Put(const std::string &key, const std::string &value) override { return false; }
+
+    // Replica is read-only, always fails
+    bool PutIfAbsent(const std::string &key, const std::string &value) override { return false; }
+
+    // Replica is read-only, always fails
+    bool Set(const std::string &key, const std::string &value) override { return false; }
+
+    // Replica is read-only, always fails
+    bool Delete(const std::string &key) override { return false; }
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override { return _storage->Get(key, value); }
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override {
+        return _storage->Get(key, value, expire);
+    }
+
+    // Snapshot of the wrapped storage
+    bool Snapshot(const SnapshotWriter &writer) override { return _storage->Snapshot(writer); }
+
+    // Statistics of the wrapped storage
+    void Stats(const std::string &group, const StatWriter &writer) override { _storage->Stats(group, writer); }
+
+    // Gauges of the wrapped storage
+    const Metrics::StorageGauges *Gauges() const override { return _storage->Gauges(); }
+
+    // Offset of the leader stream applied so far
+    uint64_t Offset() const { return _offset.load(); }
+
+    // Number of full snapshots received
+    uint64_t FullSyncs() const { return _full_syncs.load(); }
+
+private:
+    // Connects to the leader and applies its changes until connection breaks, runs in its own
+    // thread over and over until follower is stopped
+    void OnRun();
+
+    // Opens connection to the leader, -1 on failure
+    int Connect();
+
+    // Receives snapshot frames and applies them, returns false if connection breaks
+    bool FullSync(int socket);
+
+    // Applies stream of changes until connection breaks
+    void Stream(int socket);
+
+    std::shared_ptr<Afina::Storage> _storage;
+    const std::string _host;
+    const uint16_t _port;
+
+    // Position in the leader stream
+    std::string _run_id;
+    std::atomic<uint64_t> _offset;
+    std::atomic<uint64_t> _full_syncs;
+
+    std::thread _thread;
+
+    // Guards socket and running flag, so that Stop could break the connection
+    std::mutex _mutex;
+    std::condition_variable _stopped;
+    bool _running;
+    int _socket;
+};
+
+} // namespace Replication
+} // namespace Afina
+
+#endif // AFINA_REPLICATION_FOLLOWER_H
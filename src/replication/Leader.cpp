@@ -0,0 +1,280 @@
+#include "Leader.h"
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <afina/logging/Service.h>
+
+#include "Socket.h"
+
+namespace Afina {
+namespace Replication {
+
+// Snapshot is sent in frames of about that size, backlog is read by chunks of the same size
+static const std::size_t kFrameSize = 64 << 10;
+
+// How often follower threads check that leader is still running while there are no changes
+static const std::chrono::milliseconds kIdleCheck(500);
+
+// Pause after failed accept, so that running out of descriptors doesn't turn into a busy loop
+static const std::chrono::milliseconds kAcceptBackoff(100);
+
+Leader::Leader(std::shared_ptr<Afina::Storage> storage, uint16_t port, std::size_t backlog_size,
+               std::shared_ptr<Afina::Logging::Service> logging)
+    : _storage(storage), _logging(logging), _backlog(backlog_size), _port(port), _server_socket(-1),
+      _running(false) {
+    for (auto &stripe : _stripes) {
+        stripe.reset(new Metrics::ProfiledMutex("leader"));
+    }
+
+    // Follower that remembers offset of another run must not continue from it
+    std::random_device random;
+    char run_id[17];
+    std::snprintf(run_id, sizeof(run_id), "%08x%08x", random(), random());
+    _run_id = run_id;
+}
+
+Leader::~Leader() { Stop(); }
+
+// See Leader.h
+void Leader::Start() {
+    if (_logging) {
+        _logger = _logging->select("replication");
+    }
+    _storage->Start();
+
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(_port);
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+
+    _server_socket = socket(PF_INET, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open replication socket");
+    }
+
+    int opts = 1;
+    socklen_t addr_len = sizeof(server_addr);
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1 ||
+        bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1 ||
+        listen(_server_socket, 16) == -1 ||
+        getsockname(_server_socket, (struct sockaddr *)&server_addr, &addr_len) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Failed to listen for followers: " + std::string(std::strerror(errno)));
+    }
+    _port = ntohs(server_addr.sin_port);
+
+    _running.store(true);
+    _thread = std::thread(&Leader::OnRun, this);
+}
+
+// See Leader.h
+void Leader::Stop() {
+    if (!_running.exchange(false)) {
+        return;
+    }
+
+    shutdown(_server_socket, SHUT_RDWR);
+    _thread.join();
+    close(_server_socket);
+
+    // Follower threads notice closed backlog or broken connection and exit
+    _backlog.Close();
+    std::unique_lock<std::mutex> lock(_followers_mutex);
+    for (int socket : _follower_sockets) {
+        shutdown(socket, SHUT_RDWR);
+    }
+    _followers_closed.wait(lock, [this]() { return _follower_sockets.empty(); });
+    lock.unlock();
+
+    _storage->Stop();
+}
+
+// See Leader.h
+bool Leader::Put(const std::string &key, const std::string &value) { return Leader::Put(key, value, 0); }
+
+// See Leader.h
+bool Leader::Put(const std::string &key, const std::string &value, int32_t ttl) {
+    std::lock_guard<Metrics::ProfiledMutex> lock(Stripe(key));
+    if (!_storage->Put(key, value, ttl)) {
+        return false;
+    }
+    _backlog.Append(Backend::OpLog::PutRecord(key, value, ttl));
+    return true;
+}
+
+// See Leader.h
+bool Leader::PutIfAbsent(const std::string &key, const std::string &value) {
+    return Leader::PutIfAbsent(key, value, 0);
+}
+
+// See Leader.h
+bool Leader::PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) {
+    std::lock_guard<Metrics::ProfiledMutex> lock(Stripe(key));
+    if (!_storage->PutIfAbsent(key, value, ttl)) {
+        return false;
+    }
+    _backlog.Append(Backend::OpLog::PutRecord(key, value, ttl));
+    return true;
+}
+
+// See Leader.h
+bool Leader::Set(const std::string &key, const std::string &value) {
+    std::lock_guard<Metrics::ProfiledMutex> lock(Stripe(key));
+    if (!_storage->Set(key, value)) {
+        return false;
+    }
+    _backlog.Append(Backend::OpLog::Record{Backend::OpLog::Op::kSet, 0, key, value});
+    return true;
+}
+
+// See Leader.h
+bool Leader::Set(const std::string &key, const std::string &value, int32_t ttl) {
+    std::lock_guard<Metrics::ProfiledMutex> lock(Stripe(key));
+    if (!_storage->Set(key, value, ttl)) {
+        return false;
+    }
+    _backlog.Append(Backend::OpLog::PutRecord(key, value, ttl));
+    return true;
+}
+
+// See Leader.h
+bool Leader::Delete(const std::string &key) {
+    std::lock_guard<Metrics::ProfiledMutex> lock(Stripe(key));
+    if (!_storage->Delete(key)) {
+        return false;
+    }
+    _backlog.Append(Backend::OpLog::Record{Backend::OpLog::Op::kDelete, 0, key, std::string()});
+    return true;
+}
+
+// See Leader.h
+bool Leader::Get(const std::string &key, std::string &value) { return _storage->Get(key, value); }
+
+// See Leader.h
+bool Leader::Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) {
+    return _storage->Get(key, value, expire);
+}
+
+// See Leader.h
+void Leader::OnRun() {
+    while (_running.load()) {
+        int socket = accept4(_server_socket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (socket == -1) {
+            const int error = errno;
+            if (error != EINTR && error != ECONNABORTED && _running.load()) {
+                if (_logger) {
+                    AFINA_LOG_LIMITED(_logger, err, "Failed to accept follower: {}", std::strerror(error));
+                }
+                std::this_thread::sleep_for(kAcceptBackoff);
+            }
+            continue;
+        }
+
+        // Changes are sent as soon as they are made
+        int opts = 1;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &opts, sizeof(opts));
+
+        std::lock_guard<std::mutex> lock(_followers_mutex);
+        if (!_running.load()) {
+            close(socket);
+            break;
+        }
+        _follower_sockets.insert(socket);
+        std::thread(&Leader::OnFollower, this, socket).detach();
+    }
+}
+
+// See Leader.h
+void Leader::OnFollower(int socket) {
+    std::string line;
+    char run_id[64];
+    uint64_t offset;
+    if (read_line(socket, line, 256)) {
+        if (std::sscanf(line.c_str(), "SYNC %63s %" SCNu64, run_id, &offset) != 2) {
+            const char error[] = "-ERR expected SYNC <run id> <offset>\r\n";
+            send_all(socket, error, sizeof(error) - 1);
+        } else if (_run_id == run_id && _backlog.Keeps(offset)) {
+            std::string reply = "+CONTINUE " + _run_id + " " + std::to_string(offset) + "\r\n";
+            if (!send_all(socket, reply.data(), reply.size())) {
+                offset = UINT64_MAX;
+            }
+        } else {
+            // Changes made since that moment are in the backlog, snapshot taken afterwards could
+            // have some of them already
+            offset = _backlog.End();
+            if (!FullSync(socket, offset)) {
+                offset = UINT64_MAX;
+            }
+        }
+
+        std::string data;
+        while (offset != UINT64_MAX && _running.load() && _backlog.Read(offset, kFrameSize, data, kIdleCheck)) {
+            if (!send_all(socket, data.data(), data.size())) {
+                break;
+            }
+            offset += data.size();
+        }
+    }
+
+    // Socket is closed once Stop can't shut it down anymore, its number could be reused right away
+    {
+        std::lock_guard<std::mutex> lock(_followers_mutex);
+        _follower_sockets.erase(socket);
+        if (_follower_sockets.empty()) {
+            _followers_closed.notify_all();
+        }
+    }
+    close(socket);
+}
+
+// See Leader.h
+bool Leader::FullSync(int socket, uint64_t offset) {
+    // Reply goes along with the first frame, so that snapshot failure could still be reported
+    std::string out = "+FULLSYNC " + _run_id + " " + std::to_string(offset) + "\r\n";
+    std::string frame;
+    bool replied = false;
+    bool connected = true;
+    auto flush = [&]() {
+        const uint32_t size = frame.size();
+        out.append(reinterpret_cast<const char *>(&size), sizeof(size));
+        out.append(frame);
+        frame.clear();
+        connected = send_all(socket, out.data(), out.size());
+        out.clear();
+        replied = true;
+        return connected;
+    };
+
+    bool complete = _storage->Snapshot([&](const std::string &key, const std::string &value, int32_t ttl) {
+        Backend::OpLog::Encode(Backend::OpLog::PutRecord(key, value, ttl), frame);
+        return frame.size() < kFrameSize || flush();
+    });
+    if (!complete) {
+        if (!replied) {
+            const char error[] = "-ERR storage doesn't support snapshots\r\n";
+            send_all(socket, error, sizeof(error) - 1);
+        }
+        return false;
+    }
+
+    // Empty frame marks the end of snapshot
+    if (!frame.empty() && !flush()) {
+        return false;
+    }
+    return flush();
+}
+
+} // namespace Replication
+} // namespace Afina
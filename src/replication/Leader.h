@@ -0,0 +1,140 @@
+#ifndef AFINA_REPLICATION_LEADER_H
+#define AFINA_REPLICATION_LEADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include <afina/Storage.h>
+#include <afina/metrics/Locks.h>
+
+#include "Backlog.h"
+
+namespace Afina {
+namespace Logging {
+class AsyncLogger;
+class Service;
+} // namespace Logging
+namespace Replication {
+
+/**
+ * # Storage that streams its changes to followers
+ * Wraps storage that supports snapshots and records every successful change into the backlog,
+ * like DurableStorage does with the log. Followers connect over TCP and ask to continue from the
+ * offset they have got to:
+ *
+ *     SYNC <run id> <offset>\r\n
+ *
+ * If the leader is the same run and still keeps the offset, it answers `+CONTINUE <run id>
+ * <offset>` and streams backlog from there. Otherwise it answers `+FULLSYNC <run id> <offset>`
+ * with the current backlog end, sends storage snapshot as frames of records, each prefixed with
+ * its 32-bit size, ends them with an empty frame and then streams backlog from that offset.
+ *
+ * Changes made while the snapshot is taken are in the backlog as well, replaying them once more
+ * leads to the same state, since each record sets the key regardless of what was there before
+ */
+class Leader : public Afina::Storage {
+public:
+    /**
+     * @param storage to wrap, must be thread safe
+     * @param port to accept followers on, 0 to pick any free one
+     * @param backlog_size number of bytes of recent changes kept for followers to catch up
+     * @param logging service to report failures to, may be null
+     */
+    Leader(std::shared_ptr<Afina::Storage> storage, uint16_t port, std::size_t backlog_size = 64 << 20,
+           std::shared_ptr<Afina::Logging::Service> logging = nullptr);
+    ~Leader();
+
+    // Starts wrapped storage and begins to accept followers
+    void Start() override;
+
+    // Disconnects followers and stops wrapped storage
+    void Stop() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override;
+
+    // Snapshot of the wrapped storage
+    bool Snapshot(const SnapshotWriter &writer) override { return _storage->Snapshot(writer); }
+
+    // Statistics of the wrapped storage
+    void Stats(const std::string &group, const StatWriter &writer) override { _storage->Stats(group, writer); }
+
+    // Gauges of the wrapped storage
+    const Metrics::StorageGauges *Gauges() const override { return _storage->Gauges(); }
+
+    // Port followers are accepted on, known once leader is started
+    uint16_t Port() const { return _port; }
+
+    // Identifier of this leader run, offsets of other runs mean nothing to it
+    const std::string &RunId() const { return _run_id; }
+
+private:
+    static const std::size_t kStripes = 64;
+
+    Metrics::ProfiledMutex &Stripe(const std::string &key) {
+        return *_stripes[std::hash<std::string>()(key) % kStripes];
+    }
+
+    // Accepts followers, runs in its own thread
+    void OnRun();
+
+    // Serves follower connected to the socket, runs in its own thread
+    void OnFollower(int socket);
+
+    // Sends snapshot to the follower, returns false if connection is broken
+    bool FullSync(int socket, uint64_t offset);
+
+    std::shared_ptr<Afina::Storage> _storage;
+    std::shared_ptr<Afina::Logging::Service> _logging;
+    std::shared_ptr<Afina::Logging::AsyncLogger> _logger;
+    Backlog _backlog;
+    std::string _run_id;
+
+    uint16_t _port;
+    int _server_socket;
+    std::atomic<bool> _running;
+    std::thread _thread;
+
+    // Sockets of connected followers, each served by its own thread
+    std::mutex _followers_mutex;
+    std::set<int> _follower_sockets;
+    std::condition_variable _followers_closed;
+
+    // Keep order of changes of a key the same in storage and in the backlog, profiled as "leader"
+    std::unique_ptr<Metrics::ProfiledMutex> _stripes[kStripes];
+};
+
+} // namespace Replication
+} // namespace Afina
+
+#endif // AFINA_REPLICATION_LEADER_H
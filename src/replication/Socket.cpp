@@ -0,0 +1,61 @@
+#include "Socket.h"
+
+#include <cerrno>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+namespace Afina {
+namespace Replication {
+
+// See Socket.h
+bool send_all(int socket, const char *data, std::size_t size) {
+    while (size > 0) {
+        // Peer could go away any moment, that must not kill the process with SIGPIPE
+        ssize_t n = send(socket, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+// See Socket.h
+bool read_line(int socket, std::string &line, std::size_t max_size) {
+    line.clear();
+    char c;
+    while (line.size() <= max_size) {
+        if (!read_all(socket, &c, 1)) {
+            return false;
+        } else if (c == '\n') {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            return true;
+        }
+        line.push_back(c);
+    }
+    return false;
+}
+
+// See Socket.h
+bool read_all(int socket, char *data, std::size_t size) {
+    while (size > 0) {
+        ssize_t n = recv(socket, data, size, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+} // namespace Replication
+} // namespace Afina
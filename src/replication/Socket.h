@@ -0,0 +1,29 @@
+#ifndef AFINA_REPLICATION_SOCKET_H
+#define AFINA_REPLICATION_SOCKET_H
+
+#include <cstddef>
+#include <string>
+
+namespace Afina {
+namespace Replication {
+
+/**
+ * Sends all the data, returns false if connection is broken
+ */
+bool send_all(int socket, const char *data, std::size_t size);
+
+/**
+ * Reads line terminated by \r\n without the terminator. Reads byte by byte, so that nothing
+ * after the line is consumed. Returns false if connection is broken or line is longer than max_size
+ */
+bool read_line(int socket, std::string &line, std::size_t max_size);
+
+/**
+ * Reads exactly size bytes, returns false if connection is broken before
+ */
+bool read_all(int socket, char *data, std::size_t size);
+
+} // namespace Replication
+} // namespace Afina
+
+#endif // AFINA_REPLICATION_SOCKET_H
@@ -0,0 +1,274 @@
+#include "ARC.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <afina/metrics/Probes.h>
+
+namespace Afina {
+namespace Backend {
+
+ARC::ARC(size_t max_size)
+    : _max_size(max_size), _target(0), _t1_size(0), _t2_size(0), _b1_size(0), _b2_size(0), _evictions(0) {
+    _gauges.limit_maxbytes.Set(max_size);
+}
+
+// See ARC.h
+bool ARC::Put(const std::string &key, const std::string &value) { return ARC::Put(key, value, 0); }
+
+// See ARC.h
+bool ARC::Put(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    node_list::iterator it;
+    if (Lookup(key, it)) {
+        Update(it, value, Deadline(ttl));
+    } else {
+        Insert(key, value, Deadline(ttl));
+    }
+    return true;
+}
+
+// See ARC.h
+bool ARC::PutIfAbsent(const std::string &key, const std::string &value) { return ARC::PutIfAbsent(key, value, 0); }
+
+// See ARC.h
+bool ARC::PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    node_list::iterator it;
+    if (Lookup(key, it)) {
+        return false;
+    }
+    Insert(key, value, Deadline(ttl));
+    return true;
+}
+
+// See ARC.h
+bool ARC::Set(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    node_list::iterator it;
+    if (!Lookup(key, it)) {
+        return false;
+    }
+    Update(it, value, it->expire);
+    return true;
+}
+
+// See ARC.h
+bool ARC::Set(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    node_list::iterator it;
+    if (!Lookup(key, it)) {
+        return false;
+    }
+    Update(it, value, Deadline(ttl));
+    return true;
+}
+
+// See ARC.h
+bool ARC::Delete(const std::string &key) {
+    node_list::iterator it;
+    if (!Lookup(key, it)) {
+        return false;
+    }
+    Remove(it);
+    return true;
+}
+
+// See ARC.h
+bool ARC::Get(const std::string &key, std::string &value) {
+    clock::time_point expire;
+    return ARC::Get(key, value, expire);
+}
+
+// See ARC.h
+bool ARC::Get(const std::string &key, std::string &value, clock::time_point &expire) {
+    node_list::iterator it;
+    if (!Lookup(key, it)) {
+        AFINA_PROBE3(storage_get, key.size(), 0, false);
+        return false;
+    }
+    value = it->value;
+    expire = it->expire;
+    Touch(it);
+    AFINA_PROBE3(storage_get, key.size(), value.size(), true);
+    return true;
+}
+
+// See ARC.h
+void ARC::Stats(const std::string &group, const StatWriter &writer) {
+    if (group.empty()) {
+        writer("curr_items", _index.size());
+        writer("bytes", _t1_size + _t2_size);
+        writer("limit_maxbytes", _max_size);
+        writer("evictions", _evictions);
+    }
+}
+
+// See ARC.h
+bool ARC::Lookup(const std::string &key, node_list::iterator &it) {
+    auto index_it = _index.find(key);
+    if (index_it == _index.end()) {
+        return false;
+    }
+
+    it = index_it->second;
+    if (it->expire != clock::time_point::max() && it->expire <= clock::now()) {
+        Remove(it);
+        return false;
+    }
+    return true;
+}
+
+// See ARC.h
+void ARC::Insert(const std::string &key, const std::string &value, clock::time_point expire) {
+    AFINA_PROBE2(storage_put, key.size(), value.size());
+    const std::size_t item_size = key.size() + value.size();
+    auto ghost_it = _ghosts.find(key_hash()(key));
+    if (ghost_it == _ghosts.end()) {
+        _t1.push_front(node{key, value, expire, false});
+        _index.emplace(_t1.front().key, _t1.begin());
+        _t1_size += item_size;
+        Replace(&_t1.front(), false);
+        return;
+    }
+
+    // Key came back after eviction: the list it was evicted from deserves more space. Step is
+    // larger when the other ghost list is larger, as hits there are proportionally more likely
+    bool b2_hit = ghost_it->second->frequent;
+    if (!b2_hit) {
+        std::size_t delta = _b2_size > _b1_size ? item_size * _b2_size / _b1_size : item_size;
+        _target = std::min(_max_size, _target + delta);
+    } else {
+        std::size_t delta = _b1_size > _b2_size ? item_size * _b1_size / _b2_size : item_size;
+        _target = _target > delta ? _target - delta : 0;
+    }
+    Forget(ghost_it->second);
+
+    _t2.push_front(node{key, value, expire, true});
+    _index.emplace(_t2.front().key, _t2.begin());
+    _t2_size += item_size;
+    Replace(&_t2.front(), b2_hit);
+}
+
+// See ARC.h
+void ARC::Update(node_list::iterator it, const std::string &value, clock::time_point expire) {
+    AFINA_PROBE2(storage_put, it->key.size(), value.size());
+    std::size_t &size = it->frequent ? _t2_size : _t1_size;
+    size = size - it->value.size() + value.size();
+    it->value = value;
+    it->expire = expire;
+    Touch(it);
+    Replace(&*it, false);
+}
+
+// See ARC.h
+void ARC::Touch(node_list::iterator it) {
+    if (it->frequent) {
+        _t2.splice(_t2.begin(), _t2, it);
+        return;
+    }
+
+    // Second access moves item from recency list into frequency one
+    std::size_t item_size = it->key.size() + it->value.size();
+    _t2.splice(_t2.begin(), _t1, it);
+    it->frequent = true;
+    _t1_size -= item_size;
+    _t2_size += item_size;
+}
+
+// See ARC.h
+void ARC::Remove(node_list::iterator it) {
+    _index.erase(it->key);
+    if (it->frequent) {
+        _t2_size -= it->key.size() + it->value.size();
+        _t2.erase(it);
+    } else {
+        _t1_size -= it->key.size() + it->value.size();
+        _t1.erase(it);
+    }
+    Publish();
+}
+
+// See ARC.h
+void ARC::Replace(const node *fresh, bool b2_hit) {
+    const std::size_t fresh_size = fresh != nullptr ? fresh->key.size() + fresh->value.size() : 0;
+    while (_t1_size + _t2_size > _max_size) {
+        // Target is compared with T1 as it was before the fresh node came in
+        const std::size_t t1_size = (fresh != nullptr && !fresh->frequent) ? _t1_size - fresh_size : _t1_size;
+        const bool t1_victim = !_t1.empty() && &_t1.back() != fresh;
+        const bool t2_victim = !_t2.empty() && &_t2.back() != fresh;
+        if (t1_victim && (!t2_victim || t1_size > _target || (b2_hit && t1_size == _target))) {
+            Demote(std::prev(_t1.end()));
+        } else if (t2_victim) {
+            Demote(std::prev(_t2.end()));
+        } else {
+            break;
+        }
+    }
+    TrimGhosts();
+    Publish();
+}
+
+// See ARC.h
+void ARC::Publish() { _gauges.Publish(_index.size(), _t1_size + _t2_size, _evictions); }
+
+// See ARC.h
+void ARC::Demote(node_list::iterator it) {
+    // Expired item was not pushed out by the policy, nothing to learn from its return
+    if (it->expire <= clock::now()) {
+        Remove(it);
+        return;
+    }
+
+    const uint64_t hash = key_hash()(it->key);
+    auto ghost_it = _ghosts.find(hash);
+    if (ghost_it != _ghosts.end()) {
+        Forget(ghost_it->second);
+    }
+
+    const std::size_t item_size = it->key.size() + it->value.size();
+    AFINA_PROBE2(storage_evict, it->key.size(), it->value.size());
+    ghost_list &ghosts = it->frequent ? _b2 : _b1;
+    ghosts.push_front(ghost{hash, item_size, it->frequent});
+    _ghosts.emplace(hash, ghosts.begin());
+    (it->frequent ? _b2_size : _b1_size) += item_size;
+    Remove(it);
+    _evictions++;
+}
+
+// See ARC.h
+void ARC::TrimGhosts() {
+    while (_t1_size + _b1_size > _max_size && !_b1.empty()) {
+        Forget(std::prev(_b1.end()));
+    }
+    while (_t1_size + _t2_size + _b1_size + _b2_size > 2 * _max_size && !_b2.empty()) {
+        Forget(std::prev(_b2.end()));
+    }
+}
+
+// See ARC.h
+void ARC::Forget(ghost_list::iterator it) {
+    _ghosts.erase(it->hash);
+    if (it->frequent) {
+        _b2_size -= it->size;
+        _b2.erase(it);
+    } else {
+        _b1_size -= it->size;
+        _b1.erase(it);
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
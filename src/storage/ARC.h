@@ -0,0 +1,169 @@
+#ifndef AFINA_STORAGE_ARC_H
+#define AFINA_STORAGE_ARC_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include <afina/Storage.h>
+#include <afina/metrics/StorageGauges.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Adaptive replacement cache
+ * That is NOT thread safe implementaiton!!
+ *
+ * Resident items are kept in two LRU lists: T1 holds items seen once recently, T2 holds items
+ * seen at least twice. Keys evicted from T1 and T2 are remembered in ghost lists B1 and B2 along
+ * with their sizes, ghosts hold no values.
+ *
+ * Cache keeps a target size of T1 and evicts from T1 while it is above the target, from T2
+ * otherwise. Write of a key found in B1 means T1 was too small, so the target grows; key found in
+ * B2 shrinks it. That way cache drifts between LRU and LFU-like behaviour following the workload.
+ *
+ * Everything, including the target and ghost lists, is accounted in bytes of keys and values
+ * rather than in items, so a few large items don't push out lots of small ones unnoticed
+ */
+class ARC : public Afina::Storage {
+public:
+    ARC(size_t max_size = 1024);
+    ~ARC() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override;
+
+    // Implements Afina::Storage interface
+    void Stats(const std::string &group, const StatWriter &writer) override;
+
+    // Implements Afina::Storage interface
+    const Metrics::StorageGauges *Gauges() const override { return &_gauges; }
+
+    // Current target size of T1 in bytes
+    std::size_t Target() const { return _target; }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    // Resident item, lists are ordered from the most recently used to the least one
+    struct node {
+        std::string key;
+        std::string value;
+
+        // Time point after which node is expired, time_point::max() if node never expires
+        clock::time_point expire;
+
+        // True if node is in T2
+        bool frequent;
+    };
+    using node_list = std::list<node>;
+
+    // Evicted key, only its hash and size are remembered
+    struct ghost {
+        uint64_t hash;
+        std::size_t size;
+
+        // True if ghost is in B2
+        bool frequent;
+    };
+    using ghost_list = std::list<ghost>;
+
+    // Index keys point into nodes, so every key is stored once
+    using key_ref = std::reference_wrapper<const std::string>;
+    struct key_hash {
+        std::size_t operator()(const std::string &key) const { return std::hash<std::string>()(key); }
+    };
+
+    // Finds live node for the key, expired node is removed
+    bool Lookup(const std::string &key, node_list::iterator &it);
+
+    // Places new node into T1, or into T2 if its key is a ghost. Ghost hit adapts the target
+    void Insert(const std::string &key, const std::string &value, clock::time_point expire);
+
+    // Replaces value and expiration time of existing node, counts as an access
+    void Update(node_list::iterator it, const std::string &value, clock::time_point expire);
+
+    // Moves node to the head of T2
+    void Touch(node_list::iterator it);
+
+    // Removes node from list and index, without leaving a ghost
+    void Remove(node_list::iterator it);
+
+    // Moves least recently used nodes, other than the fresh one, into ghost lists until cache fits
+    // into _max_size. Ties between T1 size and the target are resolved in favour of T2 after B2 hit
+    void Replace(const node *fresh, bool b2_hit);
+
+    // Sets gauges to the current state, called on every change
+    void Publish();
+
+    // Turns node into ghost of B1 or B2 depending on the list it was in
+    void Demote(node_list::iterator it);
+
+    // Drops oldest ghosts so that T1 + B1 and the whole directory are within 1x and 2x _max_size
+    void TrimGhosts();
+
+    // Removes ghost from list and index
+    void Forget(ghost_list::iterator it);
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be less the _max_size
+    const std::size_t _max_size;
+
+    // Adaptive target size of T1, between 0 and _max_size
+    std::size_t _target;
+
+    node_list _t1;
+    node_list _t2;
+    std::size_t _t1_size;
+    std::size_t _t2_size;
+
+    ghost_list _b1;
+    ghost_list _b2;
+    std::size_t _b1_size;
+    std::size_t _b2_size;
+
+    // Number of live items demoted to ghosts
+    uint64_t _evictions;
+
+    // Occupancy for the exporter
+    Metrics::StorageGauges _gauges;
+
+    // Index of resident nodes
+    std::unordered_map<key_ref, node_list::iterator, key_hash, std::equal_to<std::string>> _index;
+
+    // Index of ghosts by key hash
+    std::unordered_map<uint64_t, ghost_list::iterator> _ghosts;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_ARC_H
@@ -0,0 +1,218 @@
+#include "ClockCache.h"
+
+#include <afina/metrics/Probes.h>
+
+namespace Afina {
+namespace Backend {
+
+ClockCache::ClockCache(size_t max_size)
+    : _max_size(max_size), _size(0), _lock("storage"), _hand(0), _evictions(0) {
+    _gauges.limit_maxbytes.Set(max_size);
+}
+
+// See ClockCache.h
+bool ClockCache::Put(const std::string &key, const std::string &value) { return ClockCache::Put(key, value, 0); }
+
+// See ClockCache.h
+bool ClockCache::Put(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    Metrics::ProfiledRWLock::WriteGuard guard(_lock);
+    entry *item = Lookup(key);
+    if (item != nullptr) {
+        Update(*item, value, Deadline(ttl));
+    } else {
+        Insert(key, value, Deadline(ttl));
+    }
+    return true;
+}
+
+// See ClockCache.h
+bool ClockCache::PutIfAbsent(const std::string &key, const std::string &value) {
+    return ClockCache::PutIfAbsent(key, value, 0);
+}
+
+// See ClockCache.h
+bool ClockCache::PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    Metrics::ProfiledRWLock::WriteGuard guard(_lock);
+    if (Lookup(key) != nullptr) {
+        return false;
+    }
+    Insert(key, value, Deadline(ttl));
+    return true;
+}
+
+// See ClockCache.h
+bool ClockCache::Set(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    Metrics::ProfiledRWLock::WriteGuard guard(_lock);
+    entry *item = Lookup(key);
+    if (item == nullptr) {
+        return false;
+    }
+    Update(*item, value, item->expire);
+    return true;
+}
+
+// See ClockCache.h
+bool ClockCache::Set(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    Metrics::ProfiledRWLock::WriteGuard guard(_lock);
+    entry *item = Lookup(key);
+    if (item == nullptr) {
+        return false;
+    }
+    Update(*item, value, Deadline(ttl));
+    return true;
+}
+
+// See ClockCache.h
+bool ClockCache::Delete(const std::string &key) {
+    Metrics::ProfiledRWLock::WriteGuard guard(_lock);
+    if (Lookup(key) == nullptr) {
+        return false;
+    }
+    Remove(_index.find(key)->second);
+    return true;
+}
+
+// See ClockCache.h
+bool ClockCache::Get(const std::string &key, std::string &value) {
+    clock::time_point expire;
+    return ClockCache::Get(key, value, expire);
+}
+
+// See ClockCache.h
+bool ClockCache::Get(const std::string &key, std::string &value, clock::time_point &expire) {
+    Metrics::ProfiledRWLock::ReadGuard guard(_lock);
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        AFINA_PROBE3(storage_get, key.size(), 0, false);
+        return false;
+    }
+
+    // Expired item is left for writers and the clock hand, readers don't modify cache structure
+    entry &item = *_ring[it->second];
+    if (item.expire != clock::time_point::max() && item.expire <= clock::now()) {
+        AFINA_PROBE3(storage_get, key.size(), 0, false);
+        return false;
+    }
+
+    // Avoid writing shared cache line if bit is already set, that is the common case for hot keys
+    if (!item.referenced.load(std::memory_order_relaxed)) {
+        item.referenced.store(true, std::memory_order_relaxed);
+    }
+    value = item.value;
+    expire = item.expire;
+    AFINA_PROBE3(storage_get, key.size(), value.size(), true);
+    return true;
+}
+
+// See ClockCache.h
+void ClockCache::Stats(const std::string &group, const StatWriter &writer) {
+    if (group.empty()) {
+        Metrics::ProfiledRWLock::ReadGuard guard(_lock);
+        writer("curr_items", _index.size());
+        writer("bytes", _size);
+        writer("limit_maxbytes", _max_size);
+        writer("evictions", _evictions);
+    }
+}
+
+// See ClockCache.h
+ClockCache::entry *ClockCache::Lookup(const std::string &key) {
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        return nullptr;
+    }
+
+    entry *item = _ring[it->second].get();
+    if (item->expire != clock::time_point::max() && item->expire <= clock::now()) {
+        Remove(it->second);
+        return nullptr;
+    }
+    return item;
+}
+
+// See ClockCache.h
+void ClockCache::Insert(const std::string &key, const std::string &value, clock::time_point expire) {
+    AFINA_PROBE2(storage_put, key.size(), value.size());
+    std::size_t slot;
+    if (!_free_slots.empty()) {
+        slot = _free_slots.back();
+        _free_slots.pop_back();
+    } else {
+        slot = _ring.size();
+        _ring.emplace_back();
+    }
+
+    // New item starts unreferenced, so that one-time keys leave on the first pass of the hand
+    _ring[slot].reset(new entry{key, value, expire, {false}});
+    _index.emplace(_ring[slot]->key, slot);
+    _size += key.size() + value.size();
+    Evict(slot);
+}
+
+// See ClockCache.h
+void ClockCache::Update(entry &item, const std::string &value, clock::time_point expire) {
+    AFINA_PROBE2(storage_put, item.key.size(), value.size());
+    _size = _size - item.value.size() + value.size();
+    item.value = value;
+    item.expire = expire;
+    item.referenced.store(true, std::memory_order_relaxed);
+    Evict(_ring.size());
+}
+
+// See ClockCache.h
+void ClockCache::Remove(std::size_t slot) {
+    std::unique_ptr<entry> &item = _ring[slot];
+    _index.erase(item->key);
+    _size -= item->key.size() + item->value.size();
+    item.reset();
+    _free_slots.push_back(slot);
+    Publish();
+}
+
+// See ClockCache.h
+void ClockCache::Evict(std::size_t keep) {
+    // Each referenced item loses its bit on the first visit, so two full turns are always enough
+    const clock::time_point now = clock::now();
+    while (_size > _max_size) {
+        if (_hand >= _ring.size()) {
+            _hand = 0;
+        }
+
+        std::unique_ptr<entry> &item = _ring[_hand];
+        if (item && _hand != keep) {
+            if (item->expire <= now) {
+                Remove(_hand);
+            } else if (item->referenced.load(std::memory_order_relaxed)) {
+                item->referenced.store(false, std::memory_order_relaxed);
+            } else {
+                AFINA_PROBE2(storage_evict, item->key.size(), item->value.size());
+                Remove(_hand);
+                _evictions++;
+            }
+        }
+        _hand++;
+    }
+    Publish();
+}
+
+// See ClockCache.h
+void ClockCache::Publish() { _gauges.Publish(_index.size(), _size, _evictions); }
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,139 @@
+#ifndef AFINA_STORAGE_CLOCK_CACHE_H
+#define AFINA_STORAGE_CLOCK_CACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/metrics/Locks.h>
+#include <afina/metrics/StorageGauges.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # CLOCK (second chance) cache, thread safe
+ * Items are placed into slots of a ring, hit only sets reference bit of the item. Once cache is
+ * full the clock hand walks the ring: referenced items get their bit cleared and a second chance,
+ * the first unreferenced one is evicted. Expired items are evicted by the hand right away.
+ *
+ * As reads never touch ring or index, Get runs under the shared side of rw-lock and many readers
+ * proceed in parallel; only writes take exclusive lock. The lock is profiled under the name "storage",
+ * see `stats locks`
+ */
+class ClockCache : public Afina::Storage {
+public:
+    ClockCache(size_t max_size = 1024);
+    ~ClockCache() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override;
+
+    // Implements Afina::Storage interface
+    void Stats(const std::string &group, const StatWriter &writer) override;
+
+    // Implements Afina::Storage interface
+    const Metrics::StorageGauges *Gauges() const override { return &_gauges; }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    // Cache item, lives in a ring slot
+    struct entry {
+        std::string key;
+        std::string value;
+
+        // Time point after which item is expired, time_point::max() if item never expires
+        clock::time_point expire;
+
+        // Set by readers on hit, cleared by the clock hand
+        std::atomic<bool> referenced;
+    };
+
+    // Index keys point into entries, so every key is stored once
+    using key_ref = std::reference_wrapper<const std::string>;
+    struct key_hash {
+        std::size_t operator()(const std::string &key) const { return std::hash<std::string>()(key); }
+    };
+
+    // Finds live item for the key, exclusive lock must be held. Expired item is removed
+    entry *Lookup(const std::string &key);
+
+    // Stores item into a free slot and evicts others if cache overflows
+    void Insert(const std::string &key, const std::string &value, clock::time_point expire);
+
+    // Replaces value and expiration time of existing item
+    void Update(entry &item, const std::string &value, clock::time_point expire);
+
+    // Removes item in the given slot
+    void Remove(std::size_t slot);
+
+    // Moves clock hand until cache fits into _max_size, item in the keep slot is never evicted
+    void Evict(std::size_t keep);
+
+    // Sets gauges to the current state, called on every change
+    void Publish();
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be less the _max_size
+    const std::size_t _max_size;
+
+    // Number of bytes currently stored in the cache
+    std::size_t _size;
+
+    // Readers take it shared, writers exclusive
+    Metrics::ProfiledRWLock _lock;
+
+    // Ring of slots, nullptr marks free one
+    std::vector<std::unique_ptr<entry>> _ring;
+
+    // Free slots in the ring to be reused before ring grows
+    std::vector<std::size_t> _free_slots;
+
+    // Position of the clock hand in the ring
+    std::size_t _hand;
+
+    // Number of live items evicted, guarded by exclusive lock
+    uint64_t _evictions;
+
+    // Occupancy for the exporter
+    Metrics::StorageGauges _gauges;
+
+    // Index of ring slots by item key
+    std::unordered_map<key_ref, std::size_t, key_hash, std::equal_to<std::string>> _index;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_CLOCK_CACHE_H
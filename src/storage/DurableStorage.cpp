@@ -0,0 +1,103 @@
+#include "DurableStorage.h"
+
+namespace Afina {
+namespace Backend {
+
+DurableStorage::DurableStorage(std::shared_ptr<Afina::Storage> storage, std::unique_ptr<OpLog> log)
+    : _storage(storage), _log(std::move(log)) {
+    for (auto &stripe : _stripes) {
+        stripe.reset(new Metrics::ProfiledMutex("durable_storage"));
+    }
+}
+
+// See DurableStorage.h
+void DurableStorage::Start() {
+    _storage->Start();
+    _log->Replay([this](const OpLog::Record &record) { OpLog::Apply(*_storage, record); });
+    _log->Start();
+}
+
+// See DurableStorage.h
+void DurableStorage::Stop() {
+    _log->Stop();
+    _storage->Stop();
+}
+
+// See DurableStorage.h
+bool DurableStorage::Put(const std::string &key, const std::string &value) {
+    return DurableStorage::Put(key, value, 0);
+}
+
+// See DurableStorage.h
+bool DurableStorage::Put(const std::string &key, const std::string &value, int32_t ttl) {
+    std::lock_guard<Metrics::ProfiledMutex> lock(Stripe(key));
+    if (!_storage->Put(key, value, ttl)) {
+        return false;
+    }
+    _log->Append(OpLog::PutRecord(key, value, ttl));
+    return true;
+}
+
+// See DurableStorage.h
+bool DurableStorage::PutIfAbsent(const std::string &key, const std::string &value) {
+    return DurableStorage::PutIfAbsent(key, value, 0);
+}
+
+// See DurableStorage.h
+bool DurableStorage::PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) {
+    std::lock_guard<Metrics::ProfiledMutex> lock(Stripe(key));
+    if (!_storage->PutIfAbsent(key, value, ttl)) {
+        return false;
+    }
+    _log->Append(OpLog::PutRecord(key, value, ttl));
+    return true;
+}
+
+// See DurableStorage.h
+bool DurableStorage::Set(const std::string &key, const std::string &value) {
+    std::lock_guard<Metrics::ProfiledMutex> lock(Stripe(key));
+    if (!_storage->Set(key, value)) {
+        return false;
+    }
+    _log->Append(OpLog::Record{OpLog::Op::kSet, 0, key, value});
+    return true;
+}
+
+// See DurableStorage.h
+bool DurableStorage::Set(const std::string &key, const std::string &value, int32_t ttl) {
+    std::lock_guard<Metrics::ProfiledMutex> lock(Stripe(key));
+    if (!_storage->Set(key, value, ttl)) {
+        return false;
+    }
+    _log->Append(OpLog::PutRecord(key, value, ttl));
+    return true;
+}
+
+// See DurableStorage.h
+bool DurableStorage::Delete(const std::string &key) {
+    std::lock_guard<Metrics::ProfiledMutex> lock(Stripe(key));
+    if (!_storage->Delete(key)) {
+        return false;
+    }
+    _log->Append(OpLog::Record{OpLog::Op::kDelete, 0, key, std::string()});
+    return true;
+}
+
+// See DurableStorage.h
+bool DurableStorage::Get(const std::string &key, std::string &value) { return _storage->Get(key, value); }
+
+// See DurableStorage.h
+bool DurableStorage::Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) {
+    return _storage->Get(key, value, expire);
+}
+
+// See DurableStorage.h
+void DurableStorage::Stats(const std::string &group, const StatWriter &writer) {
+    _storage->Stats(group, writer);
+    if (group.empty()) {
+        _log->Stats(writer);
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,93 @@
+#ifndef AFINA_STORAGE_DURABLE_STORAGE_H
+#define AFINA_STORAGE_DURABLE_STORAGE_H
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <afina/Storage.h>
+#include <afina/metrics/Locks.h>
+
+#include "OpLog.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Storage that survives restarts and crashes
+ * Wraps any storage and records every successful change into OpLog, on start storage is filled
+ * back by the log replay. Thread safety is the one of the wrapped storage.
+ *
+ * Change and its record are made under the lock of the key stripe, so that records of the same
+ * key are in the log in the same order changes were applied. Changes of different keys proceed in
+ * parallel, and none of them waits for disk
+ */
+class DurableStorage : public Afina::Storage {
+public:
+    DurableStorage(std::shared_ptr<Afina::Storage> storage, std::unique_ptr<OpLog> log);
+    ~DurableStorage() {}
+
+    // Starts wrapped storage and fills it from the log
+    void Start() override;
+
+    // Syncs the log and stops wrapped storage
+    void Stop() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override;
+
+    // Snapshot of the wrapped storage
+    bool Snapshot(const SnapshotWriter &writer) override { return _storage->Snapshot(writer); }
+
+    // Statistics of the wrapped storage along with the log state
+    void Stats(const std::string &group, const StatWriter &writer) override;
+
+    // Gauges of the wrapped storage
+    const Metrics::StorageGauges *Gauges() const override { return _storage->Gauges(); }
+
+    // Waits until all changes made so far are on disk, false if the log failed
+    bool Sync() { return _log->Sync(); }
+
+private:
+    static const std::size_t kStripes = 64;
+
+    Metrics::ProfiledMutex &Stripe(const std::string &key) {
+        return *_stripes[std::hash<std::string>()(key) % kStripes];
+    }
+
+    std::shared_ptr<Afina::Storage> _storage;
+    std::unique_ptr<OpLog> _log;
+
+    // Keep order of changes of a key the same in storage and in the log, profiled as "durable_storage"
+    std::unique_ptr<Metrics::ProfiledMutex> _stripes[kStripes];
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_DURABLE_STORAGE_H
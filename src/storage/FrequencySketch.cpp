@@ -0,0 +1,70 @@
+#include "FrequencySketch.h"
+
+namespace Afina {
+namespace Backend {
+
+// Seeds to get independent index for each row out of a single key hash
+static const uint64_t kRowSeeds[] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL,
+                                     0xcbf29ce484222325ULL};
+
+FrequencySketch::FrequencySketch(std::size_t width) : _additions(0) {
+    std::size_t rounded = 16;
+    while (rounded < width) {
+        rounded <<= 1;
+    }
+
+    _mask = rounded - 1;
+    _table.assign(kDepth * rounded / 16, 0);
+    _sample_size = 10 * rounded;
+}
+
+// See FrequencySketch.h
+void FrequencySketch::Increment(uint64_t hash) {
+    bool added = false;
+    for (int row = 0; row < kDepth; row++) {
+        std::size_t index = Index(hash, row);
+        uint64_t &word = _table[index / 16];
+        int shift = (index % 16) * 4;
+        if (((word >> shift) & 0xf) < 0xf) {
+            word += uint64_t(1) << shift;
+            added = true;
+        }
+    }
+
+    if (added && ++_additions >= _sample_size) {
+        Age();
+    }
+}
+
+// See FrequencySketch.h
+unsigned FrequencySketch::Estimate(uint64_t hash) const {
+    unsigned result = 0xf;
+    for (int row = 0; row < kDepth; row++) {
+        std::size_t index = Index(hash, row);
+        unsigned counter = (_table[index / 16] >> ((index % 16) * 4)) & 0xf;
+        if (counter < result) {
+            result = counter;
+        }
+    }
+    return result;
+}
+
+// See FrequencySketch.h
+std::size_t FrequencySketch::Index(uint64_t hash, int row) const {
+    // Multiply-shift hashing, high bits of the product are the best mixed ones
+    uint64_t h = (hash + kRowSeeds[row]) * kRowSeeds[(row + 1) % kDepth];
+    h ^= h >> 32;
+    return (row * (_mask + 1)) + (h & _mask);
+}
+
+// See FrequencySketch.h
+void FrequencySketch::Age() {
+    // Shift whole word at once, mask drops bits that moved into the neighbour counter
+    for (uint64_t &word : _table) {
+        word = (word >> 1) & 0x7777777777777777ULL;
+    }
+    _additions /= 2;
+}
+
+} // namespace Backend
+} // namespace Afina
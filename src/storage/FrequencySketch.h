@@ -0,0 +1,61 @@
+#ifndef AFINA_STORAGE_FREQUENCY_SKETCH_H
+#define AFINA_STORAGE_FREQUENCY_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Count-min sketch of 4-bit counters
+ * Approximates how often each key was seen recently, overestimating but never underestimating it.
+ * Each key maps to one counter in each of 4 rows, estimation is the minimum of them. Counters
+ * saturate at 15, which is plenty to tell hot keys from cold ones.
+ *
+ * Once number of increments reaches 10 times width of the sketch all counters are halved, so old
+ * history fades away and sketch adapts to workload changes
+ */
+class FrequencySketch {
+public:
+    /**
+     * @param width number of counters in each row, rounded up to power of two. Should be close to
+     * the number of items cache holds
+     */
+    FrequencySketch(std::size_t width);
+
+    /**
+     * Records one more access to the key with given hash
+     */
+    void Increment(uint64_t hash);
+
+    /**
+     * Returns estimated number of recent accesses to the key with given hash
+     */
+    unsigned Estimate(uint64_t hash) const;
+
+private:
+    static constexpr int kDepth = 4;
+
+    // Index of counter for the given row
+    std::size_t Index(uint64_t hash, int row) const;
+
+    // Halves all counters
+    void Age();
+
+    // Counters of all rows, 16 counters packed into each word
+    std::vector<uint64_t> _table;
+
+    // Row width minus one, width is power of two
+    std::size_t _mask;
+
+    // Number of increments since the last aging and the limit for it
+    std::size_t _additions;
+    std::size_t _sample_size;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FREQUENCY_SKETCH_H
@@ -0,0 +1,178 @@
+#include "HotReplicas.h"
+
+#include <vector>
+
+#include <afina/metrics/HotKeys.h>
+
+namespace Afina {
+namespace Backend {
+
+const std::size_t HotReplicas::kStamps;
+const uint32_t HotReplicas::kTouchHits;
+
+HotReplicas::HotReplicas(std::shared_ptr<Afina::Storage> storage, std::size_t keys)
+    : _storage(storage), _keys(keys), _hot(0), _running(false) {
+    for (Stamp &stamp : _stamps) {
+        stamp.value.store(0);
+    }
+}
+
+HotReplicas::~HotReplicas() { Stop(); }
+
+// See HotReplicas.h
+void HotReplicas::Start() {
+    _storage->Start();
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_running) {
+        _running = true;
+        _refresher = std::thread(&HotReplicas::OnRun, this);
+    }
+}
+
+// See HotReplicas.h
+void HotReplicas::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running) {
+            return;
+        }
+        _running = false;
+    }
+    _wakeup.notify_all();
+    _refresher.join();
+    _storage->Stop();
+}
+
+// See HotReplicas.h
+bool HotReplicas::Put(const std::string &key, const std::string &value) { return HotReplicas::Put(key, value, 0); }
+
+// See HotReplicas.h
+bool HotReplicas::Put(const std::string &key, const std::string &value, int32_t ttl) {
+    bool result = _storage->Put(key, value, ttl);
+    Written(key);
+    return result;
+}
+
+// See HotReplicas.h
+bool HotReplicas::PutIfAbsent(const std::string &key, const std::string &value) {
+    return HotReplicas::PutIfAbsent(key, value, 0);
+}
+
+// See HotReplicas.h
+bool HotReplicas::PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) {
+    bool result = _storage->PutIfAbsent(key, value, ttl);
+    Written(key);
+    return result;
+}
+
+// See HotReplicas.h
+bool HotReplicas::Set(const std::string &key, const std::string &value) {
+    bool result = _storage->Set(key, value);
+    Written(key);
+    return result;
+}
+
+// See HotReplicas.h
+bool HotReplicas::Set(const std::string &key, const std::string &value, int32_t ttl) {
+    bool result = _storage->Set(key, value, ttl);
+    Written(key);
+    return result;
+}
+
+// See HotReplicas.h
+bool HotReplicas::Delete(const std::string &key) {
+    bool result = _storage->Delete(key);
+    Written(key);
+    return result;
+}
+
+// See HotReplicas.h
+bool HotReplicas::Get(const std::string &key, std::string &value) {
+    std::chrono::steady_clock::time_point expire;
+    return HotReplicas::Get(key, value, expire);
+}
+
+// See HotReplicas.h
+bool HotReplicas::Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) {
+    Replica &replica = _replicas.Get();
+    std::unique_lock<std::mutex> lock(replica.mutex);
+    auto it = replica.copies.find(key);
+    if (it == replica.copies.end()) {
+        lock.unlock();
+        return _storage->Get(key, value, expire);
+    }
+
+    // Stamp is read before storage, so that write landing in between makes the copy stale. Every
+    // kTouchHits-th hit goes to storage to keep recency of the key there
+    const uint64_t stamp = StampOf(key).load(std::memory_order_acquire);
+    Copy &copy = it->second;
+    if (copy.filled && copy.stamp == stamp && ++copy.hits % kTouchHits != 0 &&
+        (copy.expire == std::chrono::steady_clock::time_point::max() ||
+         copy.expire > std::chrono::steady_clock::now())) {
+        value = copy.value;
+        expire = copy.expire;
+        replica.hits.Add();
+        return true;
+    }
+
+    lock.unlock();
+    if (!_storage->Get(key, value, expire)) {
+        return false;
+    }
+
+    // Refresh could have replaced the table meanwhile
+    lock.lock();
+    it = replica.copies.find(key);
+    if (it != replica.copies.end()) {
+        it->second = Copy{value, expire, stamp, true, 0};
+    }
+    return true;
+}
+
+// See HotReplicas.h
+void HotReplicas::Stats(const std::string &group, const StatWriter &writer) {
+    _storage->Stats(group, writer);
+    if (!group.empty()) {
+        return;
+    }
+
+    uint64_t hits = 0;
+    _replicas.ForEach([&hits](Replica &replica) { hits += replica.hits.Get(); });
+    writer("hot_replica_keys", _hot.load(std::memory_order_relaxed));
+    writer("hot_replica_hits", hits);
+}
+
+// See HotReplicas.h
+void HotReplicas::Refresh() {
+    uint64_t sampled;
+    std::vector<Metrics::HotKey> hot = Metrics::HotKeys(_keys, sampled);
+
+    // Keys which cooled down have to give way to the new hot ones
+    Metrics::DecayHotKeys();
+    _replicas.ForEach([&hot](Replica &replica) {
+        std::unordered_map<std::string, Copy> copies;
+        for (const Metrics::HotKey &key : hot) {
+            copies.emplace(key.key, Copy{std::string(), std::chrono::steady_clock::time_point::min(), 0, false, 0});
+        }
+
+        std::lock_guard<std::mutex> lock(replica.mutex);
+        replica.copies.swap(copies);
+    });
+    _hot.store(hot.size(), std::memory_order_relaxed);
+}
+
+// See HotReplicas.h
+void HotReplicas::OnRun() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_running) {
+        _wakeup.wait_for(lock, std::chrono::seconds(1));
+        if (_running) {
+            lock.unlock();
+            Refresh();
+            lock.lock();
+        }
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
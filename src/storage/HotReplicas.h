@@ -0,0 +1,165 @@
+#ifndef AFINA_STORAGE_HOT_REPLICAS_H
+#define AFINA_STORAGE_HOT_REPLICAS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/CoreLocal.h>
+#include <afina/metrics/Counters.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Per-core copies of the hottest keys
+ * Wraps any storage, thread safety is the one of the wrapped storage. Background thread picks the
+ * most frequently accessed keys once a second, as `stats hotkeys` sees them, and every core gets
+ * its own table of copies of them. Get of such a key is served from the table of the calling core,
+ * wrapped storage is not touched at all. The rest of requests go to storage as is.
+ *
+ * Read side is not lock-free: Get takes the mutex of the table of its core. Other cores never
+ * take it, only threads moved onto the same core and refresh once a second do, so it is not
+ * contended and its cache line stays with the core. Copies hold values of any size which refill
+ * replaces in place, a seqlock reader can't copy such a value safely, and swapping the table via
+ * atomic shared_ptr takes a lock shared by all cores in the standard library. Stamps are shared,
+ * but a reader only loads them: the line moves between cores on writes of the key, which make the
+ * copy stale anyway.
+ *
+ * Writes leave copies in place but bump version stamp of the key, copy made before that is not
+ * served and gets refilled by the next Get. Stamps are shared by keys of the same stripe, so a
+ * write could also cost a refill to the other key. Copy keeps expiration time storage reported
+ * for the value and is not served past it, storages which don't report it get no copies served.
+ * Every kTouchHits-th hit of a copy goes to storage as well, so that storage still sees the key
+ * as recently used. Copies are dropped on every refresh, so eviction of a hot key in storage is
+ * seen in a second at most.
+ *
+ * Keys are known only if hot key sampling is on, see HotKeys.h
+ */
+class HotReplicas : public Afina::Storage {
+public:
+    /**
+     * @param storage to serve keys from
+     * @param keys number of the hottest keys to copy
+     */
+    HotReplicas(std::shared_ptr<Afina::Storage> storage, std::size_t keys);
+    ~HotReplicas();
+
+    // Starts wrapped storage and refreshing of hot keys
+    void Start() override;
+
+    // Stops refreshing of hot keys and wrapped storage
+    void Stop() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override;
+
+    // Snapshot of the wrapped storage
+    bool Snapshot(const SnapshotWriter &writer) override { return _storage->Snapshot(writer); }
+
+    // Statistics of the wrapped storage, general ones are followed by hot_replica_keys and
+    // hot_replica_hits
+    void Stats(const std::string &group, const StatWriter &writer) override;
+
+    // Gauges of the wrapped storage
+    const Metrics::StorageGauges *Gauges() const override { return _storage->Gauges(); }
+
+    /**
+     * Picks the hottest keys anew and drops all copies, refresher calls it every second. Hot key
+     * summaries are decayed after that, so a key stopped being accessed loses its copies in a few
+     * refreshes
+     */
+    void Refresh();
+
+private:
+    static const std::size_t kStamps = 1024;
+    static const uint32_t kTouchHits = 64;
+
+    // Stamps take a cache line each, so that writes to the other keys don't evict the stamp of a
+    // hot one from caches of readers
+    struct Stamp {
+        std::atomic<uint64_t> value;
+        char padding[64 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    struct Copy {
+        std::string value;
+
+        // Expiration time of the value as storage reported it
+        std::chrono::steady_clock::time_point expire;
+
+        // Stamp of the key when value was read from storage
+        uint64_t stamp;
+        bool filled;
+
+        // Hits since the copy was filled
+        uint32_t hits;
+    };
+
+    // Copies of a single core
+    struct Replica {
+        std::mutex mutex;
+        std::unordered_map<std::string, Copy> copies;
+        Metrics::Counter hits;
+    };
+
+    std::atomic<uint64_t> &StampOf(const std::string &key) {
+        return _stamps[std::hash<std::string>()(key) % kStamps].value;
+    }
+
+    // Invalidates copies of the key, called once the write is done
+    void Written(const std::string &key) { StampOf(key).fetch_add(1, std::memory_order_release); }
+
+    // Refreshes hot keys between Start and Stop
+    void OnRun();
+
+    std::shared_ptr<Afina::Storage> _storage;
+    const std::size_t _keys;
+
+    Concurrency::CoreLocal<Replica> _replicas;
+    Stamp _stamps[kStamps];
+
+    // Number of keys copied by the last refresh
+    std::atomic<std::size_t> _hot;
+
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    bool _running;
+    std::thread _refresher;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_HOT_REPLICAS_H
@@ -0,0 +1,443 @@
+#include "OpLog.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <afina/logging/Service.h>
+
+#include "Persist.h"
+
+namespace Afina {
+namespace Backend {
+
+// Every file starts with it, so that unrelated or incompatible files are not replayed
+static const char kFileMagic[8] = {'A', 'F', 'O', 'P', 'L', 'O', 'G', '1'};
+
+// Record header: size of the body and its checksum
+static const std::size_t kRecordHeader = sizeof(uint32_t) + sizeof(uint64_t);
+
+// Records larger than that are considered damaged
+static const uint32_t kMaxRecord = 64 << 20;
+
+static const char *kSnapshot = "snapshot";
+static const char *kLog = "log";
+static const char *kOldLog = "log.old";
+
+// Writes the whole buffer, returns false with errno set on failure
+static bool WriteAll(int fd, const std::string &data) {
+    std::size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno != EINTR) {
+            return false;
+        } else if (n > 0) {
+            written += n;
+        }
+    }
+    return true;
+}
+
+// Makes renames and removals in the directory durable
+static void SyncDir(const std::string &dir) {
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+static bool Exists(const std::string &path) { return access(path.c_str(), F_OK) == 0; }
+
+OpLog::OpLog(const std::string &dir, std::chrono::milliseconds fsync_interval, uint64_t compact_size,
+             std::shared_ptr<Afina::Logging::Service> logging)
+    : _dir(dir), _fsync_interval(fsync_interval), _compact_size(compact_size), _logging(logging), _fd(-1),
+      _log_size(0), _appended(0), _durable(0), _sync_waiters(0), _failed(false), _running(false),
+      _replayed(false), _compacting(false), _compaction_failed(false) {
+    if (mkdir(_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw std::runtime_error("Failed to create " + _dir + ": " + std::strerror(errno));
+    }
+}
+
+OpLog::~OpLog() { Stop(); }
+
+// See OpLog.h
+void OpLog::Replay(const std::function<void(const Record &)> &apply) {
+    Read(Path(kSnapshot), apply);
+    Read(Path(kOldLog), apply);
+    int64_t valid = Read(Path(kLog), apply);
+    _log_size = valid > 0 ? valid : 0;
+    _replayed = true;
+}
+
+// See OpLog.h
+void OpLog::Start() {
+    if (_logging) {
+        _logger = _logging->select("oplog");
+    }
+    if (!_replayed) {
+        Replay([](const Record &) {});
+    }
+
+    // Previous compaction didn't finish
+    if (Exists(Path(kOldLog))) {
+        Compact();
+    }
+
+    // Cut torn tail, records appended after it would never be read otherwise
+    _fd = open(Path(kLog).c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (_fd < 0 || ftruncate(_fd, _log_size) != 0) {
+        throw std::runtime_error("Failed to open " + Path(kLog) + ": " + std::strerror(errno));
+    }
+    if (_log_size == 0) {
+        if (!WriteAll(_fd, std::string(kFileMagic, sizeof(kFileMagic)))) {
+            throw std::runtime_error("Failed to write " + Path(kLog) + ": " + std::strerror(errno));
+        }
+        _log_size = sizeof(kFileMagic);
+    }
+
+    _running = true;
+    _writer = std::thread(&OpLog::Writer, this);
+}
+
+// See OpLog.h
+void OpLog::Stop() {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_running) {
+            return;
+        }
+        _running = false;
+    }
+    _wakeup.notify_all();
+    _writer.join();
+    if (_compactor.joinable()) {
+        _compactor.join();
+    }
+
+    close(_fd);
+    _fd = -1;
+}
+
+// See OpLog.h
+void OpLog::Append(const Record &record) {
+    // Encoding happens out of the lock into a buffer each thread reuses
+    static thread_local std::string data;
+    data.clear();
+    Encode(record, data);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_failed) {
+        return;
+    }
+    _pending.append(data);
+    _appended++;
+}
+
+// See OpLog.h
+bool OpLog::Sync() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    const uint64_t target = _appended;
+    _sync_waiters++;
+    _wakeup.notify_all();
+    _synced.wait(lock, [this, target]() { return _durable >= target || _failed || !_running; });
+    _sync_waiters--;
+    return _durable >= target;
+}
+
+// See OpLog.h
+void OpLog::Stats(const Afina::Storage::StatWriter &writer) {
+    bool failed;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        failed = _failed;
+    }
+    writer("oplog_failed", failed);
+    writer("oplog_compaction_failed", _compaction_failed.load());
+}
+
+// See OpLog.h
+OpLog::Record OpLog::PutRecord(const std::string &key, const std::string &value, int32_t ttl) {
+    if (ttl < 0) {
+        return Record{Op::kDelete, 0, key, std::string()};
+    }
+    return Record{Op::kPut, ttl == 0 ? 0 : std::time(nullptr) + ttl, key, value};
+}
+
+// See OpLog.h
+void OpLog::Apply(Afina::Storage &storage, const Record &record) {
+    switch (record.op) {
+    case Op::kPut: {
+        // Records are in wall clock time
+        int64_t ttl = record.expire == 0 ? 0 : record.expire - std::time(nullptr);
+        if (ttl < 0 || (ttl == 0 && record.expire != 0)) {
+            storage.Delete(record.key);
+        } else {
+            storage.Put(record.key, record.value, int32_t(ttl));
+        }
+        break;
+    }
+    case Op::kSet:
+        storage.Set(record.key, record.value);
+        break;
+    case Op::kDelete:
+        storage.Delete(record.key);
+        break;
+    }
+}
+
+// See OpLog.h
+void OpLog::Encode(const Record &record, std::string &out) {
+    // Header goes first and is filled once body is in place
+    const std::size_t start = out.size();
+    out.resize(start + kRecordHeader);
+    PersistPut(out, uint8_t(record.op));
+    PersistPut(out, record.expire);
+    PersistPut(out, uint32_t(record.key.size()));
+    out.append(record.key);
+    out.append(record.value);
+
+    const uint32_t size = out.size() - start - kRecordHeader;
+    const uint64_t checksum = Checksum(&out[start + kRecordHeader], size);
+    std::memcpy(&out[start], &size, sizeof(size));
+    std::memcpy(&out[start + sizeof(size)], &checksum, sizeof(checksum));
+}
+
+// See OpLog.h
+int OpLog::Decode(const char *&data, const char *end, Record &record) {
+    const char *pos = data;
+    uint32_t size;
+    uint64_t checksum;
+    if (!PersistGet(pos, end, size) || !PersistGet(pos, end, checksum)) {
+        return 0;
+    } else if (size > kMaxRecord) {
+        return -1;
+    } else if (size > std::size_t(end - pos)) {
+        return 0;
+    }
+
+    if (Checksum(pos, size) != checksum || !DecodeBody(pos, pos + size, record)) {
+        return -1;
+    }
+    data = pos + size;
+    return 1;
+}
+
+// See OpLog.h
+bool OpLog::DecodeBody(const char *data, const char *end, Record &record) {
+    uint8_t op;
+    uint32_t key_size;
+    if (!PersistGet(data, end, op) || !PersistGet(data, end, record.expire) || !PersistGet(data, end, key_size) ||
+        key_size > std::size_t(end - data) || op < uint8_t(Op::kPut) || op > uint8_t(Op::kDelete)) {
+        return false;
+    }
+    record.op = Op(op);
+    record.key.assign(data, key_size);
+    record.value.assign(data + key_size, end);
+    return true;
+}
+
+// See OpLog.h
+int64_t OpLog::Read(const std::string &path, const std::function<void(const Record &)> &apply) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return -1;
+    }
+
+    char magic[sizeof(kFileMagic)];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, kFileMagic, sizeof(magic)) != 0) {
+        return 0;
+    }
+
+    int64_t valid = sizeof(magic);
+    std::string header(kRecordHeader, '\0'), body;
+    while (file.read(&header[0], header.size())) {
+        const char *data = header.data();
+        uint32_t size;
+        uint64_t checksum;
+        PersistGet(data, header.data() + header.size(), size);
+        PersistGet(data, header.data() + header.size(), checksum);
+        if (size > kMaxRecord) {
+            break;
+        }
+
+        body.resize(size);
+        if (!file.read(&body[0], size) || Checksum(body.data(), body.size()) != checksum) {
+            break;
+        }
+
+        Record record;
+        if (!DecodeBody(body.data(), body.data() + body.size(), record)) {
+            break;
+        }
+        apply(record);
+        valid += kRecordHeader + size;
+    }
+    return valid;
+}
+
+// See OpLog.h
+void OpLog::Compact() {
+    // Latest state of every key, only puts are left after merge
+    std::unordered_map<std::string, Record> state;
+    auto merge = [&state](const Record &record) {
+        switch (record.op) {
+        case Op::kPut:
+            state[record.key] = record;
+            break;
+        case Op::kSet: {
+            auto it = state.find(record.key);
+            if (it != state.end()) {
+                it->second.value = record.value;
+            }
+            break;
+        }
+        case Op::kDelete:
+            state.erase(record.key);
+            break;
+        }
+    };
+    Read(Path(kSnapshot), merge);
+    Read(Path(kOldLog), merge);
+
+    const std::string tmp = Path("snapshot.tmp");
+    int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        CompactionFailed("Failed to open " + tmp + ": " + std::strerror(errno));
+        return;
+    }
+
+    const int64_t now = std::time(nullptr);
+    std::string data(kFileMagic, sizeof(kFileMagic));
+    bool written = true;
+    for (auto it = state.begin(); it != state.end() && written; ++it) {
+        if (it->second.expire == 0 || it->second.expire > now) {
+            Encode(it->second, data);
+        }
+        if (data.size() >= (1 << 20)) {
+            written = WriteAll(fd, data);
+            data.clear();
+        }
+    }
+    if (!written || !WriteAll(fd, data) || fsync(fd) != 0) {
+        CompactionFailed("Failed to write " + tmp + ": " + std::strerror(errno));
+        close(fd);
+        unlink(tmp.c_str());
+        return;
+    }
+    close(fd);
+
+    // Snapshot is replaced atomically, old log goes away only once new snapshot is durable
+    if (std::rename(tmp.c_str(), Path(kSnapshot).c_str()) != 0) {
+        CompactionFailed("Failed to rename " + tmp + ": " + std::strerror(errno));
+        unlink(tmp.c_str());
+        return;
+    }
+    SyncDir(_dir);
+    unlink(Path(kOldLog).c_str());
+    SyncDir(_dir);
+    _compacting = false;
+}
+
+// See OpLog.h
+void OpLog::Rotate() {
+    // Appends keep going into the current log under the old name until the new one is ready
+    if (std::rename(Path(kLog).c_str(), Path(kOldLog).c_str()) != 0) {
+        CompactionFailed("Failed to rename " + Path(kLog) + ": " + std::strerror(errno));
+        return;
+    }
+
+    int fd = open(Path(kLog).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0 || !WriteAll(fd, std::string(kFileMagic, sizeof(kFileMagic))) || fdatasync(fd) != 0) {
+        // Old log is replayed before the new one, so records keep their order if appends stay in the old one
+        CompactionFailed("Failed to open " + Path(kLog) + ": " + std::strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+    close(_fd);
+    _fd = fd;
+    SyncDir(_dir);
+    _log_size = sizeof(kFileMagic);
+
+    // Appends go into the new log while the old one is being compacted
+    _compacting = true;
+    _compactor = std::thread(&OpLog::Compact, this);
+}
+
+// See OpLog.h
+void OpLog::Fail(const std::string &error) {
+    if (_logger) {
+        _logger->error("{}, changes are not logged anymore", error);
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _failed = true;
+    _pending.clear();
+}
+
+// See OpLog.h
+void OpLog::CompactionFailed(const std::string &error) {
+    if (_logger) {
+        _logger->error("{}, log is not compacted anymore", error);
+    }
+
+    // Writer must not switch logs once compacting is reset, the old one would be overwritten
+    _compaction_failed = true;
+    _compacting = false;
+}
+
+// See OpLog.h
+void OpLog::Writer() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _wakeup.wait_for(lock, _fsync_interval, [this]() { return !_running || _sync_waiters > 0; });
+
+        // Everything collected during the interval goes to disk at once
+        std::string batch;
+        batch.swap(_pending);
+        const uint64_t appended = _appended;
+        const bool running = _running;
+        lock.unlock();
+
+        // After a failed write or sync it is unknown what reached the disk, so the log is given up
+        bool failed = false;
+        if (!batch.empty()) {
+            failed = !WriteAll(_fd, batch) || fdatasync(_fd) != 0;
+            if (failed) {
+                Fail("Failed to write " + Path(kLog) + ": " + std::strerror(errno));
+            } else {
+                _log_size += batch.size();
+            }
+        }
+
+        if (running && !failed && _log_size >= _compact_size && !_compacting && !_compaction_failed) {
+            if (_compactor.joinable()) {
+                _compactor.join();
+            }
+            Rotate();
+        }
+
+        lock.lock();
+        if (!_failed) {
+            _durable = appended;
+        }
+        _synced.notify_all();
+        if (!running) {
+            break;
+        }
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
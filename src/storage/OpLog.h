@@ -0,0 +1,186 @@
+#ifndef AFINA_STORAGE_OP_LOG_H
+#define AFINA_STORAGE_OP_LOG_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Logging {
+class AsyncLogger;
+class Service;
+} // namespace Logging
+namespace Backend {
+
+/**
+ * # Append-only log of storage changes
+ * Directory keeps two files: snapshot with the state as of the last compaction and log of changes
+ * made since. Both are sequences of checksummed records, so replay stops at the first torn or
+ * damaged record and the log is cut there.
+ *
+ * Appends only copy the record into memory buffer. Writer thread wakes up every fsync interval,
+ * writes everything collected at once and syncs it, so a crash loses at most the last interval.
+ *
+ * Once log grows over the compaction size writer switches to a new log and compactor thread
+ * merges the old one into a new snapshot, keeping only the latest live record of each key. Then
+ * old log is removed.
+ *
+ * Once writing or syncing the log fails, records after the failed one could never be replayed, so
+ * log stops taking new ones and Sync reports the failure. If compaction fails, old log is kept and
+ * replayed along with the snapshot, and log is not switched anymore. Both are shown in stats and
+ * logged
+ */
+class OpLog {
+public:
+    enum class Op : uint8_t {
+        // Store value with expiration time
+        kPut = 1,
+
+        // Replace value of existing key, keeping its expiration time
+        kSet = 2,
+
+        kDelete = 3,
+    };
+
+    struct Record {
+        Op op;
+
+        // Unix time item expires at, 0 if it never expires
+        int64_t expire;
+
+        std::string key;
+        std::string value;
+    };
+
+    /**
+     * @param dir directory to keep files in, created if missing
+     * @param fsync_interval how often collected records get to disk
+     * @param compact_size log size that triggers compaction
+     * @param logging service to report failures to, may be null
+     */
+    OpLog(const std::string &dir, std::chrono::milliseconds fsync_interval, uint64_t compact_size = 64 << 20,
+          std::shared_ptr<Afina::Logging::Service> logging = nullptr);
+    ~OpLog();
+
+    /**
+     * Calls apply for every record of snapshot and log, in the order they were appended. Must be
+     * called before Start
+     */
+    void Replay(const std::function<void(const Record &)> &apply);
+
+    /**
+     * Opens log for appending and starts writer thread
+     */
+    void Start();
+
+    /**
+     * Writes and syncs everything appended so far, then stops background threads
+     */
+    void Stop();
+
+    /**
+     * Queues record to be written, thread safe
+     */
+    void Append(const Record &record);
+
+    /**
+     * Blocks until everything appended so far is on disk. Returns false if log failed before that
+     */
+    bool Sync();
+
+    /**
+     * Writes oplog_failed and oplog_compaction_failed, 1 once the failure happened
+     */
+    void Stats(const Afina::Storage::StatWriter &writer);
+
+    // Record of put with given ttl, negative ttl means item is gone right away
+    static Record PutRecord(const std::string &key, const std::string &value, int32_t ttl);
+
+    // Applies record to the storage, time passed since record was made counts towards expiration
+    static void Apply(Afina::Storage &storage, const Record &record);
+
+    // Appends encoded record to the buffer
+    static void Encode(const Record &record, std::string &out);
+
+    /**
+     * Decodes record at the start of [data, end) and moves data past it. Returns 1 if record is
+     * decoded, 0 if buffer holds only a part of it and -1 if record is damaged
+     */
+    static int Decode(const char *&data, const char *end, Record &record);
+
+private:
+    // Decodes record body which checksum is already verified
+    static bool DecodeBody(const char *data, const char *end, Record &record);
+
+    // Reads records of the file, returns size of its valid part or -1 if file doesn't exist
+    static int64_t Read(const std::string &path, const std::function<void(const Record &)> &apply);
+
+    // Merges snapshot and old log into a new snapshot, then removes old log
+    void Compact();
+
+    // Switches to a new log and starts compaction of the current one
+    void Rotate();
+
+    // Stops taking records for the log is broken
+    void Fail(const std::string &error);
+
+    // Stops switching logs for the old one is not compacted
+    void CompactionFailed(const std::string &error);
+
+    // Writer thread body
+    void Writer();
+
+    std::string Path(const char *name) const { return _dir + "/" + name; }
+
+    const std::string _dir;
+    const std::chrono::milliseconds _fsync_interval;
+    const uint64_t _compact_size;
+
+    std::shared_ptr<Afina::Logging::Service> _logging;
+    std::shared_ptr<Afina::Logging::AsyncLogger> _logger;
+
+    // Current log, written by writer thread only
+    int _fd;
+    uint64_t _log_size;
+
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    std::condition_variable _synced;
+
+    // Records appended but not written yet, guarded by _mutex
+    std::string _pending;
+
+    // Number of appends made and number of them already on disk, guarded by _mutex
+    uint64_t _appended;
+    uint64_t _durable;
+
+    // Number of threads blocked in Sync, writer doesn't wait for the interval while there are any
+    int _sync_waiters;
+
+    // Set once writing the log fails, records appended after that are dropped. Guarded by _mutex
+    bool _failed;
+
+    bool _running;
+    bool _replayed;
+    std::thread _writer;
+
+    // Set while compactor thread works, writer doesn't rotate log until it is done
+    std::atomic<bool> _compacting;
+    std::thread _compactor;
+
+    // Set once compaction fails, old log is not compacted until restart
+    std::atomic<bool> _compaction_failed;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_OP_LOG_H
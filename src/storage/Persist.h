@@ -0,0 +1,55 @@
+#ifndef AFINA_STORAGE_PERSIST_H
+#define AFINA_STORAGE_PERSIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * Appends raw bytes of the value to the buffer
+ */
+template <typename T> void PersistPut(std::string &out, const T &value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * Reads value written by PersistPut and moves data past it. Returns false if there is not enough data
+ */
+template <typename T> bool PersistGet(const char *&data, const char *end, T &value) {
+    if (std::size_t(end - data) < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+}
+
+/**
+ * 64-bit checksum of the data, good to detect corruption, not tampering. Data is consumed by
+ * words, so checksumming large regions runs at memory speed
+ */
+inline uint64_t Checksum(const void *data, std::size_t size, uint64_t seed = 0) {
+    const uint64_t kMul = 0x9e3779b97f4a7c15ULL;
+    const char *p = static_cast<const char *>(data);
+    uint64_t h = seed ^ (size * kMul);
+    for (; size >= 8; size -= 8, p += 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = (h ^ word) * kMul;
+        h ^= h >> 29;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, p, size);
+    h = (h ^ tail) * kMul;
+    return h ^ (h >> 32);
+}
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_PERSIST_H
@@ -0,0 +1,275 @@
+#include "S3FIFO.h"
+
+#include <afina/metrics/Probes.h>
+
+namespace Afina {
+namespace Backend {
+
+S3FIFO::S3FIFO(size_t max_size)
+    : _max_size(max_size), _small_max(max_size / 10), _lock("storage"), _small_size(0), _main_size(0),
+      _evictions(0), _ghost_seq(0) {
+    _gauges.limit_maxbytes.Set(max_size);
+}
+
+// See S3FIFO.h
+bool S3FIFO::Put(const std::string &key, const std::string &value) { return S3FIFO::Put(key, value, 0); }
+
+// See S3FIFO.h
+bool S3FIFO::Put(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    Metrics::ProfiledRWLock::WriteGuard guard(_lock);
+    node_list::iterator it;
+    if (Lookup(key, it)) {
+        Update(it, value, Deadline(ttl));
+    } else {
+        Insert(key, value, Deadline(ttl));
+    }
+    return true;
+}
+
+// See S3FIFO.h
+bool S3FIFO::PutIfAbsent(const std::string &key, const std::string &value) {
+    return S3FIFO::PutIfAbsent(key, value, 0);
+}
+
+// See S3FIFO.h
+bool S3FIFO::PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    Metrics::ProfiledRWLock::WriteGuard guard(_lock);
+    node_list::iterator it;
+    if (Lookup(key, it)) {
+        return false;
+    }
+    Insert(key, value, Deadline(ttl));
+    return true;
+}
+
+// See S3FIFO.h
+bool S3FIFO::Set(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    Metrics::ProfiledRWLock::WriteGuard guard(_lock);
+    node_list::iterator it;
+    if (!Lookup(key, it)) {
+        return false;
+    }
+    Update(it, value, it->expire);
+    return true;
+}
+
+// See S3FIFO.h
+bool S3FIFO::Set(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    Metrics::ProfiledRWLock::WriteGuard guard(_lock);
+    node_list::iterator it;
+    if (!Lookup(key, it)) {
+        return false;
+    }
+    Update(it, value, Deadline(ttl));
+    return true;
+}
+
+// See S3FIFO.h
+bool S3FIFO::Delete(const std::string &key) {
+    Metrics::ProfiledRWLock::WriteGuard guard(_lock);
+    node_list::iterator it;
+    if (!Lookup(key, it)) {
+        return false;
+    }
+    Remove(it);
+    return true;
+}
+
+// See S3FIFO.h
+bool S3FIFO::Get(const std::string &key, std::string &value) {
+    clock::time_point expire;
+    return S3FIFO::Get(key, value, expire);
+}
+
+// See S3FIFO.h
+bool S3FIFO::Get(const std::string &key, std::string &value, clock::time_point &expire) {
+    Metrics::ProfiledRWLock::ReadGuard guard(_lock);
+    auto index_it = _index.find(key);
+    if (index_it == _index.end()) {
+        AFINA_PROBE3(storage_get, key.size(), 0, false);
+        return false;
+    }
+
+    // Expired node is left for writers, readers don't modify cache structure
+    node &item = *index_it->second;
+    if (item.expire != clock::time_point::max() && item.expire <= clock::now()) {
+        AFINA_PROBE3(storage_get, key.size(), 0, false);
+        return false;
+    }
+
+    // Concurrent readers could lose an increment, that is fine for the 2-bit counter
+    uint8_t freq = item.freq.load(std::memory_order_relaxed);
+    if (freq < 3) {
+        item.freq.store(freq + 1, std::memory_order_relaxed);
+    }
+    value = item.value;
+    expire = item.expire;
+    AFINA_PROBE3(storage_get, key.size(), value.size(), true);
+    return true;
+}
+
+// See S3FIFO.h
+void S3FIFO::Stats(const std::string &group, const StatWriter &writer) {
+    if (group.empty()) {
+        Metrics::ProfiledRWLock::ReadGuard guard(_lock);
+        writer("curr_items", _index.size());
+        writer("bytes", _small_size + _main_size);
+        writer("limit_maxbytes", _max_size);
+        writer("evictions", _evictions);
+    }
+}
+
+// See S3FIFO.h
+bool S3FIFO::Lookup(const std::string &key, node_list::iterator &it) {
+    auto index_it = _index.find(key);
+    if (index_it == _index.end()) {
+        return false;
+    }
+
+    it = index_it->second;
+    if (it->expire != clock::time_point::max() && it->expire <= clock::now()) {
+        Remove(it);
+        return false;
+    }
+    return true;
+}
+
+// See S3FIFO.h
+void S3FIFO::Insert(const std::string &key, const std::string &value, clock::time_point expire) {
+    AFINA_PROBE2(storage_put, key.size(), value.size());
+    // Key evicted from small queue recently is not a one-hit wonder
+    auto ghost_it = _ghost.find(key_hash()(key));
+    if (ghost_it != _ghost.end()) {
+        _ghost.erase(ghost_it);
+        _main.emplace_front(key, value, expire);
+        _main.front().in_main = true;
+        _index.emplace(_main.front().key, _main.begin());
+        _main_size += key.size() + value.size();
+    } else {
+        _small.emplace_front(key, value, expire);
+        _index.emplace(_small.front().key, _small.begin());
+        _small_size += key.size() + value.size();
+    }
+    Evict();
+}
+
+// See S3FIFO.h
+void S3FIFO::Update(node_list::iterator it, const std::string &value, clock::time_point expire) {
+    AFINA_PROBE2(storage_put, it->key.size(), value.size());
+    std::size_t &size = it->in_main ? _main_size : _small_size;
+    size = size - it->value.size() + value.size();
+    it->value = value;
+    it->expire = expire;
+
+    uint8_t freq = it->freq.load(std::memory_order_relaxed);
+    if (freq < 3) {
+        it->freq.store(freq + 1, std::memory_order_relaxed);
+    }
+    Evict();
+}
+
+// See S3FIFO.h
+void S3FIFO::Remove(node_list::iterator it) {
+    _index.erase(it->key);
+    if (it->in_main) {
+        _main_size -= it->key.size() + it->value.size();
+        _main.erase(it);
+    } else {
+        _small_size -= it->key.size() + it->value.size();
+        _small.erase(it);
+    }
+    Publish();
+}
+
+// See S3FIFO.h
+void S3FIFO::Evict() {
+    while (_small_size + _main_size > _max_size) {
+        if (!_small.empty() && (_small_size > _small_max || _main.empty())) {
+            EvictSmall();
+        } else {
+            EvictMain();
+        }
+    }
+    Publish();
+}
+
+// See S3FIFO.h
+void S3FIFO::Publish() { _gauges.Publish(_index.size(), _small_size + _main_size, _evictions); }
+
+// See S3FIFO.h
+void S3FIFO::EvictSmall() {
+    auto it = std::prev(_small.end());
+    bool expired = it->expire <= clock::now();
+    if (!expired && it->freq.load(std::memory_order_relaxed) > 0) {
+        std::size_t item_size = it->key.size() + it->value.size();
+        _main.splice(_main.begin(), _small, it);
+        it->in_main = true;
+        it->freq.store(0, std::memory_order_relaxed);
+        _small_size -= item_size;
+        _main_size += item_size;
+        return;
+    }
+
+    if (!expired) {
+        AFINA_PROBE2(storage_evict, it->key.size(), it->value.size());
+        RememberGhost(key_hash()(it->key));
+        _evictions++;
+    }
+    Remove(it);
+}
+
+// See S3FIFO.h
+void S3FIFO::EvictMain() {
+    const clock::time_point now = clock::now();
+    while (!_main.empty()) {
+        auto it = std::prev(_main.end());
+        uint8_t freq = it->freq.load(std::memory_order_relaxed);
+        if (freq == 0 || it->expire <= now) {
+            if (it->expire > now) {
+                AFINA_PROBE2(storage_evict, it->key.size(), it->value.size());
+                _evictions++;
+            }
+            Remove(it);
+            return;
+        }
+
+        it->freq.store(freq - 1, std::memory_order_relaxed);
+        _main.splice(_main.begin(), _main, it);
+    }
+}
+
+// See S3FIFO.h
+void S3FIFO::RememberGhost(uint64_t hash) {
+    _ghost[hash] = ++_ghost_seq;
+    _ghost_queue.emplace_back(hash, _ghost_seq);
+
+    // Eviction happens when cache is full, so number of items is the cache capacity
+    const std::size_t limit = _index.size() + 1;
+    while (_ghost.size() > limit || _ghost_queue.size() > 2 * limit) {
+        auto &oldest = _ghost_queue.front();
+        auto it = _ghost.find(oldest.first);
+        if (it != _ghost.end() && it->second == oldest.second) {
+            _ghost.erase(it);
+        }
+        _ghost_queue.pop_front();
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,162 @@
+#ifndef AFINA_STORAGE_S3_FIFO_H
+#define AFINA_STORAGE_S3_FIFO_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include <afina/Storage.h>
+#include <afina/metrics/Locks.h>
+#include <afina/metrics/StorageGauges.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # S3-FIFO cache, thread safe
+ * Cache consists of two FIFO queues: small one takes 10% of memory and main one takes the rest.
+ * New items go into small queue. Once item reaches the end of small queue it is moved to main one
+ * if it was accessed while being there, otherwise it is evicted and its key hash is remembered in
+ * the ghost queue. Items in ghost queue are inserted right into main queue once they come back.
+ *
+ * Main queue is a CLOCK: item reaching its end is reinserted while it has accesses left, each
+ * reinsertion takes one of them.
+ *
+ * Hit only increments 2-bit access counter of the item, queues are never relinked by readers, so
+ * Get runs under the shared side of rw-lock. The lock is profiled under the name "storage", see
+ * `stats locks`
+ */
+class S3FIFO : public Afina::Storage {
+public:
+    S3FIFO(size_t max_size = 1024);
+    ~S3FIFO() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override;
+
+    // Implements Afina::Storage interface
+    void Stats(const std::string &group, const StatWriter &writer) override;
+
+    // Implements Afina::Storage interface
+    const Metrics::StorageGauges *Gauges() const override { return &_gauges; }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    // Cache item, queues are ordered from the newest item to the oldest one
+    struct node {
+        node(const std::string &k, const std::string &v, clock::time_point e)
+            : key(k), value(v), expire(e), freq(0), in_main(false) {}
+
+        std::string key;
+        std::string value;
+
+        // Time point after which node is expired, time_point::max() if node never expires
+        clock::time_point expire;
+
+        // Number of accesses, saturates at 3. Incremented by readers, decremented by eviction
+        std::atomic<uint8_t> freq;
+
+        // Queue node is in
+        bool in_main;
+    };
+    using node_list = std::list<node>;
+
+    // Index keys point into nodes, so every key is stored once
+    using key_ref = std::reference_wrapper<const std::string>;
+    struct key_hash {
+        std::size_t operator()(const std::string &key) const { return std::hash<std::string>()(key); }
+    };
+
+    // Finds live node for the key, exclusive lock must be held. Expired node is removed
+    bool Lookup(const std::string &key, node_list::iterator &it);
+
+    // Places new node into small queue, or into main one if the key was recently evicted
+    void Insert(const std::string &key, const std::string &value, clock::time_point expire);
+
+    // Replaces value and expiration time of the existing node
+    void Update(node_list::iterator it, const std::string &value, clock::time_point expire);
+
+    // Removes node from queue and index
+    void Remove(node_list::iterator it);
+
+    // Evicts nodes until cache fits into _max_size
+    void Evict();
+
+    // Sets gauges to the current state, called on every change
+    void Publish();
+
+    // Evicts or promotes the oldest node of small queue
+    void EvictSmall();
+
+    // Evicts the oldest node of main queue, reinserting ones that were accessed
+    void EvictMain();
+
+    // Remembers hash of the evicted key, ghost queue holds as many keys as cache does
+    void RememberGhost(uint64_t hash);
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be less the _max_size
+    const std::size_t _max_size;
+
+    // Byte budget of small queue
+    const std::size_t _small_max;
+
+    // Readers take it shared, writers exclusive
+    Metrics::ProfiledRWLock _lock;
+
+    node_list _small;
+    node_list _main;
+
+    std::size_t _small_size;
+    std::size_t _main_size;
+
+    // Number of live items evicted, guarded by exclusive lock
+    uint64_t _evictions;
+
+    // Occupancy for the exporter
+    Metrics::StorageGauges _gauges;
+
+    // Index of nodes from queues above
+    std::unordered_map<key_ref, node_list::iterator, key_hash, std::equal_to<std::string>> _index;
+
+    // Ghost queue of evicted key hashes. Each hash is mapped to the sequence number of its latest
+    // entry in the queue, entries with other numbers are stale and skipped once they are dropped
+    std::deque<std::pair<uint64_t, uint64_t>> _ghost_queue;
+    std::unordered_map<uint64_t, uint64_t> _ghost;
+    uint64_t _ghost_seq;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_S3_FIFO_H
@@ -1,22 +1,399 @@
 #include "SimpleLRU.h"
 
+#include <afina/metrics/Probes.h>
+
 namespace Afina {
 namespace Backend {
 
+// Number of expired nodes reclaimed on each write, so that memory goes back to live data even
+// if nobody calls SweepExpired explicitly
+static const std::size_t kSweepOnWrite = 2;
+
+// Number of expired nodes reclaimed before evicting live ones
+static const std::size_t kSweepOnEvict = 64;
+
+SimpleLRU::~SimpleLRU() {
+    _lru_index.clear();
+    _expire_index.clear();
+
+    // Destroy list iteratively, recursive destructors of unique_ptr overflow the stack
+    while (_lru_head) {
+        _lru_head = std::move(_lru_head->next);
+    }
+}
+
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Put(const std::string &key, const std::string &value) { return false; }
+bool SimpleLRU::Put(const std::string &key, const std::string &value) { return SimpleLRU::Put(key, value, 0); }
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value) { return false; }
+bool SimpleLRU::Put(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    SweepExpired(kSweepOnWrite);
+    lru_node *node = Lookup(key);
+    if (node != nullptr) {
+        Update(*node, value, Deadline(ttl));
+    } else {
+        Insert(key, value, Deadline(ttl));
+    }
+    return true;
+}
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Set(const std::string &key, const std::string &value) { return false; }
+bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return SimpleLRU::PutIfAbsent(key, value, 0);
+}
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Delete(const std::string &key) { return false; }
+bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    SweepExpired(kSweepOnWrite);
+    if (Lookup(key) != nullptr) {
+        return false;
+    }
+    Insert(key, value, Deadline(ttl));
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Set(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    SweepExpired(kSweepOnWrite);
+    lru_node *node = Lookup(key);
+    if (node == nullptr) {
+        return false;
+    }
+    Update(*node, value, node->expire);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Set(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    SweepExpired(kSweepOnWrite);
+    lru_node *node = Lookup(key);
+    if (node == nullptr) {
+        return false;
+    }
+    Update(*node, value, Deadline(ttl));
+    return true;
+}
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Get(const std::string &key, std::string &value) { return false; }
+bool SimpleLRU::Delete(const std::string &key) {
+    lru_node *node = Lookup(key);
+    if (node == nullptr) {
+        return false;
+    }
+    Remove(*node);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Get(const std::string &key, std::string &value) {
+    clock::time_point expire;
+    return SimpleLRU::Get(key, value, expire);
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Get(const std::string &key, std::string &value, clock::time_point &expire) {
+    lru_node *node = Lookup(key);
+    if (node == nullptr) {
+        AFINA_PROBE3(storage_get, key.size(), 0, false);
+        return false;
+    }
+    MoveToTail(*node);
+    value = node->value;
+    expire = node->expire;
+    AFINA_PROBE3(storage_get, key.size(), value.size(), true);
+    return true;
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Snapshot(const SnapshotWriter &writer) {
+    if (!SnapshotBegin()) {
+        return false;
+    }
+
+    // Writer runs between batches and is free to change the storage
+    std::vector<snapshot_item> batch;
+    bool more = true;
+    while (more) {
+        more = SnapshotNext(kSnapshotBatch, batch);
+        if (!WriteSnapshot(batch, writer)) {
+            SnapshotEnd();
+            return false;
+        }
+    }
+    SnapshotEnd();
+    return true;
+}
+
+// See SimpleLRU.h
+void SimpleLRU::Stats(const std::string &group, const StatWriter &writer) {
+    if (group.empty()) {
+        writer("curr_items", _lru_index.size());
+        writer("bytes", _size);
+        writer("limit_maxbytes", _max_size);
+        writer("evictions", _evictions);
+    }
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::SnapshotBegin() {
+    if (_snapshot_active) {
+        return false;
+    }
+    _snapshot_active = true;
+    _snapshot_started = false;
+    _snapshot_done = false;
+    _snapshot_version = _version;
+    _snapshot_cursor.clear();
+    return true;
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::SnapshotNext(std::size_t max_items, std::vector<snapshot_item> &out) {
+    out.clear();
+    auto it = _snapshot_started ? _lru_index.upper_bound(_snapshot_cursor) : _lru_index.begin();
+    for (std::size_t visited = 0; it != _lru_index.end() && visited < max_items; ++it, visited++) {
+        // Nodes of later versions are either new or were preserved once they changed
+        const lru_node &node = it->second;
+        if (node.version <= _snapshot_version) {
+            out.push_back(snapshot_item{node.key, node.value, node.expire});
+        }
+    }
+
+    if (it == _lru_index.end()) {
+        _snapshot_done = true;
+    } else {
+        _snapshot_cursor = std::prev(it)->first;
+        _snapshot_started = true;
+    }
+
+    // Nothing is preserved during this call, so once index is over the rest is all here
+    for (auto &item : _snapshot_preserved) {
+        out.push_back(std::move(item));
+    }
+    _snapshot_preserved.clear();
+    return !_snapshot_done;
+}
+
+// See SimpleLRU.h
+void SimpleLRU::SnapshotEnd() {
+    _snapshot_active = false;
+    _snapshot_cursor.clear();
+    _snapshot_preserved.clear();
+    _snapshot_preserved.shrink_to_fit();
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::WriteSnapshot(const std::vector<snapshot_item> &items, const SnapshotWriter &writer) {
+    const clock::time_point now = clock::now();
+    for (const snapshot_item &item : items) {
+        int32_t ttl = 0;
+        if (item.expire != clock::time_point::max()) {
+            if (item.expire <= now) {
+                continue;
+            }
+
+            // Round up, so item doesn't expire before it would in this storage
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(item.expire - now).count();
+            ttl = static_cast<int32_t>((left + 999) / 1000);
+        }
+
+        if (!writer(item.key, item.value, ttl)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// See SimpleLRU.h
+std::size_t SimpleLRU::SweepExpired(std::size_t max_items) {
+    if (_expire_index.empty()) {
+        return 0;
+    }
+
+    // Buckets before the current one are expired entirely, the current one is left to lazy checks
+    const int64_t now = ExpireBucket(clock::now());
+    std::size_t removed = 0;
+    while (removed < max_items && !_expire_index.empty() && _expire_index.begin()->first < now) {
+        Remove(*_expire_index.begin()->second);
+        removed++;
+    }
+    return removed;
+}
+
+// See SimpleLRU.h
+int64_t SimpleLRU::ExpireBucket(clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+// See SimpleLRU.h
+SimpleLRU::lru_node *SimpleLRU::Lookup(const std::string &key) {
+    auto it = _lru_index.find(key);
+    if (it == _lru_index.end()) {
+        return nullptr;
+    }
+
+    lru_node &node = it->second;
+    if (node.expire != clock::time_point::max() && node.expire <= clock::now()) {
+        Remove(node);
+        return nullptr;
+    }
+    return &node;
+}
+
+// See SimpleLRU.h
+void SimpleLRU::Insert(const std::string &key, const std::string &value, clock::time_point expire) {
+    AFINA_PROBE2(storage_put, key.size(), value.size());
+    std::unique_ptr<lru_node> node(new lru_node{key, value, expire, _lru_tail, nullptr, nullptr, nullptr, ++_version});
+    lru_node *inserted = node.get();
+    if (_lru_tail != nullptr) {
+        _lru_tail->next = std::move(node);
+    } else {
+        _lru_head = std::move(node);
+    }
+    _lru_tail = inserted;
+
+    _lru_index.emplace(inserted->key, *inserted);
+    LinkExpire(*inserted);
+    _size += key.size() + value.size();
+    Evict();
+}
+
+// See SimpleLRU.h
+void SimpleLRU::Update(lru_node &node, const std::string &value, clock::time_point expire) {
+    AFINA_PROBE2(storage_put, node.key.size(), value.size());
+    Preserve(node);
+    node.version = ++_version;
+    _size = _size - node.value.size() + value.size();
+    node.value = value;
+    if (node.expire != expire) {
+        UnlinkExpire(node);
+        node.expire = expire;
+        LinkExpire(node);
+    }
+    MoveToTail(node);
+    Evict();
+}
+
+// See SimpleLRU.h
+void SimpleLRU::Remove(lru_node &node) {
+    Preserve(node);
+    _lru_index.erase(node.key);
+    UnlinkExpire(node);
+    _size -= node.key.size() + node.value.size();
+
+    // Node is owned either by previous one or by the head pointer
+    std::unique_ptr<lru_node> &owner = (node.prev != nullptr) ? node.prev->next : _lru_head;
+    if (node.next) {
+        node.next->prev = node.prev;
+    } else {
+        _lru_tail = node.prev;
+    }
+    owner = std::move(node.next);
+    Publish();
+}
+
+// See SimpleLRU.h
+void SimpleLRU::MoveToTail(lru_node &node) {
+    if (&node == _lru_tail) {
+        return;
+    }
+
+    std::unique_ptr<lru_node> &owner = (node.prev != nullptr) ? node.prev->next : _lru_head;
+    std::unique_ptr<lru_node> self = std::move(owner);
+    node.next->prev = node.prev;
+    owner = std::move(node.next);
+
+    node.prev = _lru_tail;
+    _lru_tail->next = std::move(self);
+    _lru_tail = &node;
+}
+
+// See SimpleLRU.h
+void SimpleLRU::LinkExpire(lru_node &node) {
+    if (node.expire == clock::time_point::max()) {
+        return;
+    }
+
+    lru_node *&head = _expire_index[ExpireBucket(node.expire)];
+    node.expire_prev = nullptr;
+    node.expire_next = head;
+    if (head != nullptr) {
+        head->expire_prev = &node;
+    }
+    head = &node;
+}
+
+// See SimpleLRU.h
+void SimpleLRU::UnlinkExpire(lru_node &node) {
+    if (node.expire == clock::time_point::max()) {
+        return;
+    }
+
+    if (node.expire_prev != nullptr) {
+        node.expire_prev->expire_next = node.expire_next;
+    } else {
+        auto it = _expire_index.find(ExpireBucket(node.expire));
+        if (node.expire_next != nullptr) {
+            it->second = node.expire_next;
+        } else {
+            _expire_index.erase(it);
+        }
+    }
+
+    if (node.expire_next != nullptr) {
+        node.expire_next->expire_prev = node.expire_prev;
+    }
+    node.expire_prev = node.expire_next = nullptr;
+}
+
+// See SimpleLRU.h
+void SimpleLRU::Evict() {
+    if (_size <= _max_size) {
+        Publish();
+        return;
+    }
+
+    SweepExpired(kSweepOnEvict);
+    const clock::time_point now = clock::now();
+    while (_size > _max_size) {
+        if (_lru_head->expire > now) {
+            AFINA_PROBE2(storage_evict, _lru_head->key.size(), _lru_head->value.size());
+            _evictions++;
+        }
+        Remove(*_lru_head);
+    }
+}
+
+// See SimpleLRU.h
+void SimpleLRU::Publish() { _gauges.Publish(_lru_index.size(), _size, _evictions); }
+
+// See SimpleLRU.h
+void SimpleLRU::Preserve(const lru_node &node) {
+    if (!_snapshot_active || _snapshot_done || node.version > _snapshot_version) {
+        return;
+    } else if (_snapshot_started && node.key <= _snapshot_cursor) {
+        return;
+    } else if (node.expire != clock::time_point::max() && node.expire <= clock::now()) {
+        return;
+    }
+    _snapshot_preserved.push_back(snapshot_item{node.key, node.value, node.expire});
+}
 
 } // namespace Backend
 } // namespace Afina
@@ -1,12 +1,16 @@
 #ifndef AFINA_STORAGE_SIMPLE_LRU_H
 #define AFINA_STORAGE_SIMPLE_LRU_H
 
+#include <chrono>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include <afina/Storage.h>
+#include <afina/metrics/StorageGauges.h>
 
 namespace Afina {
 namespace Backend {
@@ -14,52 +18,194 @@ namespace Backend {
 /**
  * # Map based implementation
  * That is NOT thread safe implementaiton!!
+ *
+ * Each item could have expiration time. Expired items are never returned, they are removed
+ * either lazily once someone access them or by SweepExpired which reclaims them in bounded
+ * slices in order of expiration
+ *
+ * Every change stamps the node with the next version number, so snapshot could tell nodes it must
+ * see from ones changed after it started. Snapshot walks the index in key order, batch by batch;
+ * node of the snapshot that is about to change or go away before snapshot reached it is copied
+ * aside first, so snapshot sees the old state of it
  */
 class SimpleLRU : public Afina::Storage {
 public:
-    SimpleLRU(size_t max_size = 1024) : _max_size(max_size) {}
-
-    ~SimpleLRU() {
-        _lru_index.clear();
-        _lru_head.reset(); // TODO: Here is stack overflow
+    SimpleLRU(size_t max_size = 1024)
+        : _max_size(max_size), _size(0), _evictions(0), _lru_tail(nullptr), _version(0), _snapshot_active(false),
+          _snapshot_started(false), _snapshot_done(false), _snapshot_version(0) {
+        _gauges.limit_maxbytes.Set(max_size);
     }
 
+    ~SimpleLRU();
+
     // Implements Afina::Storage interface
     bool Put(const std::string &key, const std::string &value) override;
 
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, int32_t ttl) override;
+
     // Implements Afina::Storage interface
     bool PutIfAbsent(const std::string &key, const std::string &value) override;
 
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) override;
+
     // Implements Afina::Storage interface
     bool Set(const std::string &key, const std::string &value) override;
 
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, int32_t ttl) override;
+
     // Implements Afina::Storage interface
     bool Delete(const std::string &key) override;
 
     // Implements Afina::Storage interface
     bool Get(const std::string &key, std::string &value) override;
 
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override;
+
+    // Implements Afina::Storage interface
+    bool Snapshot(const SnapshotWriter &writer) override;
+
+    // Implements Afina::Storage interface
+    void Stats(const std::string &group, const StatWriter &writer) override;
+
+    // Implements Afina::Storage interface
+    const Metrics::StorageGauges *Gauges() const override { return &_gauges; }
+
+    /**
+     * Removes at most max_items expired items, oldest expiration first. Returns number of items
+     * removed, so caller could repeat while it gets full slices
+     */
+    std::size_t SweepExpired(std::size_t max_items);
+
+protected:
+    using clock = std::chrono::steady_clock;
+
+    // Number of items snapshot takes at once
+    static constexpr std::size_t kSnapshotBatch = 128;
+
+    // Copy of item taken by snapshot
+    struct snapshot_item {
+        std::string key;
+        std::string value;
+        clock::time_point expire;
+    };
+
+    /**
+     * Starts snapshot of the current state, returns false if another one is running. Between
+     * SnapshotBegin and SnapshotEnd storage could be changed freely, SnapshotNext still returns
+     * items as they were once snapshot started
+     */
+    bool SnapshotBegin();
+
+    /**
+     * Replaces content of out with the next batch of about max_items snapshot items. Returns
+     * false once this batch is the last one
+     */
+    bool SnapshotNext(std::size_t max_items, std::vector<snapshot_item> &out);
+
+    // Finishes snapshot and drops items it didn't take
+    void SnapshotEnd();
+
+    // Passes snapshot items to the writer, returns false if writer stopped
+    static bool WriteSnapshot(const std::vector<snapshot_item> &items, const SnapshotWriter &writer);
+
 private:
     // LRU cache node
     using lru_node = struct lru_node {
         std::string key;
         std::string value;
-        std::unique_ptr<lru_node> prev;
+
+        // Time point after which node is expired, time_point::max() if node never expires
+        clock::time_point expire;
+
+        lru_node *prev;
         std::unique_ptr<lru_node> next;
+
+        // Neighbours in the expiration bucket, see _expire_index
+        lru_node *expire_prev;
+        lru_node *expire_next;
+
+        // Value of _version once node was changed last time
+        uint64_t version;
     };
 
+    // Number of expiration bucket the time point belongs to
+    static int64_t ExpireBucket(clock::time_point time);
+
+    // Finds node for the key, expired node is removed and never returned
+    lru_node *Lookup(const std::string &key);
+
+    // Creates new node in the fresh end of the list
+    void Insert(const std::string &key, const std::string &value, clock::time_point expire);
+
+    // Replaces value and expiration time of the existing node, moves it to the fresh end
+    void Update(lru_node &node, const std::string &value, clock::time_point expire);
+
+    // Removes node from all indexes and destroys it
+    void Remove(lru_node &node);
+
+    // Moves node to the fresh end of the list
+    void MoveToTail(lru_node &node);
+
+    // Adds/removes node to/from the expiration index
+    void LinkExpire(lru_node &node);
+    void UnlinkExpire(lru_node &node);
+
+    // Evicts nodes until cache fits into _max_size, expired nodes go first
+    void Evict();
+
+    // Sets gauges to the current state, called on every change
+    void Publish();
+
+    // Copies node aside if running snapshot must see it and is yet to reach it. Called before
+    // node gets changed or removed
+    void Preserve(const lru_node &node);
+
     // Maximum number of bytes could be stored in this cache.
     // i.e all (keys+values) must be less the _max_size
     std::size_t _max_size;
 
+    // Number of bytes currently stored in the cache
+    std::size_t _size;
+
+    // Number of live nodes evicted to make room
+    uint64_t _evictions;
+
+    // Occupancy for the exporter
+    Metrics::StorageGauges _gauges;
+
     // Main storage of lru_nodes, elements in this list ordered descending by "freshness": in the head
     // element that wasn't used for longest time.
     //
     // List owns all nodes
     std::unique_ptr<lru_node> _lru_head;
+    lru_node *_lru_tail;
 
     // Index of nodes from list above, allows fast random access to elements by lru_node#key
-    std::map<std::reference_wrapper<std::string>, std::reference_wrapper<lru_node>, std::less<std::string>> _lru_index;
+    std::map<std::reference_wrapper<const std::string>, std::reference_wrapper<lru_node>, std::less<std::string>>
+        _lru_index;
+
+    // Index of nodes that could expire: each second of the clock has its own bucket which is an
+    // intrusive list of nodes expiring during that second. Buckets are ordered, so sweeper takes
+    // nodes from the front without looking at ones that are still alive
+    std::map<int64_t, lru_node *> _expire_index;
+
+    // Number of changes made so far
+    uint64_t _version;
+
+    // Running snapshot sees nodes of versions up to _snapshot_version. Nodes with keys up to
+    // _snapshot_cursor are already taken, or all of them once _snapshot_done is set
+    bool _snapshot_active;
+    bool _snapshot_started;
+    bool _snapshot_done;
+    uint64_t _snapshot_version;
+    std::string _snapshot_cursor;
+
+    // Snapshot nodes changed before snapshot reached them
+    std::vector<snapshot_item> _snapshot_preserved;
 };
 
 } // namespace Backend
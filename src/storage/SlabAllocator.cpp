@@ -0,0 +1,210 @@
+#include "SlabAllocator.h"
+
+#include <algorithm>
+
+#include "Persist.h"
+
+namespace Afina {
+namespace Backend {
+
+// Chunks are aligned to pointer size, so item headers placed in them are aligned as well
+static const std::size_t kAlignment = sizeof(void *);
+
+static std::size_t Align(std::size_t size) { return (size + kAlignment - 1) / kAlignment * kAlignment; }
+
+SlabAllocator::SlabAllocator(std::unique_ptr<Afina::Allocator::Arena> arena, std::size_t page_size,
+                             std::size_t min_chunk, double factor)
+    : _page_size(page_size), _arena(std::move(arena)), _base(static_cast<char *>(_arena->base())) {
+    const std::size_t pages = _arena->size() / _page_size;
+    _pages.resize(pages, page_info{-1, 0, {}});
+    for (std::size_t i = pages; i > 0; i--) {
+        _free_pages.push_back(i - 1);
+    }
+
+    std::size_t chunk_size = Align(std::max(min_chunk, sizeof(void *)));
+    while (chunk_size < _page_size) {
+        _classes.push_back(size_class{chunk_size, _page_size / chunk_size, {}, nullptr, 0});
+        chunk_size = std::max(chunk_size + kAlignment, Align(std::size_t(chunk_size * factor)));
+    }
+    _classes.push_back(size_class{_page_size, 1, {}, nullptr, 0});
+}
+
+// See SlabAllocator.h
+int SlabAllocator::SizeClass(std::size_t size) const {
+    if (size > _page_size) {
+        return -1;
+    }
+
+    auto it = std::lower_bound(_classes.begin(), _classes.end(), size,
+                               [](const size_class &cls, std::size_t size) { return cls.chunk_size < size; });
+    return int(it - _classes.begin());
+}
+
+// See SlabAllocator.h
+void *SlabAllocator::Alloc(int cls) {
+    size_class &sc = _classes[cls];
+    if (sc.free_list != nullptr) {
+        void *chunk = sc.free_list;
+        sc.free_list = *static_cast<void **>(chunk);
+
+        std::size_t page = PageOf(chunk);
+        _pages[page].used[(static_cast<char *>(chunk) - Chunk(page, 0, 0)) / sc.chunk_size] = true;
+        sc.used++;
+        return chunk;
+    }
+
+    if (sc.pages.empty() || _pages[sc.pages.back()].carved == sc.chunks_per_page) {
+        if (_free_pages.empty()) {
+            return nullptr;
+        }
+
+        std::size_t page = _free_pages.back();
+        _free_pages.pop_back();
+        _pages[page].cls = cls;
+        _pages[page].carved = 0;
+        _pages[page].used.assign(sc.chunks_per_page, false);
+        sc.pages.push_back(page);
+    }
+
+    std::size_t page = sc.pages.back();
+    page_info &info = _pages[page];
+    info.used[info.carved] = true;
+    sc.used++;
+    return Chunk(page, info.carved++, sc.chunk_size);
+}
+
+// See SlabAllocator.h
+void SlabAllocator::Free(void *chunk) {
+    std::size_t page = PageOf(chunk);
+    size_class &sc = _classes[_pages[page].cls];
+    _pages[page].used[(static_cast<char *>(chunk) - Chunk(page, 0, 0)) / sc.chunk_size] = false;
+    sc.used--;
+
+    *static_cast<void **>(chunk) = sc.free_list;
+    sc.free_list = chunk;
+}
+
+// See SlabAllocator.h
+void SlabAllocator::ReleasePage(std::size_t page, const std::function<void(void *)> &evict) {
+    page_info &info = _pages[page];
+    size_class &sc = _classes[info.cls];
+    for (std::size_t i = 0; i < info.carved; i++) {
+        if (info.used[i]) {
+            evict(Chunk(page, i, sc.chunk_size));
+        }
+    }
+
+    // Drop chunks of the page from free list, keeping order of the rest
+    void **link = &sc.free_list;
+    while (*link != nullptr) {
+        if (PageOf(*link) == page) {
+            *link = *static_cast<void **>(*link);
+        } else {
+            link = static_cast<void **>(*link);
+        }
+    }
+
+    sc.pages.erase(std::find(sc.pages.begin(), sc.pages.end(), page));
+    info.cls = -1;
+    info.carved = 0;
+    info.used.clear();
+    _free_pages.push_back(page);
+}
+
+// See SlabAllocator.h
+void SlabAllocator::Save(std::string &out) const {
+    PersistPut(out, uint64_t(_pages.size()));
+    PersistPut(out, uint64_t(_classes.size()));
+    for (auto &info : _pages) {
+        PersistPut(out, int32_t(info.cls));
+        PersistPut(out, uint64_t(info.carved));
+        for (std::size_t i = 0; i < info.carved; i += 8) {
+            uint8_t bits = 0;
+            for (std::size_t j = i; j < info.carved && j < i + 8; j++) {
+                bits |= uint8_t(info.used[j]) << (j - i);
+            }
+            PersistPut(out, bits);
+        }
+    }
+
+    for (auto &sc : _classes) {
+        PersistPut(out, uint64_t(sc.used));
+        PersistPut(out, reinterpret_cast<uint64_t>(sc.free_list));
+        PersistPut(out, uint64_t(sc.pages.size()));
+        for (std::size_t page : sc.pages) {
+            PersistPut(out, uint64_t(page));
+        }
+    }
+
+    PersistPut(out, uint64_t(_free_pages.size()));
+    for (std::size_t page : _free_pages) {
+        PersistPut(out, uint64_t(page));
+    }
+}
+
+// See SlabAllocator.h
+bool SlabAllocator::Load(const char *&data, const char *end) {
+    uint64_t pages, classes;
+    if (!PersistGet(data, end, pages) || !PersistGet(data, end, classes) || pages != _pages.size() ||
+        classes != _classes.size()) {
+        return false;
+    }
+
+    for (auto &info : _pages) {
+        int32_t cls;
+        uint64_t carved;
+        if (!PersistGet(data, end, cls) || !PersistGet(data, end, carved) || cls < -1 || cls >= int32_t(classes) ||
+            (cls < 0 && carved != 0) || (cls >= 0 && carved > _classes[cls].chunks_per_page)) {
+            return false;
+        }
+
+        info.cls = cls;
+        info.carved = carved;
+        info.used.assign(cls >= 0 ? _classes[cls].chunks_per_page : 0, false);
+        for (std::size_t i = 0; i < carved; i += 8) {
+            uint8_t bits;
+            if (!PersistGet(data, end, bits)) {
+                return false;
+            }
+            for (std::size_t j = i; j < carved && j < i + 8; j++) {
+                info.used[j] = (bits >> (j - i)) & 1;
+            }
+        }
+    }
+
+    for (auto &sc : _classes) {
+        uint64_t used, free_list, count;
+        if (!PersistGet(data, end, used) || !PersistGet(data, end, free_list) || !PersistGet(data, end, count) ||
+            count > pages) {
+            return false;
+        }
+
+        sc.used = used;
+        sc.free_list = reinterpret_cast<void *>(free_list);
+        sc.pages.resize(count);
+        for (auto &page : sc.pages) {
+            uint64_t index;
+            if (!PersistGet(data, end, index) || index >= pages || _pages[index].cls != &sc - &_classes[0]) {
+                return false;
+            }
+            page = index;
+        }
+    }
+
+    uint64_t count;
+    if (!PersistGet(data, end, count) || count > pages) {
+        return false;
+    }
+    _free_pages.resize(count);
+    for (auto &page : _free_pages) {
+        uint64_t index;
+        if (!PersistGet(data, end, index) || index >= pages || _pages[index].cls != -1) {
+            return false;
+        }
+        page = index;
+    }
+    return true;
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,140 @@
+#ifndef AFINA_STORAGE_SLAB_ALLOCATOR_H
+#define AFINA_STORAGE_SLAB_ALLOCATOR_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/allocator/Arena.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Slab allocator
+ * Memory of the given arena is split into equal pages. Each page, once taken, belongs to a single
+ * size class and is cut into chunks of that class. Chunk sizes grow geometrically from the minimal
+ * one up to the page size, so any allocation wastes at most factor - 1 of its chunk.
+ *
+ * Pages are cut from an Arena, so they could be backed by huge pages, prefaulted or mapped from
+ * file. In the latter case state of the allocator could be saved next to the pages and loaded back
+ * once the file is mapped at the same address again.
+ *
+ * Freed chunks are reused by the same class only. Pages move between classes only explicitly, by
+ * ReleasePage, which asks owner of the memory to give up chunks still in use.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class SlabAllocator {
+public:
+    /**
+     * @param arena memory to cut pages from, as many pages as fit into it
+     * @param page_size size of a page, multiple of pointer size
+     * @param min_chunk size of chunks of the smallest class
+     */
+    SlabAllocator(std::unique_ptr<Afina::Allocator::Arena> arena, std::size_t page_size, std::size_t min_chunk,
+                  double factor = 1.25);
+    ~SlabAllocator() {}
+
+    // Number of size classes
+    std::size_t Classes() const { return _classes.size(); }
+
+    // Smallest class with chunks of at least size bytes, -1 if size is larger than a page
+    int SizeClass(std::size_t size) const;
+
+    // Size of chunks in class
+    std::size_t ChunkSize(int cls) const { return _classes[cls].chunk_size; }
+
+    // Returns chunk of the class, nullptr if class has no free chunks and no page is left for it
+    void *Alloc(int cls);
+
+    // Returns chunk to its class
+    void Free(void *chunk);
+
+    // Page chunk belongs to
+    std::size_t PageOf(const void *chunk) const {
+        return (static_cast<const char *>(chunk) - _base) / _page_size;
+    }
+
+    // Pages owned by the class
+    const std::vector<std::size_t> &Pages(int cls) const { return _classes[cls].pages; }
+
+    // Class that owns the page, -1 for free page
+    int PageClass(std::size_t page) const { return _pages[page].cls; }
+
+    // Start of the page
+    const char *PageData(std::size_t page) const { return _base + page * _page_size; }
+
+    // Bytes at the start of the page cut into chunks so far, the rest of it was never written
+    std::size_t PageUsed(std::size_t page) const {
+        const page_info &info = _pages[page];
+        return info.cls < 0 ? 0 : info.carved * _classes[info.cls].chunk_size;
+    }
+
+    // Takes page away from its class back into the pool of free pages. Every chunk of the page
+    // still in use is passed to evict, which must Free it
+    void ReleasePage(std::size_t page, const std::function<void(void *)> &evict);
+
+    // Number of chunks of the class in use
+    std::size_t UsedChunks(int cls) const { return _classes[cls].used; }
+
+    // Number of pages not owned by any class
+    std::size_t FreePages() const { return _free_pages.size(); }
+
+    // Memory pages are cut from
+    Afina::Allocator::Arena &Memory() const { return *_arena; }
+
+    // Appends state of pages and classes to the buffer
+    void Save(std::string &out) const;
+
+    // Restores state written by Save and moves data past it. Returns false if state doesn't
+    // match allocator layout, allocator must not be used then
+    bool Load(const char *&data, const char *end);
+
+    std::size_t PageSize() const { return _page_size; }
+    std::size_t TotalPages() const { return _pages.size(); }
+
+private:
+    struct page_info {
+        // Class that owns the page, -1 for free page
+        int cls;
+
+        // Number of chunks cut from the page so far, chunks are cut one by one on demand
+        std::size_t carved;
+
+        // Chunks in use
+        std::vector<bool> used;
+    };
+
+    struct size_class {
+        std::size_t chunk_size;
+        std::size_t chunks_per_page;
+
+        // Pages owned, the last one is the page chunks are being cut from
+        std::vector<std::size_t> pages;
+
+        // Free chunks, linked through their first bytes
+        void *free_list;
+
+        std::size_t used;
+    };
+
+    char *Chunk(std::size_t page, std::size_t index, std::size_t chunk_size) const {
+        return _base + page * _page_size + index * chunk_size;
+    }
+
+    const std::size_t _page_size;
+
+    std::unique_ptr<Afina::Allocator::Arena> _arena;
+    char *const _base;
+    std::vector<page_info> _pages;
+    std::vector<std::size_t> _free_pages;
+    std::vector<size_class> _classes;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SLAB_ALLOCATOR_H
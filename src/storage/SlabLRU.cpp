@@ -0,0 +1,662 @@
+#include "SlabLRU.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <afina/allocator/Error.h>
+#include <afina/metrics/Probes.h>
+
+#include "Persist.h"
+
+namespace Afina {
+namespace Backend {
+
+// Page size is picked so that cache has at least that many pages, within the limits below
+static const std::size_t kAutoPages = 16;
+static const std::size_t kMinPageSize = 256;
+static const std::size_t kMaxPageSize = 1 << 20;
+
+// Number of evictions between automover runs
+static const uint64_t kAutomoveWindow = 128;
+
+static const std::size_t kInitialBuckets = 16;
+
+// Persistence file: header, then pages, then allocator and LRU state. Header takes the largest
+// system page size around, so that pages could be mapped right from the file
+static const std::size_t kHeaderSize = 64 * 1024;
+static const char kFileMagic[8] = {'A', 'F', 'I', 'N', 'A', 'S', 'L', 'B'};
+static const uint32_t kFileVersion = 2;
+
+// Each page is followed in metadata by the number of bytes in use and their checksum
+static const std::size_t kPageTrailer = 2 * sizeof(uint64_t);
+
+struct file_header {
+    char magic[8];
+    uint32_t version;
+
+    // Set once cache is flushed, reset once it is attached
+    uint32_t clean;
+
+    // Layout, file could be attached only by cache of the same one
+    uint64_t page_size;
+    uint64_t pages;
+    uint64_t item_size;
+
+    // Address pages were mapped at, items point to each other by it
+    uint64_t base;
+
+    uint64_t meta_size;
+    uint64_t meta_checksum;
+
+    // Cache time and wall clock time of the flush
+    int64_t cache_time;
+    int64_t system_time;
+
+    // Checksum of all the fields above
+    uint64_t checksum;
+};
+
+// Wall clock time in nanoseconds
+static int64_t SystemTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// Page size as requested or picked from max_size, aligned to hold chunks
+static std::size_t PageSize(std::size_t max_size, std::size_t page_size, std::size_t min_chunk) {
+    if (page_size == 0) {
+        page_size = std::min(kMaxPageSize, std::max(kMinPageSize, max_size / kAutoPages));
+    }
+    return (std::max(page_size, min_chunk) + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+}
+
+SlabLRU::SlabLRU(size_t max_size, const Options &options)
+    : _page_size(PageSize(max_size, options.page_size, sizeof(item) + 8)), _fd(-1), _restored(false),
+      _clock_shift(0) {
+    const std::size_t pages = std::max<std::size_t>(1, max_size / _page_size);
+    if (options.path.empty()) {
+        Reset(std::unique_ptr<Allocator::Arena>(
+            new Allocator::Arena(pages * _page_size, options.huge_pages, options.prefault)));
+        return;
+    }
+
+    _fd = open(options.path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (_fd < 0) {
+        throw std::runtime_error("Failed to open " + options.path + ": " + std::strerror(errno));
+    }
+
+    _restored = Attach(pages, options.prefault);
+    if (!_restored) {
+        // Start from scratch, old pages are dropped so that they don't take disk space
+        if (ftruncate(_fd, 0) != 0 || ftruncate(_fd, kHeaderSize + pages * _page_size) != 0) {
+            close(_fd);
+            throw std::runtime_error("Failed to resize " + options.path + ": " + std::strerror(errno));
+        }
+        Reset(std::unique_ptr<Allocator::Arena>(
+            new Allocator::Arena(_fd, kHeaderSize, pages * _page_size, nullptr, options.prefault)));
+    }
+
+    // Until the next flush file content doesn't match the header
+    WriteHeader(false, 0, 0);
+}
+
+SlabLRU::~SlabLRU() {
+    if (_fd >= 0) {
+        close(_fd);
+    }
+}
+
+// See SlabLRU.h
+void SlabLRU::Stop() {
+    if (_fd < 0) {
+        return;
+    }
+
+    std::string meta;
+    _slabs->Save(meta);
+    Save(meta);
+    for (std::size_t page = 0; page < _slabs->TotalPages(); page++) {
+        const std::size_t used = _slabs->PageUsed(page);
+        PersistPut(meta, uint64_t(used));
+        PersistPut(meta, Checksum(_slabs->PageData(page), used));
+    }
+
+    _slabs->Memory().sync();
+    const off_t meta_offset = kHeaderSize + _slabs->TotalPages() * _page_size;
+    if (pwrite(_fd, meta.data(), meta.size(), meta_offset) != ssize_t(meta.size()) ||
+        ftruncate(_fd, meta_offset + meta.size()) != 0) {
+        throw std::runtime_error(std::string("Failed to flush cache: ") + std::strerror(errno));
+    }
+    WriteHeader(true, meta.size(), Checksum(meta.data(), meta.size()));
+}
+
+// See SlabLRU.h
+bool SlabLRU::Put(const std::string &key, const std::string &value) { return SlabLRU::Put(key, value, 0); }
+
+// See SlabLRU.h
+bool SlabLRU::Put(const std::string &key, const std::string &value, int32_t ttl) {
+    if (ItemClass(key, value) < 0) {
+        return false;
+    }
+
+    item *it = Lookup(key);
+    if (it != nullptr) {
+        return Update(it, value, Deadline(ttl, Now()));
+    }
+    return Insert(key, value, Deadline(ttl, Now()));
+}
+
+// See SlabLRU.h
+bool SlabLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return SlabLRU::PutIfAbsent(key, value, 0);
+}
+
+// See SlabLRU.h
+bool SlabLRU::PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) {
+    if (ItemClass(key, value) < 0 || Lookup(key) != nullptr) {
+        return false;
+    }
+    return Insert(key, value, Deadline(ttl, Now()));
+}
+
+// See SlabLRU.h
+bool SlabLRU::Set(const std::string &key, const std::string &value) {
+    if (ItemClass(key, value) < 0) {
+        return false;
+    }
+
+    item *it = Lookup(key);
+    if (it == nullptr) {
+        return false;
+    }
+    return Update(it, value, it->expire);
+}
+
+// See SlabLRU.h
+bool SlabLRU::Set(const std::string &key, const std::string &value, int32_t ttl) {
+    if (ItemClass(key, value) < 0) {
+        return false;
+    }
+
+    item *it = Lookup(key);
+    if (it == nullptr) {
+        return false;
+    }
+    return Update(it, value, Deadline(ttl, Now()));
+}
+
+// See SlabLRU.h
+bool SlabLRU::Delete(const std::string &key) {
+    item *it = Lookup(key);
+    if (it == nullptr) {
+        return false;
+    }
+    Remove(it);
+    return true;
+}
+
+// See SlabLRU.h
+bool SlabLRU::Get(const std::string &key, std::string &value) {
+    clock::time_point expire;
+    return SlabLRU::Get(key, value, expire);
+}
+
+// See SlabLRU.h
+bool SlabLRU::Get(const std::string &key, std::string &value, clock::time_point &expire) {
+    item *it = Lookup(key);
+    if (it == nullptr) {
+        AFINA_PROBE3(storage_get, key.size(), 0, false);
+        return false;
+    }
+    value.assign(it->value(), it->value_size);
+    // Expiration is kept in time of the cache, see Now()
+    expire = it->expire == clock::time_point::max() ? it->expire : it->expire - _clock_shift;
+    Touch(it);
+    AFINA_PROBE3(storage_get, key.size(), value.size(), true);
+    return true;
+}
+
+// See SlabLRU.h
+void SlabLRU::Stats(const std::string &group, const StatWriter &writer) {
+    const SlabAllocator &slabs = *_slabs;
+    const int classes = slabs.Classes();
+
+    // Classes are numbered from 1, as memcached does
+    if (group.empty()) {
+        uint64_t bytes = 0, evictions = 0;
+        for (int cls = 0; cls < classes; cls++) {
+            bytes += slabs.UsedChunks(cls) * slabs.ChunkSize(cls);
+            evictions += _lru[cls].evictions;
+        }
+        writer("curr_items", _items);
+        writer("bytes", bytes);
+        writer("limit_maxbytes", slabs.TotalPages() * _page_size);
+        writer("evictions", evictions);
+        writer("slabs_moved", _pages_moved);
+    } else if (group == "items") {
+        for (int cls = 0; cls < classes; cls++) {
+            if (_lru[cls].items > 0 || _lru[cls].evictions > 0) {
+                const std::string prefix = "items:" + std::to_string(cls + 1) + ":";
+                writer(prefix + "number", _lru[cls].items);
+                writer(prefix + "evicted", _lru[cls].evictions);
+            }
+        }
+    } else if (group == "slabs") {
+        std::size_t active = 0;
+        for (int cls = 0; cls < classes; cls++) {
+            const std::size_t pages = slabs.Pages(cls).size();
+            if (pages == 0) {
+                continue;
+            }
+
+            const std::size_t per_page = _page_size / slabs.ChunkSize(cls);
+            const std::string prefix = std::to_string(cls + 1) + ":";
+            writer(prefix + "chunk_size", slabs.ChunkSize(cls));
+            writer(prefix + "chunks_per_page", per_page);
+            writer(prefix + "total_pages", pages);
+            writer(prefix + "total_chunks", pages * per_page);
+            writer(prefix + "used_chunks", slabs.UsedChunks(cls));
+            writer(prefix + "free_chunks", pages * per_page - slabs.UsedChunks(cls));
+            active++;
+        }
+        writer("active_slabs", active);
+        writer("total_malloced", (slabs.TotalPages() - slabs.FreePages()) * _page_size);
+    }
+}
+
+// See SlabLRU.h
+void SlabLRU::Reset(std::unique_ptr<Allocator::Arena> arena) {
+    _slabs.reset(new SlabAllocator(std::move(arena), _page_size, sizeof(item) + 8));
+    _lru.assign(_slabs->Classes(), lru_list{nullptr, nullptr, 0, 0, 0});
+    _buckets.assign(kInitialBuckets, nullptr);
+    _items = 0;
+    _window_evictions = 0;
+    _pages_moved = 0;
+    _bytes = 0;
+    _evictions = 0;
+
+    _gauges.classes = std::min(int(_slabs->Classes()), int(Metrics::StorageGauges::kClasses));
+    _gauges.limit_maxbytes.Set(_slabs->TotalPages() * _page_size);
+    for (int cls = 0; cls < _gauges.classes; cls++) {
+        _gauges.size_classes[cls].chunk_size.Set(_slabs->ChunkSize(cls));
+        Publish(cls);
+    }
+}
+
+// See SlabLRU.h
+bool SlabLRU::Attach(std::size_t pages, bool prefault) {
+    file_header header;
+    if (pread(_fd, &header, sizeof(header), 0) != sizeof(header) ||
+        std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0 || header.version != kFileVersion ||
+        header.checksum != Checksum(&header, offsetof(file_header, checksum)) || !header.clean ||
+        header.page_size != _page_size || header.pages != pages || header.item_size != sizeof(item)) {
+        return false;
+    }
+
+    std::string meta(header.meta_size, '\0');
+    const off_t meta_offset = kHeaderSize + pages * _page_size;
+    if (header.meta_size < pages * kPageTrailer ||
+        pread(_fd, &meta[0], meta.size(), meta_offset) != ssize_t(meta.size()) ||
+        Checksum(meta.data(), meta.size()) != header.meta_checksum) {
+        return false;
+    }
+
+    std::unique_ptr<Allocator::Arena> arena;
+    try {
+        void *base = reinterpret_cast<void *>(header.base);
+        arena.reset(new Allocator::Arena(_fd, kHeaderSize, pages * _page_size, base, prefault));
+    } catch (const Allocator::AllocError &) {
+        return false;
+    }
+
+    // Page checksums are at the end of metadata and cover the part of each page cut into chunks:
+    // every item with its key and value, as well as links of free chunks
+    const char *page_checksums = meta.data() + meta.size() - pages * kPageTrailer;
+    const char *page_data = static_cast<const char *>(arena->base());
+    const char *trailer = page_checksums;
+    for (std::size_t page = 0; page < pages; page++) {
+        uint64_t used, expected;
+        PersistGet(trailer, meta.data() + meta.size(), used);
+        PersistGet(trailer, meta.data() + meta.size(), expected);
+        if (used > _page_size || Checksum(page_data + page * _page_size, used) != expected) {
+            return false;
+        }
+    }
+
+    Reset(std::move(arena));
+    const char *data = meta.data();
+    if (!_slabs->Load(data, page_checksums) || !Load(data, page_checksums)) {
+        // Unmap pages before the caller truncates the file under them
+        _slabs.reset();
+        return false;
+    }
+
+    // Totals are not saved, they follow from the restored state
+    for (int cls = 0; cls < int(_lru.size()); cls++) {
+        _bytes += _slabs->UsedChunks(cls) * _slabs->ChunkSize(cls);
+        _evictions += _lru[cls].evictions;
+    }
+    for (int cls = 0; cls < _gauges.classes; cls++) {
+        Publish(cls);
+    }
+
+    // Time spent down counts towards expiration
+    const int64_t down = SystemTime() - header.system_time;
+    const clock::duration cache_time = std::chrono::nanoseconds(header.cache_time + std::max<int64_t>(0, down));
+    _clock_shift = cache_time - clock::now().time_since_epoch();
+    return true;
+}
+
+// See SlabLRU.h
+void SlabLRU::Save(std::string &out) const {
+    for (auto &lru : _lru) {
+        PersistPut(out, reinterpret_cast<uint64_t>(lru.head));
+        PersistPut(out, reinterpret_cast<uint64_t>(lru.tail));
+        PersistPut(out, uint64_t(lru.items));
+        PersistPut(out, lru.evictions);
+    }
+
+    PersistPut(out, uint64_t(_items));
+    PersistPut(out, _pages_moved);
+    PersistPut(out, uint64_t(_buckets.size()));
+    out.append(reinterpret_cast<const char *>(_buckets.data()), _buckets.size() * sizeof(item *));
+}
+
+// See SlabLRU.h
+bool SlabLRU::Load(const char *&data, const char *end) {
+    for (auto &lru : _lru) {
+        uint64_t head, tail, items;
+        if (!PersistGet(data, end, head) || !PersistGet(data, end, tail) || !PersistGet(data, end, items) ||
+            !PersistGet(data, end, lru.evictions)) {
+            return false;
+        }
+        lru.head = reinterpret_cast<item *>(head);
+        lru.tail = reinterpret_cast<item *>(tail);
+        lru.items = items;
+    }
+
+    uint64_t items, buckets;
+    if (!PersistGet(data, end, items) || !PersistGet(data, end, _pages_moved) || !PersistGet(data, end, buckets) ||
+        buckets == 0 || (buckets & (buckets - 1)) != 0 || std::size_t(end - data) != buckets * sizeof(item *)) {
+        return false;
+    }
+    _items = items;
+    _buckets.resize(buckets);
+    std::memcpy(_buckets.data(), data, buckets * sizeof(item *));
+    data = end;
+    return true;
+}
+
+// See SlabLRU.h
+void SlabLRU::WriteHeader(bool clean, uint64_t meta_size, uint64_t meta_checksum) {
+    file_header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    header.version = kFileVersion;
+    header.clean = clean;
+    header.page_size = _page_size;
+    header.pages = _slabs->TotalPages();
+    header.item_size = sizeof(item);
+    header.base = reinterpret_cast<uint64_t>(_slabs->Memory().base());
+    header.meta_size = meta_size;
+    header.meta_checksum = meta_checksum;
+    header.cache_time = std::chrono::duration_cast<std::chrono::nanoseconds>(Now().time_since_epoch()).count();
+    header.system_time = SystemTime();
+    header.checksum = Checksum(&header, offsetof(file_header, checksum));
+
+    if (pwrite(_fd, &header, sizeof(header), 0) != sizeof(header) || fsync(_fd) != 0) {
+        throw std::runtime_error(std::string("Failed to write cache header: ") + std::strerror(errno));
+    }
+}
+
+// See SlabLRU.h
+int SlabLRU::ItemClass(const std::string &key, const std::string &value) const {
+    return _slabs->SizeClass(sizeof(item) + key.size() + value.size());
+}
+
+// See SlabLRU.h
+SlabLRU::item *SlabLRU::Lookup(const std::string &key) {
+    const uint64_t hash = std::hash<std::string>()(key);
+    item *it = _buckets[hash & (_buckets.size() - 1)];
+    while (it != nullptr &&
+           (it->hash != hash || it->key_size != key.size() || std::memcmp(it->key(), key.data(), key.size()) != 0)) {
+        it = it->h_next;
+    }
+
+    if (it != nullptr && it->expire != clock::time_point::max() && it->expire <= Now()) {
+        Remove(it);
+        return nullptr;
+    }
+    return it;
+}
+
+// See SlabLRU.h
+bool SlabLRU::Insert(const std::string &key, const std::string &value, clock::time_point expire) {
+    const int cls = ItemClass(key, value);
+    void *chunk = AllocChunk(cls);
+    if (chunk == nullptr) {
+        return false;
+    }
+
+    item *it = new (chunk) item;
+    it->hash = std::hash<std::string>()(key);
+    it->expire = expire;
+    it->key_size = key.size();
+    it->value_size = value.size();
+    it->cls = cls;
+    std::memcpy(it->key(), key.data(), key.size());
+    std::memcpy(it->value(), value.data(), value.size());
+    Link(it);
+    AFINA_PROBE2(storage_put, key.size(), value.size());
+    return true;
+}
+
+// See SlabLRU.h
+bool SlabLRU::Update(item *it, const std::string &value, clock::time_point expire) {
+    const std::size_t size = sizeof(item) + it->key_size + value.size();
+    if (_slabs->SizeClass(size) == it->cls) {
+        AFINA_PROBE2(storage_put, it->key_size, value.size());
+        std::memcpy(it->value(), value.data(), value.size());
+        it->value_size = value.size();
+        it->expire = expire;
+        Touch(it);
+        return true;
+    }
+
+    // Item moves to other class, allocation there must not evict it, so it goes away first
+    std::string key(it->key(), it->key_size);
+    Remove(it);
+    return Insert(key, value, expire);
+}
+
+// See SlabLRU.h
+void *SlabLRU::AllocChunk(int cls) {
+    while (true) {
+        void *chunk = _slabs->Alloc(cls);
+        if (chunk != nullptr) {
+            return chunk;
+        }
+
+        if (_lru[cls].tail != nullptr) {
+            Evict(cls);
+            continue;
+        }
+
+        // Class owns no pages at all, the one with most pages has to share
+        int victim = -1;
+        for (std::size_t i = 0; i < _lru.size(); i++) {
+            if (int(i) != cls && !_slabs->Pages(i).empty() &&
+                (victim < 0 || _slabs->Pages(i).size() > _slabs->Pages(victim).size())) {
+                victim = i;
+            }
+        }
+        if (victim < 0) {
+            return nullptr;
+        }
+        ReleaseOldestPage(victim);
+    }
+}
+
+// See SlabLRU.h
+void SlabLRU::Evict(int cls) {
+    lru_list &lru = _lru[cls];
+    AFINA_PROBE2(storage_evict, lru.tail->key_size, lru.tail->value_size);
+    Remove(lru.tail);
+    lru.evictions++;
+    lru.window_evictions++;
+    _evictions++;
+    Publish(cls);
+
+    if (++_window_evictions >= kAutomoveWindow) {
+        Automove();
+    }
+}
+
+// See SlabLRU.h
+void SlabLRU::ReleaseOldestPage(int cls) {
+    const lru_list &lru = _lru[cls];
+    std::size_t page = lru.tail != nullptr ? _slabs->PageOf(lru.tail) : _slabs->Pages(cls).front();
+    _slabs->ReleasePage(page, [this](void *chunk) {
+        item *it = static_cast<item *>(chunk);
+        AFINA_PROBE2(storage_evict, it->key_size, it->value_size);
+        _lru[it->cls].evictions++;
+        _evictions++;
+        Remove(it);
+    });
+    _pages_moved++;
+    Publish(cls);
+}
+
+// See SlabLRU.h
+void SlabLRU::Automove() {
+    int needy = -1;
+    int idle = -1;
+    for (std::size_t i = 0; i < _lru.size(); i++) {
+        if (_lru[i].window_evictions > 0) {
+            if (needy < 0 || _lru[i].window_evictions > _lru[needy].window_evictions) {
+                needy = i;
+            }
+        } else if (_slabs->Pages(i).size() > 1) {
+            // Class that fits into its pages gives one of them, the richest one goes first
+            if (idle < 0 || _slabs->Pages(i).size() > _slabs->Pages(idle).size()) {
+                idle = i;
+            }
+        }
+    }
+
+    for (auto &lru : _lru) {
+        lru.window_evictions = 0;
+    }
+    _window_evictions = 0;
+
+    if (needy >= 0 && idle >= 0) {
+        ReleaseOldestPage(idle);
+    }
+}
+
+// See SlabLRU.h
+void SlabLRU::Link(item *it) {
+    lru_list &lru = _lru[it->cls];
+    it->prev = nullptr;
+    it->next = lru.head;
+    if (lru.head != nullptr) {
+        lru.head->prev = it;
+    } else {
+        lru.tail = it;
+    }
+    lru.head = it;
+    lru.items++;
+    _bytes += _slabs->ChunkSize(it->cls);
+
+    item *&bucket = _buckets[it->hash & (_buckets.size() - 1)];
+    it->h_next = bucket;
+    bucket = it;
+    if (++_items > _buckets.size() / 2 * 3) {
+        Grow();
+    }
+    Publish(it->cls);
+}
+
+// See SlabLRU.h
+void SlabLRU::Unlink(item *it) {
+    lru_list &lru = _lru[it->cls];
+    (it->prev != nullptr ? it->prev->next : lru.head) = it->next;
+    (it->next != nullptr ? it->next->prev : lru.tail) = it->prev;
+    lru.items--;
+    _bytes -= _slabs->ChunkSize(it->cls);
+
+    item **link = &_buckets[it->hash & (_buckets.size() - 1)];
+    while (*link != it) {
+        link = &(*link)->h_next;
+    }
+    *link = it->h_next;
+    _items--;
+}
+
+// See SlabLRU.h
+void SlabLRU::Remove(item *it) {
+    const int cls = it->cls;
+    Unlink(it);
+    _slabs->Free(it);
+    Publish(cls);
+}
+
+// See SlabLRU.h
+void SlabLRU::Touch(item *it) {
+    lru_list &lru = _lru[it->cls];
+    if (lru.head == it) {
+        return;
+    }
+
+    it->prev->next = it->next;
+    (it->next != nullptr ? it->next->prev : lru.tail) = it->prev;
+    it->prev = nullptr;
+    it->next = lru.head;
+    lru.head->prev = it;
+    lru.head = it;
+}
+
+// See SlabLRU.h
+void SlabLRU::Grow() {
+    std::vector<item *> buckets(_buckets.size() * 2, nullptr);
+    for (item *head : _buckets) {
+        while (head != nullptr) {
+            item *next = head->h_next;
+            item *&bucket = buckets[head->hash & (buckets.size() - 1)];
+            head->h_next = bucket;
+            bucket = head;
+            head = next;
+        }
+    }
+    _buckets.swap(buckets);
+}
+
+// See SlabLRU.h
+void SlabLRU::Publish(int cls) {
+    _gauges.Publish(_items, _bytes, _evictions);
+    _gauges.slabs_moved.Set(_pages_moved);
+    _gauges.total_malloced.Set((_slabs->TotalPages() - _slabs->FreePages()) * _page_size);
+    if (cls >= _gauges.classes) {
+        return;
+    }
+
+    Metrics::StorageGauges::SizeClass &gauges = _gauges.size_classes[cls];
+    const std::size_t pages = _slabs->Pages(cls).size();
+    gauges.total_pages.Set(pages);
+    gauges.total_chunks.Set(pages * (_page_size / _slabs->ChunkSize(cls)));
+    gauges.used_chunks.Set(_slabs->UsedChunks(cls));
+    gauges.items.Set(_lru[cls].items);
+    gauges.evictions.Set(_lru[cls].evictions);
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,239 @@
+#ifndef AFINA_STORAGE_SLAB_LRU_H
+#define AFINA_STORAGE_SLAB_LRU_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/metrics/StorageGauges.h>
+
+#include "SlabAllocator.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # LRU cache on top of slab allocator
+ * That is NOT thread safe implementaiton!!
+ *
+ * Each item is a single chunk: header followed by key and value bytes. Chunks come from slab
+ * pages of geometric size classes, and every class has its own LRU list, so a new item evicts
+ * the least recently used item of the same size class. Index is a hash table chained through
+ * item headers, so storing an item takes no allocations besides its chunk.
+ *
+ * _max_size is the memory of slab pages, so it accounts for headers and chunk slack as well.
+ *
+ * Once workload changes its mix of item sizes, classes that evict a lot get pages from classes
+ * that don't evict at all: every kAutomoveWindow evictions automover releases the page holding
+ * the oldest item of an idle class
+ *
+ * With persistence file configured, slab pages are mapped from it. Stop flushes pages along with
+ * allocator and LRU state and checksums of page contents. Next instance opened on the file with the
+ * same layout maps pages at the same address, so that pointers inside items stay valid, and
+ * restores the state: cache comes back without reinserting items. If anything doesn't match,
+ * including an unclean shutdown, cache starts empty
+ */
+class SlabLRU : public Afina::Storage {
+public:
+    class Options {
+    public:
+        Options() : page_size(0), huge_pages(false), prefault(false) {}
+
+        // Size of slab pages, 0 picks one from max_size
+        std::size_t page_size;
+
+        // Back item memory with huge pages, see Allocator::Arena. Not used with persistence file
+        bool huge_pages;
+
+        // Touch all item memory in constructor
+        bool prefault;
+
+        // File to keep items in between restarts, empty means no persistence
+        std::string path;
+    };
+
+    /**
+     * @param max_size memory for items, in bytes
+     */
+    SlabLRU(size_t max_size = 1024, const Options &options = Options());
+    ~SlabLRU();
+
+    // Flushes cache into persistence file, if there is one
+    void Stop() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override;
+
+    // Implements Afina::Storage interface
+    void Stats(const std::string &group, const StatWriter &writer) override;
+
+    // Implements Afina::Storage interface
+    const Metrics::StorageGauges *Gauges() const override { return &_gauges; }
+
+    // Size class of the item, -1 if it doesn't fit into a page
+    int ItemClass(const std::string &key, const std::string &value) const;
+
+    // Pages and chunks of items
+    const SlabAllocator &Slabs() const { return *_slabs; }
+
+    // True if items were restored from persistence file
+    bool Restored() const { return _restored; }
+
+    // Number of items in size class
+    std::size_t Items(int cls) const { return _lru[cls].items; }
+
+    // Number of items evicted from size class
+    uint64_t Evictions(int cls) const { return _lru[cls].evictions; }
+
+    // Number of pages automover has moved between classes
+    uint64_t PagesMoved() const { return _pages_moved; }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    // Header of the item chunk, key and value bytes follow it
+    struct item {
+        // Neighbours in LRU list of the class, prev is the more recently used one
+        item *prev;
+        item *next;
+
+        // Next item in the same hash table bucket
+        item *h_next;
+
+        uint64_t hash;
+
+        // Time point after which item is expired, time_point::max() if item never expires
+        clock::time_point expire;
+
+        uint32_t key_size;
+        uint32_t value_size;
+        int cls;
+
+        char *key() { return reinterpret_cast<char *>(this + 1); }
+        char *value() { return key() + key_size; }
+    };
+
+    // Items of a size class, from the most recently used to the least one
+    struct lru_list {
+        item *head;
+        item *tail;
+        std::size_t items;
+        uint64_t evictions;
+
+        // Evictions since the last automover run
+        uint64_t window_evictions;
+    };
+
+    // Current time of the cache, it continues across restarts
+    clock::time_point Now() const { return clock::now() + _clock_shift; }
+
+    // Creates empty cache structures over the arena
+    void Reset(std::unique_ptr<Afina::Allocator::Arena> arena);
+
+    // Maps pages of persistence file and restores cache state, if file was cleanly flushed with the
+    // same layout. Returns false otherwise, nothing is mapped then
+    bool Attach(std::size_t pages, bool prefault);
+
+    // Appends LRU and index state to the buffer, Load restores it
+    void Save(std::string &out) const;
+    bool Load(const char *&data, const char *end);
+
+    // Writes persistence file header and waits until it gets to disk
+    void WriteHeader(bool clean, uint64_t meta_size, uint64_t meta_checksum);
+
+    // Finds live item for the key, expired item is removed
+    item *Lookup(const std::string &key);
+
+    // Stores new item, evicting items of its class when needed. Returns false if there is no room
+    bool Insert(const std::string &key, const std::string &value, clock::time_point expire);
+
+    // Replaces value and expiration time of the existing item, might move it to other class
+    bool Update(item *it, const std::string &value, clock::time_point expire);
+
+    // Allocates chunk for the class, evicting its items or taking page from other class
+    void *AllocChunk(int cls);
+
+    // Evicts the least recently used item of the class
+    void Evict(int cls);
+
+    // Frees page holding the oldest item of the class, chunks of the page could then go to any class
+    void ReleaseOldestPage(int cls);
+
+    // Moves page from an idle class to the one that evicts most
+    void Automove();
+
+    // Links item into head of its LRU list and into the index
+    void Link(item *it);
+
+    // Unlinks item from its LRU list and from the index
+    void Unlink(item *it);
+
+    // Unlinks item and frees its chunk
+    void Remove(item *it);
+
+    // Moves item to the head of its LRU list
+    void Touch(item *it);
+
+    // Doubles hash table once it gets too dense
+    void Grow();
+
+    // Sets gauges of the class and the total ones to the current state, called on every change
+    void Publish(int cls);
+
+    const std::size_t _page_size;
+    std::unique_ptr<SlabAllocator> _slabs;
+    std::vector<lru_list> _lru;
+
+    // Hash table, number of buckets is a power of 2
+    std::vector<item *> _buckets;
+    std::size_t _items;
+
+    uint64_t _window_evictions;
+    uint64_t _pages_moved;
+
+    // Memory of chunks in use and number of evictions of all classes, for the gauges
+    uint64_t _bytes;
+    uint64_t _evictions;
+
+    // Occupancy for the exporter
+    Metrics::StorageGauges _gauges;
+
+    // Persistence file, -1 if there is none
+    int _fd;
+    bool _restored;
+
+    // Difference between time of the cache and steady clock of this process
+    clock::duration _clock_shift;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SLAB_LRU_H
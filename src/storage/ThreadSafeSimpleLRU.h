@@ -1,9 +1,15 @@
 #ifndef AFINA_STORAGE_THREAD_SAFE_SIMPLE_LRU_H
 #define AFINA_STORAGE_THREAD_SAFE_SIMPLE_LRU_H
 
+#include <chrono>
+#include <condition_variable>
 #include <map>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/metrics/Locks.h>
 
 #include "SimpleLRU.h"
 
@@ -12,46 +18,151 @@ namespace Backend {
 
 /**
  * # SimpleLRU thread safe version
+ * All operations are serialized by a single mutex. Between Start and Stop background thread
+ * reclaims expired items in small slices, releasing the lock after each of them so that workers
+ * never wait for a full scan.
  *
+ * Snapshot holds the lock only while it copies a batch of items, writer gets them unlocked.
  *
+ * The lock is profiled under the name "storage", see `stats locks`
  */
 class ThreadSafeSimplLRU : public SimpleLRU {
 public:
-    ThreadSafeSimplLRU(size_t max_size = 1024) : SimpleLRU(max_size) {}
-    ~ThreadSafeSimplLRU() {}
+    ThreadSafeSimplLRU(size_t max_size = 1024) : SimpleLRU(max_size), _mutex("storage"), _running(false) {}
+    ~ThreadSafeSimplLRU() { Stop(); }
+
+    // see Storage.h
+    void Start() override {
+        std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
+        if (!_running) {
+            _running = true;
+            _sweeper = std::thread(&ThreadSafeSimplLRU::Sweep, this);
+        }
+    }
+
+    // see Storage.h
+    void Stop() override {
+        {
+            std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
+            _running = false;
+        }
+        _sweeper_wakeup.notify_all();
+        if (_sweeper.joinable()) {
+            _sweeper.join();
+        }
+    }
 
     // see SimpleLRU.h
     bool Put(const std::string &key, const std::string &value) override {
-        // TODO: sinchronization
+        std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
         return SimpleLRU::Put(key, value);
     }
 
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value, int32_t ttl) override {
+        std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
+        return SimpleLRU::Put(key, value, ttl);
+    }
+
     // see SimpleLRU.h
     bool PutIfAbsent(const std::string &key, const std::string &value) override {
-        // TODO: sinchronization
+        std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
         return SimpleLRU::PutIfAbsent(key, value);
     }
 
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) override {
+        std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
+        return SimpleLRU::PutIfAbsent(key, value, ttl);
+    }
+
     // see SimpleLRU.h
     bool Set(const std::string &key, const std::string &value) override {
-        // TODO: sinchronization
+        std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
         return SimpleLRU::Set(key, value);
     }
 
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value, int32_t ttl) override {
+        std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
+        return SimpleLRU::Set(key, value, ttl);
+    }
+
     // see SimpleLRU.h
     bool Delete(const std::string &key) override {
-        // TODO: sinchronization
+        std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
         return SimpleLRU::Delete(key);
     }
 
     // see SimpleLRU.h
     bool Get(const std::string &key, std::string &value) override {
-        // TODO: sinchronization
+        std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
         return SimpleLRU::Get(key, value);
     }
 
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override {
+        std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
+        return SimpleLRU::Get(key, value, expire);
+    }
+
+    // see SimpleLRU.h
+    void Stats(const std::string &group, const StatWriter &writer) override {
+        std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
+        SimpleLRU::Stats(group, writer);
+    }
+
+    // see SimpleLRU.h
+    bool Snapshot(const SnapshotWriter &writer) override {
+        // Snapshots are taken one at a time, the next one waits
+        std::lock_guard<std::mutex> snapshot_lock(_snapshot_mutex);
+        {
+            std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
+            SimpleLRU::SnapshotBegin();
+        }
+
+        std::vector<snapshot_item> batch;
+        bool more = true;
+        bool complete = true;
+        while (more && complete) {
+            {
+                std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
+                more = SimpleLRU::SnapshotNext(kSnapshotBatch, batch);
+            }
+            complete = SimpleLRU::WriteSnapshot(batch, writer);
+        }
+
+        std::lock_guard<Metrics::ProfiledMutex> lock(_mutex);
+        SimpleLRU::SnapshotEnd();
+        return complete;
+    }
+
 private:
-    // TODO: sinchronization primitives
+    // Number of items sweeper reclaims under the lock at once
+    static constexpr std::size_t kSweepSlice = 32;
+
+    // Expiration index has one second resolution, so there is no reason to wake up more often
+    void Sweep() {
+        std::unique_lock<Metrics::ProfiledMutex> lock(_mutex);
+        while (_running) {
+            while (_running && SimpleLRU::SweepExpired(kSweepSlice) == kSweepSlice) {
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+            }
+            _sweeper_wakeup.wait_for(lock, std::chrono::seconds(1));
+        }
+    }
+
+    Metrics::ProfiledMutex _mutex;
+
+    // Serializes snapshots
+    std::mutex _snapshot_mutex;
+
+    // Background sweeper of expired items, runs between Start and Stop
+    bool _running;
+    std::thread _sweeper;
+    std::condition_variable_any _sweeper_wakeup;
 };
 
 } // namespace Backend
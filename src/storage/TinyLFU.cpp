@@ -0,0 +1,284 @@
+#include "TinyLFU.h"
+
+#include <afina/metrics/Probes.h>
+
+namespace Afina {
+namespace Backend {
+
+// Average item size used to pick sketch width, which should match the number of items in cache
+static const std::size_t kAverageItemSize = 64;
+
+TinyLFU::TinyLFU(size_t max_size)
+    : _max_size(max_size), _window_max(max_size / 100), _protected_max((max_size - max_size / 100) * 8 / 10),
+      _window_size(0), _probation_size(0), _protected_size(0), _evictions(0),
+      _sketch(max_size / kAverageItemSize) {
+    _gauges.limit_maxbytes.Set(max_size);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Put(const std::string &key, const std::string &value) { return TinyLFU::Put(key, value, 0); }
+
+// See TinyLFU.h
+bool TinyLFU::Put(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    _sketch.Increment(key_hash()(key));
+    node_list::iterator it;
+    if (Lookup(key, it)) {
+        Update(it, value, Deadline(ttl));
+    } else {
+        Insert(key, value, Deadline(ttl));
+    }
+    return true;
+}
+
+// See TinyLFU.h
+bool TinyLFU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return TinyLFU::PutIfAbsent(key, value, 0);
+}
+
+// See TinyLFU.h
+bool TinyLFU::PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    _sketch.Increment(key_hash()(key));
+    node_list::iterator it;
+    if (Lookup(key, it)) {
+        return false;
+    }
+    Insert(key, value, Deadline(ttl));
+    return true;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Set(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    _sketch.Increment(key_hash()(key));
+    node_list::iterator it;
+    if (!Lookup(key, it)) {
+        return false;
+    }
+    Update(it, value, it->expire);
+    return true;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Set(const std::string &key, const std::string &value, int32_t ttl) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    _sketch.Increment(key_hash()(key));
+    node_list::iterator it;
+    if (!Lookup(key, it)) {
+        return false;
+    }
+    Update(it, value, Deadline(ttl));
+    return true;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Delete(const std::string &key) {
+    node_list::iterator it;
+    if (!Lookup(key, it)) {
+        return false;
+    }
+    Remove(it);
+    return true;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Get(const std::string &key, std::string &value) {
+    clock::time_point expire;
+    return TinyLFU::Get(key, value, expire);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Get(const std::string &key, std::string &value, clock::time_point &expire) {
+    // Misses are counted as well, key that is asked for often deserves a place once it is stored
+    _sketch.Increment(key_hash()(key));
+    node_list::iterator it;
+    if (!Lookup(key, it)) {
+        AFINA_PROBE3(storage_get, key.size(), 0, false);
+        return false;
+    }
+    value = it->value;
+    expire = it->expire;
+    Touch(it);
+    AFINA_PROBE3(storage_get, key.size(), value.size(), true);
+    return true;
+}
+
+// See TinyLFU.h
+void TinyLFU::Stats(const std::string &group, const StatWriter &writer) {
+    if (group.empty()) {
+        writer("curr_items", _index.size());
+        writer("bytes", _window_size + _probation_size + _protected_size);
+        writer("limit_maxbytes", _max_size);
+        writer("evictions", _evictions);
+    }
+}
+
+// See TinyLFU.h
+bool TinyLFU::Lookup(const std::string &key, node_list::iterator &it) {
+    auto index_it = _index.find(key);
+    if (index_it == _index.end()) {
+        return false;
+    }
+
+    it = index_it->second;
+    if (it->expire != clock::time_point::max() && it->expire <= clock::now()) {
+        Remove(it);
+        return false;
+    }
+    return true;
+}
+
+// See TinyLFU.h
+void TinyLFU::Insert(const std::string &key, const std::string &value, clock::time_point expire) {
+    AFINA_PROBE2(storage_put, key.size(), value.size());
+    _window.push_front(node{key, value, expire, Segment::kWindow});
+    _index.emplace(_window.front().key, _window.begin());
+    _window_size += key.size() + value.size();
+    Evict();
+}
+
+// See TinyLFU.h
+void TinyLFU::Update(node_list::iterator it, const std::string &value, clock::time_point expire) {
+    AFINA_PROBE2(storage_put, it->key.size(), value.size());
+    std::size_t &size = Size(it->segment);
+    size = size - it->value.size() + value.size();
+    it->value = value;
+    it->expire = expire;
+    Touch(it);
+}
+
+// See TinyLFU.h
+void TinyLFU::Touch(node_list::iterator it) {
+    std::size_t item_size = it->key.size() + it->value.size();
+    switch (it->segment) {
+    case Segment::kWindow:
+        _window.splice(_window.begin(), _window, it);
+        break;
+    case Segment::kProbation:
+        // Second hit in main cache, item is worth protecting
+        _protected.splice(_protected.begin(), _probation, it);
+        it->segment = Segment::kProtected;
+        _probation_size -= item_size;
+        _protected_size += item_size;
+        break;
+    case Segment::kProtected:
+        _protected.splice(_protected.begin(), _protected, it);
+        break;
+    }
+    Evict();
+}
+
+// See TinyLFU.h
+void TinyLFU::Remove(node_list::iterator it) {
+    _index.erase(it->key);
+    Size(it->segment) -= it->key.size() + it->value.size();
+    List(it->segment).erase(it);
+    Publish();
+}
+
+// See TinyLFU.h
+void TinyLFU::Evict() {
+    const std::size_t main_max = _max_size - _window_max;
+    const clock::time_point now = clock::now();
+
+    // Window overflow: the least recent item of window competes for a place in main cache
+    while (_window_size > _window_max) {
+        auto candidate = std::prev(_window.end());
+        std::size_t candidate_size = candidate->key.size() + candidate->value.size();
+        _probation.splice(_probation.begin(), _window, candidate);
+        candidate->segment = Segment::kProbation;
+        _window_size -= candidate_size;
+        _probation_size += candidate_size;
+
+        const unsigned candidate_freq = _sketch.Estimate(key_hash()(candidate->key));
+        node_list::iterator victim;
+        while (_probation_size + _protected_size > main_max) {
+            if (!MainVictim(&*candidate, victim) ||
+                (victim->expire > now && _sketch.Estimate(key_hash()(victim->key)) >= candidate_freq)) {
+                AFINA_PROBE2(storage_evict, candidate->key.size(), candidate->value.size());
+                Remove(candidate);
+                _evictions++;
+                break;
+            }
+            AFINA_PROBE2(storage_evict, victim->key.size(), victim->value.size());
+            Remove(victim);
+            _evictions++;
+        }
+    }
+
+    // Protected overflow: demote its least recent items back to probation
+    while (_protected_size > _protected_max) {
+        auto it = std::prev(_protected.end());
+        std::size_t item_size = it->key.size() + it->value.size();
+        _probation.splice(_probation.begin(), _protected, it);
+        it->segment = Segment::kProbation;
+        _protected_size -= item_size;
+        _probation_size += item_size;
+    }
+
+    // Main cache could still overflow if one of its items got larger
+    node_list::iterator victim;
+    while (_probation_size + _protected_size > main_max && MainVictim(nullptr, victim)) {
+        AFINA_PROBE2(storage_evict, victim->key.size(), victim->value.size());
+        Remove(victim);
+        _evictions++;
+    }
+    Publish();
+}
+
+// See TinyLFU.h
+void TinyLFU::Publish() {
+    _gauges.Publish(_index.size(), _window_size + _probation_size + _protected_size, _evictions);
+}
+
+// See TinyLFU.h
+bool TinyLFU::MainVictim(const node *except, node_list::iterator &victim) {
+    if (!_probation.empty() && &_probation.back() != except) {
+        victim = std::prev(_probation.end());
+        return true;
+    } else if (!_protected.empty()) {
+        victim = std::prev(_protected.end());
+        return true;
+    }
+    return false;
+}
+
+// See TinyLFU.h
+TinyLFU::node_list &TinyLFU::List(Segment segment) {
+    switch (segment) {
+    case Segment::kWindow:
+        return _window;
+    case Segment::kProbation:
+        return _probation;
+    default:
+        return _protected;
+    }
+}
+
+// See TinyLFU.h
+std::size_t &TinyLFU::Size(Segment segment) {
+    switch (segment) {
+    case Segment::kWindow:
+        return _window_size;
+    case Segment::kProbation:
+        return _probation_size;
+    default:
+        return _protected_size;
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
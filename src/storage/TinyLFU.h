@@ -0,0 +1,158 @@
+#ifndef AFINA_STORAGE_TINY_LFU_H
+#define AFINA_STORAGE_TINY_LFU_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include <afina/Storage.h>
+#include <afina/metrics/StorageGauges.h>
+
+#include "FrequencySketch.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # W-TinyLFU cache
+ * That is NOT thread safe implementaiton!!
+ *
+ * New items get into a small window LRU, which takes 1% of the memory. Items pushed out of the
+ * window are candidates to the main cache, which is segmented LRU: items enter probation segment
+ * and are promoted to protected one (80% of the main) on the next hit.
+ *
+ * Candidate gets into the main cache only if it was accessed more often than the main cache
+ * victim it replaces, access frequency of both is estimated by count-min sketch of all keys seen,
+ * including misses. So a scan of one-hit wonders only churns the window and leaves frequently
+ * used items alone.
+ *
+ * Expired items are never returned and removed once someone access them or once they are picked
+ * as eviction victims
+ */
+class TinyLFU : public Afina::Storage {
+public:
+    TinyLFU(size_t max_size = 1024);
+    ~TinyLFU() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override;
+
+    // Implements Afina::Storage interface
+    void Stats(const std::string &group, const StatWriter &writer) override;
+
+    // Implements Afina::Storage interface
+    const Metrics::StorageGauges *Gauges() const override { return &_gauges; }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    enum class Segment { kWindow, kProbation, kProtected };
+
+    // Cache item, lists are ordered from the most recently used to the least one
+    struct node {
+        std::string key;
+        std::string value;
+
+        // Time point after which node is expired, time_point::max() if node never expires
+        clock::time_point expire;
+
+        // List node is in
+        Segment segment;
+    };
+    using node_list = std::list<node>;
+
+    // Index keys point into nodes, so every key is stored once
+    using key_ref = std::reference_wrapper<const std::string>;
+    struct key_hash {
+        std::size_t operator()(const std::string &key) const { return std::hash<std::string>()(key); }
+    };
+
+    // Finds live node for the key, expired node is removed
+    bool Lookup(const std::string &key, node_list::iterator &it);
+
+    // Places new node into window and lets window overflow into main cache
+    void Insert(const std::string &key, const std::string &value, clock::time_point expire);
+
+    // Replaces value and expiration time of existing node, counts as an access
+    void Update(node_list::iterator it, const std::string &value, clock::time_point expire);
+
+    // Moves node on hit according to its segment
+    void Touch(node_list::iterator it);
+
+    // Removes node from list and index
+    void Remove(node_list::iterator it);
+
+    // Moves nodes out of the window into main cache as long as they beat main cache victims,
+    // then shrinks protected and main segments down to their budget
+    void Evict();
+
+    // Sets gauges to the current state, called on every change
+    void Publish();
+
+    // Finds least recently used node of the main cache, other than the given one
+    bool MainVictim(const node *except, node_list::iterator &victim);
+
+    // Size accounting of the lists
+    node_list &List(Segment segment);
+    std::size_t &Size(Segment segment);
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be less the _max_size
+    const std::size_t _max_size;
+
+    // Byte budgets of the window and protected segment, main cache gets the rest
+    const std::size_t _window_max;
+    const std::size_t _protected_max;
+
+    node_list _window;
+    node_list _probation;
+    node_list _protected;
+
+    std::size_t _window_size;
+    std::size_t _probation_size;
+    std::size_t _protected_size;
+
+    // Number of items pushed out of cache, candidates rejected by admission included
+    uint64_t _evictions;
+
+    // Occupancy for the exporter
+    Metrics::StorageGauges _gauges;
+
+    // Index of nodes from lists above
+    std::unordered_map<key_ref, node_list::iterator, key_hash, std::equal_to<std::string>> _index;
+
+    // Access frequency of all keys, both present and missing
+    FrequencySketch _sketch;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TINY_LFU_H
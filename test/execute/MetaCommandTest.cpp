@@ -0,0 +1,49 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <afina/execute/MetaArithmetic.h>
+#include <afina/execute/MetaGet.h>
+
+#include "storage/SimpleLRU.h"
+
+using namespace Afina::Backend;
+using namespace Afina::Execute;
+
+// Storage that doesn't track expiration, Get with expiration is the default one
+class PlainStorage : public SimpleLRU {
+public:
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override {
+        return Afina::Storage::Get(key, value, expire);
+    }
+};
+
+TEST(MetaCommandTest, ReturnsTTL) {
+    SimpleLRU storage;
+    ASSERT_TRUE(storage.Put("ttl", "5", 100));
+    ASSERT_TRUE(storage.Put("forever", "v"));
+
+    std::string out;
+    MetaGet("ttl", {"t", "s"}).Execute(storage, "", out);
+    EXPECT_EQ("HD t100 s1", out);
+    MetaGet("forever", {"t"}).Execute(storage, "", out);
+    EXPECT_EQ("HD t-1", out);
+
+    // Counter keeps expiration time of the item
+    MetaArithmetic("ttl", {"t", "v"}).Execute(storage, "", out);
+    EXPECT_EQ("VA 1 t100\r\n6", out);
+    MetaArithmetic("ttl", {"T10", "t"}).Execute(storage, "", out);
+    EXPECT_EQ("HD t10", out);
+}
+
+TEST(MetaCommandTest, OmitsUnknownTTL) {
+    PlainStorage storage;
+    ASSERT_TRUE(storage.Put("ttl", "5", 100));
+
+    std::string out;
+    MetaGet("ttl", {"t", "s"}).Execute(storage, "", out);
+    EXPECT_EQ("HD s1", out);
+    MetaArithmetic("ttl", {"t"}).Execute(storage, "", out);
+    EXPECT_EQ("HD", out);
+}
@@ -0,0 +1,138 @@
+#include "gtest/gtest.h"
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <spdlog/sinks/base_sink.h>
+
+#include <afina/logging/AsyncLogger.h>
+
+#include "logging/Drain.h"
+
+using namespace Afina::Logging;
+
+// Keeps messages as they were formatted, without the pattern
+class MemorySink : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    std::vector<std::string> messages;
+    std::vector<std::size_t> threads;
+
+    void flush() override {}
+
+protected:
+    void _sink_it(const spdlog::details::log_msg &msg) override {
+        messages.push_back(msg.raw.str());
+        threads.push_back(msg.thread_id);
+    }
+};
+
+TEST(AsyncLoggerTest, FormatsInDrain) {
+    auto sink = std::make_shared<MemorySink>();
+    AsyncLogger logger("test", sink);
+    logger.set_level(spdlog::level::info);
+
+    Drain drain;
+    drain.Start();
+    char buffer[16] = "array";
+    logger.info("{} {} {} {} {}", 42, "literal", std::string("string"), 1.5, buffer);
+    logger.warn("plain");
+    logger.debug("filtered by level {}", 1);
+    drain.Stop();
+
+    ASSERT_EQ(2, sink->messages.size());
+    EXPECT_EQ("42 literal string 1.5 array", sink->messages[0]);
+    EXPECT_EQ("plain", sink->messages[1]);
+}
+
+TEST(AsyncLoggerTest, KeepsOrderOfEachThread) {
+    auto sink = std::make_shared<MemorySink>();
+    AsyncLogger logger("test", sink);
+
+    Drain drain;
+    drain.Start();
+
+    // Fewer records than a ring holds, so that none is dropped however slow the drain is
+    const int kThreads = 4;
+    const int kRecords = Ring::kCapacity - 10;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&logger, t]() {
+            for (int i = 0; i < kRecords; i++) {
+                logger.info("{} {}", t, i);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    drain.Stop();
+
+    ASSERT_EQ(kThreads * kRecords, sink->messages.size());
+    std::vector<int> next(kThreads, 0);
+    for (const std::string &message : sink->messages) {
+        std::istringstream in(message);
+        int t, i;
+        in >> t >> i;
+        EXPECT_EQ(next[t]++, i);
+    }
+}
+
+TEST(AsyncLoggerTest, NothingLostOnStop) {
+    auto sink = std::make_shared<MemorySink>();
+    AsyncLogger logger("test", sink);
+
+    Drain drain;
+    drain.Start();
+
+    // Drain is stopped while threads log, each record is written either by it or by the thread
+    const int kThreads = 4;
+    const int kRecords = Ring::kCapacity - 10;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&logger, t]() {
+            for (int i = 0; i < kRecords; i++) {
+                logger.info("{} {}", t, i);
+            }
+        });
+    }
+    drain.Stop();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(kThreads * kRecords, sink->messages.size());
+}
+
+TEST(AsyncLoggerTest, TruncatesLongStrings) {
+    auto sink = std::make_shared<MemorySink>();
+    AsyncLogger logger("test", sink);
+    const std::string value(4 * Record::kPayload, 'x');
+
+    // Without drain message is formatted right away
+    logger.info("{}", value);
+
+    Drain drain;
+    drain.Start();
+    logger.info("{} {}", 1, value);
+    drain.Stop();
+
+    ASSERT_EQ(2, sink->messages.size());
+    EXPECT_EQ(value, sink->messages[0]);
+    EXPECT_LT(sink->messages[1].size(), Record::kPayload);
+    EXPECT_EQ(0, sink->messages[1].compare(0, 4, "1 xx"));
+}
+
+TEST(AsyncLoggerTest, DropsWhenFull) {
+    std::unique_ptr<Ring> ring(new Ring());
+    for (std::size_t i = 0; i < Ring::kCapacity; i++) {
+        ASSERT_NE(nullptr, ring->Claim());
+        ring->Publish();
+    }
+
+    EXPECT_EQ(nullptr, ring->Claim());
+    EXPECT_EQ(nullptr, ring->Claim());
+    EXPECT_EQ(2, ring->Dropped());
+}
@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <spdlog/sinks/base_sink.h>
+
+#include <afina/logging/AsyncLogger.h>
+#include <afina/logging/RateLimit.h>
+
+using namespace Afina::Logging;
+
+TEST(RateLimitTest, Burst) {
+    RateLimit limit(1, 3);
+    uint64_t suppressed;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(limit.Take(suppressed));
+        EXPECT_EQ(0, suppressed);
+    }
+    EXPECT_FALSE(limit.Take(suppressed));
+    EXPECT_FALSE(limit.Take(suppressed));
+}
+
+TEST(RateLimitTest, CountsSuppressed) {
+    RateLimit limit(1000, 1);
+    uint64_t suppressed;
+    ASSERT_TRUE(limit.Take(suppressed));
+    for (int i = 0; i < 5; i++) {
+        EXPECT_FALSE(limit.Take(suppressed));
+    }
+
+    // Token comes back in a millisecond
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_TRUE(limit.Take(suppressed));
+    EXPECT_EQ(5, suppressed);
+}
+
+TEST(RateLimitTest, SharedByThreads) {
+    RateLimit limit(1, 100);
+    std::atomic<int> taken(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&limit, &taken]() {
+            uint64_t suppressed;
+            for (int i = 0; i < 1000; i++) {
+                taken += limit.Take(suppressed) ? 1 : 0;
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(100, taken.load());
+}
+
+class LinesSink : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    std::vector<std::string> lines;
+    void flush() override {}
+
+protected:
+    void _sink_it(const spdlog::details::log_msg &msg) override { lines.push_back(msg.raw.str()); }
+};
+
+// Single call site, each one has a bucket of its own
+static void Fail(std::shared_ptr<AsyncLogger> logger, int descriptor) {
+    AFINA_LOG_LIMITED(logger, err, "Failed on descriptor {}", descriptor);
+}
+
+TEST(RateLimitTest, LoggerReportsSuppressed) {
+    auto sink = std::make_shared<LinesSink>();
+    auto logger = std::make_shared<AsyncLogger>("test", sink);
+    for (uint32_t i = 0; i < RateLimit::kBurst + 7; i++) {
+        Fail(logger, i);
+    }
+    AFINA_LOG_LIMITED(logger, err, "Other call site");
+    ASSERT_EQ(RateLimit::kBurst + 1, sink->lines.size());
+    EXPECT_EQ("Failed on descriptor 0", sink->lines[0]);
+    EXPECT_EQ("Other call site", sink->lines[RateLimit::kBurst]);
+
+    // Token comes back in 1 / kRate seconds
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000 / RateLimit::kRate + 20));
+    Fail(logger, 100);
+    ASSERT_EQ(RateLimit::kBurst + 3, sink->lines.size());
+    EXPECT_EQ("Suppressed 7 messages like \"Failed on descriptor {}\"", sink->lines[RateLimit::kBurst + 1]);
+    EXPECT_EQ("Failed on descriptor 100", sink->lines[RateLimit::kBurst + 2]);
+}
@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <afina/Storage.h>
+#include <afina/metrics/Counters.h>
+#include <afina/metrics/StorageGauges.h>
+
+#include "metrics/Exporter.h"
+
+using namespace Afina::Metrics;
+
+// Storage that has nothing but gauges
+class GaugesStorage : public Afina::Storage {
+public:
+    GaugesStorage() {
+        _gauges.curr_items.Set(3);
+        _gauges.evictions.Set(7);
+        _gauges.classes = 2;
+        _gauges.size_classes[1].chunk_size.Set(128);
+        _gauges.size_classes[1].total_pages.Set(1);
+        _gauges.size_classes[1].total_chunks.Set(10);
+        _gauges.size_classes[1].used_chunks.Set(4);
+    }
+
+    bool Put(const std::string &key, const std::string &value) override { return false; }
+    bool PutIfAbsent(const std::string &key, const std::string &value) override { return false; }
+    bool Set(const std::string &key, const std::string &value) override { return false; }
+    bool Delete(const std::string &key) override { return false; }
+    bool Get(const std::string &key, std::string &value) override { return false; }
+
+    // Scrape must not get here
+    void Stats(const std::string &group, const StatWriter &writer) override { ADD_FAILURE(); }
+
+    const StorageGauges *Gauges() const override { return &_gauges; }
+
+private:
+    StorageGauges _gauges;
+};
+
+static std::string Fetch(uint16_t port, const std::string &request) {
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(s, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(s);
+        return std::string();
+    }
+
+    send(s, request.data(), request.size(), MSG_NOSIGNAL);
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = recv(s, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, n);
+    }
+    close(s);
+    return response;
+}
+
+TEST(ExporterTest, Render) {
+    Local()[Stat::kCmdGet].Add(4);
+    Local()[Stat::kGetHits].Add(1);
+
+    Exporter exporter(std::make_shared<GaugesStorage>(), 0);
+    std::string text = exporter.Render();
+    EXPECT_NE(std::string::npos, text.find("# TYPE afina_cmd_get_total counter\nafina_cmd_get_total 4\n"));
+    EXPECT_NE(std::string::npos, text.find("afina_hit_ratio 0.25\n"));
+    EXPECT_NE(std::string::npos, text.find("afina_connections_total 0\n"));
+    EXPECT_NE(std::string::npos, text.find("# TYPE afina_curr_items gauge\nafina_curr_items 3\n"));
+    EXPECT_NE(std::string::npos, text.find("# TYPE afina_evictions_total counter\nafina_evictions_total 7\n"));
+    EXPECT_NE(std::string::npos, text.find("afina_slab_used_chunks{class=\"2\"} 4\n"));
+    EXPECT_NE(std::string::npos, text.find("afina_slab_used_bytes{class=\"2\"} 512\n"));
+    EXPECT_NE(std::string::npos, text.find("afina_slab_allocated_bytes{class=\"2\"} 1280\n"));
+    EXPECT_EQ(std::string::npos, text.find("class=\"1\""));
+}
+
+TEST(ExporterTest, Http) {
+    Exporter exporter(std::make_shared<GaugesStorage>(), 0);
+    exporter.Start();
+
+    std::string response = Fetch(exporter.Port(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    EXPECT_EQ(0, response.compare(0, 17, "HTTP/1.1 200 OK\r\n"));
+    EXPECT_NE(std::string::npos, response.find("\r\n\r\n# TYPE afina_"));
+
+    response = Fetch(exporter.Port(), "GET /other HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(0, response.compare(0, 24, "HTTP/1.1 404 Not Found\r\n"));
+
+    response = Fetch(exporter.Port(), "POST /metrics HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(0, response.compare(0, 22, "HTTP/1.1 405 Method No"));
+
+    exporter.Stop();
+}
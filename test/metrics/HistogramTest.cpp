@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/ThreadLocal.h>
+#include <afina/metrics/Histogram.h>
+
+using namespace Afina::Metrics;
+
+TEST(HistogramTest, SmallValuesAreExact) {
+    Histogram histogram;
+    for (uint64_t v = 1; v <= 20; v++) {
+        histogram.Record(v);
+    }
+
+    EXPECT_EQ(20, histogram.Count());
+    EXPECT_EQ(20, histogram.Max());
+    EXPECT_EQ(10, histogram.Quantile(0.5));
+    EXPECT_EQ(20, histogram.Quantile(0.99));
+    EXPECT_EQ(0, Histogram().Quantile(0.5));
+}
+
+TEST(HistogramTest, BucketBounds) {
+    // Each value must fall into the bucket whose bounds cover it, with error below 1/16
+    for (uint64_t v = 1; v < (uint64_t(1) << 40); v = v * 3 / 2 + 1) {
+        int index = Histogram::Index(v);
+        ASSERT_GE(Histogram::UpperBound(index), v < (uint64_t(1) << 36) ? v : (uint64_t(1) << 36) - 1);
+        if (v < (uint64_t(1) << 36)) {
+            ASSERT_TRUE(index == 0 || Histogram::UpperBound(index - 1) < v);
+            ASSERT_LE(Histogram::UpperBound(index) - v, v / Histogram::kSubBuckets);
+        }
+    }
+    EXPECT_EQ(Histogram::kBuckets - 1, Histogram::Index(UINT64_MAX));
+}
+
+TEST(HistogramTest, TailQuantiles) {
+    Histogram histogram;
+    for (int i = 0; i < 990; i++) {
+        histogram.Record(1000);
+    }
+    for (int i = 0; i < 9; i++) {
+        histogram.Record(100000);
+    }
+    histogram.Record(5000000);
+
+    EXPECT_NEAR(1000, histogram.Quantile(0.5), 1000 / 16);
+    EXPECT_NEAR(1000, histogram.Quantile(0.99), 1000 / 16);
+    EXPECT_NEAR(100000, histogram.Quantile(0.999), 100000 / 16);
+    EXPECT_EQ(5000000, histogram.Quantile(1.0));
+    EXPECT_EQ(5000000, histogram.Max());
+}
+
+TEST(HistogramTest, MergePerThread) {
+    Afina::Concurrency::ThreadLocal<Histogram> histograms;
+    std::vector<std::thread> threads;
+    for (int t = 1; t <= 4; t++) {
+        threads.emplace_back([&histograms, t]() {
+            for (int i = 0; i < 1000; i++) {
+                histograms.Get().Record(t * 100);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    Histogram total;
+    histograms.ForEach([&total](const Histogram &local) { total.Merge(local); });
+    EXPECT_EQ(4000, total.Count());
+    EXPECT_EQ(1000 * (100 + 200 + 300 + 400), total.Sum());
+    EXPECT_EQ(400, total.Max());
+    EXPECT_NEAR(200, total.Quantile(0.5), 200 / 16);
+}
@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/metrics/HotKeys.h>
+
+using namespace Afina::Metrics;
+
+// Three hot keys take 30% of accesses, the rest are spread over a thousand ones
+static std::vector<std::string> Stream(int size) {
+    std::vector<std::string> stream;
+    for (int i = 0; i < size; i++) {
+        if (i % 10 < 3) {
+            stream.push_back("hot" + std::to_string(i % 10));
+        } else {
+            stream.push_back("key" + std::to_string((i * 7919) % 1000));
+        }
+    }
+    return stream;
+}
+
+TEST(HotKeysTest, FindsHeavyHitters) {
+    SpaceSaving sketch(32);
+    std::map<std::string, uint64_t> exact;
+    for (const std::string &key : Stream(10000)) {
+        sketch.Add(key);
+        exact[key]++;
+    }
+
+    EXPECT_EQ(10000, sketch.Total());
+    std::vector<HotKey> top = sketch.Top(3);
+    ASSERT_EQ(3, top.size());
+    for (const HotKey &key : top) {
+        EXPECT_EQ(0, key.key.compare(0, 3, "hot"));
+        EXPECT_GE(key.count, exact[key.key]);
+        EXPECT_LE(key.count - key.error, exact[key.key]);
+    }
+}
+
+TEST(HotKeysTest, Decay) {
+    SpaceSaving sketch(32);
+    sketch.Add("old", 100);
+    sketch.Add("rare", 1);
+    sketch.Decay();
+
+    EXPECT_EQ(50, sketch.Total());
+    std::vector<HotKey> top = sketch.Top(3);
+    ASSERT_EQ(1, top.size());
+    EXPECT_EQ("old", top[0].key);
+    EXPECT_EQ(50, top[0].count);
+
+    // Key accessed now outweighs the one accessed long ago
+    sketch.Decay();
+    sketch.Decay();
+    sketch.Add("new", 20);
+    top = sketch.Top(1);
+    ASSERT_EQ(1, top.size());
+    EXPECT_EQ("new", top[0].key);
+}
+
+TEST(HotKeysTest, Merge) {
+    SpaceSaving first(32), second(32), merged(32);
+    std::vector<std::string> stream = Stream(10000);
+    for (std::size_t i = 0; i < stream.size(); i++) {
+        (i % 2 == 0 ? first : second).Add(stream[i]);
+    }
+    merged.Merge(first);
+    merged.Merge(second);
+
+    EXPECT_EQ(10000, merged.Total());
+    std::vector<HotKey> top = merged.Top(3);
+    ASSERT_EQ(3, top.size());
+    for (const HotKey &key : top) {
+        EXPECT_EQ(0, key.key.compare(0, 3, "hot"));
+        EXPECT_GE(key.count, 1000);
+        EXPECT_LE(key.count - key.error, 1000);
+    }
+}
+
+TEST(HotKeysTest, SampledByWorkers) {
+    SetHotKeySampling(1);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([]() {
+            for (const std::string &key : Stream(10000)) {
+                SampleKey(key.data(), key.size());
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    uint64_t sampled;
+    std::vector<HotKey> top = HotKeys(3, sampled);
+    EXPECT_EQ(40000, sampled);
+    ASSERT_EQ(3, top.size());
+    for (const HotKey &key : top) {
+        EXPECT_EQ(0, key.key.compare(0, 3, "hot"));
+    }
+
+    // Changing sampling drops what was collected
+    SetHotKeySampling(0);
+    top = HotKeys(3, sampled);
+    EXPECT_EQ(0, sampled);
+    EXPECT_TRUE(top.empty());
+}
@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <afina/metrics/Locks.h>
+
+using namespace Afina::Metrics;
+
+static std::map<std::string, uint64_t> acquisitions() {
+    std::map<std::string, uint64_t> result;
+    ForEachLock([&result](const std::string &name, const LockProfile &profile) {
+        result[name] = profile.acquisitions.Get();
+    });
+    return result;
+}
+
+TEST(LocksTest, Toggle) {
+    ProfiledMutex mutex("test_toggle");
+    SetLockProfiling(false);
+    { std::lock_guard<ProfiledMutex> lock(mutex); }
+    EXPECT_EQ(0, mutex.Profile().acquisitions.Get());
+
+    SetLockProfiling(true);
+    for (int i = 0; i < 3; i++) {
+        std::lock_guard<ProfiledMutex> lock(mutex);
+    }
+    ASSERT_TRUE(mutex.try_lock());
+    mutex.unlock();
+    SetLockProfiling(false);
+
+    EXPECT_EQ(4, mutex.Profile().acquisitions.Get());
+    EXPECT_EQ(0, mutex.Profile().contended.Get());
+    EXPECT_EQ(4, mutex.Profile().wait.Count());
+    EXPECT_EQ(0, mutex.Profile().wait.Max());
+    EXPECT_EQ(4, mutex.Profile().hold.Count());
+}
+
+TEST(LocksTest, Contended) {
+    ProfiledMutex mutex("test_contended");
+    SetLockProfiling(true);
+
+    std::unique_lock<ProfiledMutex> lock(mutex);
+    std::thread waiter([&mutex]() { std::lock_guard<ProfiledMutex> lock(mutex); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    lock.unlock();
+    waiter.join();
+    SetLockProfiling(false);
+
+    EXPECT_EQ(2, mutex.Profile().acquisitions.Get());
+    EXPECT_EQ(1, mutex.Profile().contended.Get());
+    EXPECT_LE(uint64_t(40000000), mutex.Profile().wait.Max());
+    EXPECT_LE(uint64_t(40000000), mutex.Profile().hold.Max());
+}
+
+TEST(LocksTest, MergedByName) {
+    SetLockProfiling(true);
+    {
+        ProfiledMutex first("test_shard"), second("test_shard");
+        { std::lock_guard<ProfiledMutex> lock(first); }
+        { std::lock_guard<ProfiledMutex> lock(second); }
+        EXPECT_EQ(2, acquisitions()["test_shard"]);
+    }
+    SetLockProfiling(false);
+
+    // Destroyed locks are no longer reported
+    EXPECT_EQ(0, acquisitions().count("test_shard"));
+}
+
+TEST(LocksTest, ReadersWriterLock) {
+    ProfiledRWLock lock("test_rwlock");
+    SetLockProfiling(true);
+    { ProfiledRWLock::WriteGuard guard(lock); }
+    {
+        // Readers hold the lock together
+        ProfiledRWLock::ReadGuard first(lock);
+        ProfiledRWLock::ReadGuard second(lock);
+    }
+
+    // Writer waits for the reader
+    std::unique_ptr<ProfiledRWLock::ReadGuard> reader(new ProfiledRWLock::ReadGuard(lock));
+    std::thread writer([&lock]() { ProfiledRWLock::WriteGuard guard(lock); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    reader.reset();
+    writer.join();
+    SetLockProfiling(false);
+
+    LockProfile profile;
+    lock.Collect(profile);
+    EXPECT_EQ(5, profile.acquisitions.Get());
+    EXPECT_EQ(1, profile.contended.Get());
+    EXPECT_EQ(5, profile.hold.Count());
+    EXPECT_LE(uint64_t(40000000), profile.wait.Max());
+    EXPECT_EQ(5, acquisitions()["test_rwlock"]);
+}
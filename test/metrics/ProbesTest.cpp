@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <elf.h>
+
+// Argument formats of afina probes found in .note.stapsdt of the ELF file, by probe name
+static std::map<std::string, std::string> probes(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::map<std::string, std::string> result;
+    if (data.size() < sizeof(Elf64_Ehdr) || std::memcmp(data.data(), ELFMAG, SELFMAG) != 0) {
+        return result;
+    }
+
+    const Elf64_Ehdr *header = reinterpret_cast<const Elf64_Ehdr *>(data.data());
+    const Elf64_Shdr *sections = reinterpret_cast<const Elf64_Shdr *>(data.data() + header->e_shoff);
+    const char *names = data.data() + sections[header->e_shstrndx].sh_offset;
+    for (int i = 0; i < header->e_shnum; i++) {
+        if (sections[i].sh_type != SHT_NOTE || std::strcmp(names + sections[i].sh_name, ".note.stapsdt") != 0) {
+            continue;
+        }
+
+        const char *note = data.data() + sections[i].sh_offset;
+        const char *end = note + sections[i].sh_size;
+        while (note + sizeof(Elf64_Nhdr) <= end) {
+            const Elf64_Nhdr *nhdr = reinterpret_cast<const Elf64_Nhdr *>(note);
+            const char *name = note + sizeof(Elf64_Nhdr);
+            const char *desc = name + ((nhdr->n_namesz + 3) & ~3u);
+            note = desc + ((nhdr->n_descsz + 3) & ~3u);
+            if (nhdr->n_type != 3 || std::strcmp(name, "stapsdt") != 0) {
+                continue;
+            }
+
+            // Probe, base and semaphore addresses are followed by provider, name and arguments
+            const char *provider = desc + 3 * sizeof(uint64_t);
+            const char *probe = provider + std::strlen(provider) + 1;
+            const char *args = probe + std::strlen(probe) + 1;
+            if (std::strcmp(provider, "afina") == 0) {
+                result[probe] = args;
+            }
+        }
+    }
+    return result;
+}
+
+TEST(ProbesTest, PresentInServerBinary) {
+    const std::map<std::string, int> expected = {
+        {"conn_open", 1},      {"conn_close", 3},    {"command_parsed", 5}, {"command_done", 6},
+        {"response_sent", 3},  {"storage_get", 3},   {"storage_put", 2},    {"storage_evict", 2},
+    };
+
+    std::map<std::string, std::string> found = probes(AFINA_BINARY);
+    for (const auto &probe : expected) {
+        auto it = found.find(probe.first);
+        ASSERT_NE(found.end(), it) << "no probe " << probe.first;
+
+        // Each argument is "<size>@<location>"
+        EXPECT_EQ(probe.second, std::count(it->second.begin(), it->second.end(), '@')) << probe.first;
+        EXPECT_EQ(0, it->second.compare(0, 2, "8@")) << probe.first;
+    }
+}
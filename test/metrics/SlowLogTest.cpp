@@ -0,0 +1,104 @@
+#include "gtest/gtest.h"
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/metrics/SlowLog.h>
+
+using namespace Afina::Metrics;
+
+static SlowRequest Request(const std::string &key, uint64_t execute) {
+    SlowRequest request;
+    std::memset(&request, 0, sizeof(request));
+    std::strncpy(request.command, "get", sizeof(request.command));
+    request.key_size = key.size();
+    std::memcpy(request.key, key.data(), std::min(key.size(), SlowRequest::kMaxKey));
+    request.execute = execute;
+    return request;
+}
+
+TEST(SlowLogTest, Threshold) {
+    SlowLog log;
+    bool sampled;
+    EXPECT_FALSE(log.Wants(1000000000, sampled));
+
+    log.Configure(100, 0);
+    EXPECT_FALSE(log.Wants(99999, sampled));
+    EXPECT_TRUE(log.Wants(100000, sampled));
+    EXPECT_FALSE(sampled);
+
+    // Every request is sampled
+    log.Configure(0, 1);
+    EXPECT_TRUE(log.Wants(0, sampled));
+    EXPECT_TRUE(sampled);
+}
+
+TEST(SlowLogTest, ReadFrom) {
+    SlowLog log;
+    for (int i = 0; i < 3; i++) {
+        SlowRequest request = Request("key" + std::to_string(i), 1500);
+        log.Push(request);
+    }
+
+    std::vector<SlowRequest> requests;
+    EXPECT_EQ(3, log.Read(0, requests));
+    ASSERT_EQ(3, requests.size());
+    EXPECT_EQ(2, requests[2].id);
+    EXPECT_EQ("key2", std::string(requests[2].key, requests[2].key_size));
+    EXPECT_NE(std::string::npos, SlowLog::Format(requests[0]).find("command=get key=key0 key_size=4"));
+    EXPECT_NE(std::string::npos, SlowLog::Format(requests[0]).find("execute_us=1.500"));
+
+    requests.clear();
+    EXPECT_EQ(3, log.Read(3, requests));
+    EXPECT_TRUE(requests.empty());
+}
+
+TEST(SlowLogTest, Overwrite) {
+    SlowLog log;
+    const std::size_t total = SlowLog::kCapacity + 10;
+    for (std::size_t i = 0; i < total; i++) {
+        SlowRequest request = Request(std::string(300, 'k'), i);
+        log.Push(request);
+    }
+
+    // Only the latest records are kept, long key is truncated
+    std::vector<SlowRequest> requests;
+    EXPECT_EQ(total, log.Read(0, requests));
+    ASSERT_EQ(SlowLog::kCapacity, requests.size());
+    EXPECT_EQ(10, requests.front().id);
+    EXPECT_EQ(300, requests.front().key_size);
+    EXPECT_NE(std::string::npos, SlowLog::Format(requests.front()).find("key=" + std::string(250, 'k') + " "));
+}
+
+TEST(SlowLogTest, ConcurrentWriters) {
+    SlowLog log;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&log, t]() {
+            for (int i = 0; i < 20000; i++) {
+                SlowRequest request = Request("writer" + std::to_string(t), t);
+                log.Push(request);
+            }
+        });
+    }
+
+    // Records read meanwhile are whole, unless their writer got lapped by the ring in the middle
+    uint64_t next = 0;
+    std::size_t seen = 0, garbled = 0;
+    while (next < 4 * 20000) {
+        std::vector<SlowRequest> requests;
+        next = log.Read(next, requests);
+        for (const SlowRequest &request : requests) {
+            if ("writer" + std::to_string(request.execute) != std::string(request.key, request.key_size)) {
+                garbled++;
+            }
+        }
+        seen += requests.size();
+    }
+    for (auto &writer : writers) {
+        writer.join();
+    }
+    EXPECT_LT(0, seen);
+    EXPECT_LE(garbled, seen / 100);
+}
@@ -0,0 +1,308 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <afina/logging/Config.h>
+#include <afina/network/Server.h>
+
+#include "logging/ServiceImpl.h"
+#include "network/UnixSocket.h"
+#include "network/mt_blocking/ServerImpl.h"
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "network/st_blocking/ServerImpl.h"
+#include "network/st_nonblocking/ServerImpl.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+
+// Loggers are registered in spdlog by name, so all servers share a single service
+static std::shared_ptr<Logging::Service> Logs() {
+    static std::shared_ptr<Logging::Service> service;
+    if (service) {
+        return service;
+    }
+
+    auto config = std::make_shared<Logging::Config>();
+    Logging::Appender &console = config->appenders["console"];
+    console.type = Logging::Appender::Type::STDERR;
+    console.color = false;
+
+    Logging::Logger &logger = config->loggers["root"];
+    logger.level = Logging::Logger::Level::ERROR;
+    logger.appenders.push_back("console");
+    logger.format = "[%n] [%l] %v";
+
+    service = std::make_shared<Logging::ServiceImpl>(config);
+    service->Start();
+    return service;
+}
+
+static std::shared_ptr<Network::Server> MakeServer(const std::string &type, std::shared_ptr<Afina::Storage> storage,
+                                                   std::shared_ptr<Logging::Service> logs) {
+    if (type == "st_block") {
+        return std::make_shared<Network::STblocking::ServerImpl>(storage, logs);
+    } else if (type == "mt_block") {
+        return std::make_shared<Network::MTblocking::ServerImpl>(storage, logs);
+    } else if (type == "st_nonblock") {
+        return std::make_shared<Network::STnonblock::ServerImpl>(storage, logs);
+    }
+    return std::make_shared<Network::MTnonblock::ServerImpl>(storage, logs);
+}
+
+// Port nobody listens on right now
+static uint16_t FreePort() {
+    int sfd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    bind(sfd, (struct sockaddr *)&addr, len);
+    getsockname(sfd, (struct sockaddr *)&addr, &len);
+    close(sfd);
+    return ntohs(addr.sin_port);
+}
+
+// Connects to the server, reads and writes time out so that broken server fails test instead of hanging it
+static int Connect(uint16_t port) {
+    int sfd = socket(AF_INET, SOCK_STREAM, 0);
+    struct timeval tv;
+    tv.tv_sec = 5;
+    tv.tv_usec = 0;
+    setsockopt(sfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(sfd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(sfd, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(sfd);
+        return -1;
+    }
+    return sfd;
+}
+
+// Fills address of unix socket, name started with '@' is the one in the abstract namespace
+static socklen_t UnixAddress(const std::string &path, struct sockaddr_un &addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.data(), path.size());
+    if (path[0] == '@') {
+        addr.sun_path[0] = '\0';
+        return offsetof(struct sockaddr_un, sun_path) + path.size();
+    }
+    return offsetof(struct sockaddr_un, sun_path) + path.size() + 1;
+}
+
+static int ConnectUnix(const std::string &path) {
+    int sfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct timeval tv;
+    tv.tv_sec = 5;
+    tv.tv_usec = 0;
+    setsockopt(sfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    struct sockaddr_un addr;
+    socklen_t len = UnixAddress(path, addr);
+    if (connect(sfd, (struct sockaddr *)&addr, len) == -1) {
+        close(sfd);
+        return -1;
+    }
+    return sfd;
+}
+
+static bool Exists(const std::string &path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+static bool SendAll(int sfd, const std::string &data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(sfd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+// Reads till the data ends with suffix, the connection is closed or read times out
+static std::string ReadUntil(int sfd, const std::string &suffix) {
+    std::string data;
+    char buffer[65536];
+    while (data.size() < suffix.size() || data.compare(data.size() - suffix.size(), suffix.size(), suffix) != 0) {
+        ssize_t n = read(sfd, buffer, sizeof(buffer));
+        if (n <= 0) {
+            break;
+        }
+        data.append(buffer, n);
+    }
+    return data;
+}
+
+static bool WaitFor(const std::function<bool()> &condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+TEST(ServerTest, RejectsConnectionsOverLimit) {
+    auto logs = Logs();
+
+    // Single threaded blocking server serves connections one by one, there is nothing to limit
+    for (const std::string type : {"mt_block", "st_nonblock", "mt_nonblock"}) {
+        SCOPED_TRACE(type);
+        auto storage = std::make_shared<Backend::ThreadSafeSimplLRU>(1 << 20);
+        auto server = MakeServer(type, storage, logs);
+        Network::Config config;
+        config.max_connections = 2;
+        server->Configure(config);
+        const uint16_t port = FreePort();
+        server->Start(port, 1, 2);
+
+        // Connections are counted once server responds on them
+        int first = Connect(port);
+        int second = Connect(port);
+        ASSERT_NE(-1, first);
+        ASSERT_NE(-1, second);
+        ASSERT_TRUE(SendAll(first, "set key 0 0 5\r\nvalue\r\n"));
+        EXPECT_EQ("STORED\r\n", ReadUntil(first, "\r\n"));
+        ASSERT_TRUE(SendAll(second, "get key\r\n"));
+        EXPECT_EQ("VALUE key 0 5\r\nvalue\r\nEND\r\n", ReadUntil(second, "END\r\n"));
+
+        int third = Connect(port);
+        ASSERT_NE(-1, third);
+        EXPECT_EQ("SERVER_ERROR too many open connections\r\n", ReadUntil(third, "never"));
+        close(third);
+
+        // Closed connection frees its place once server notices it
+        close(first);
+        EXPECT_TRUE(WaitFor([port]() {
+            int next = Connect(port);
+            bool served = next != -1 && SendAll(next, "get key\r\n") &&
+                          ReadUntil(next, "\r\n").compare(0, 6, "VALUE ") == 0;
+            if (next != -1) {
+                close(next);
+            }
+            return served;
+        }));
+
+        close(second);
+        server->Stop();
+        server->Join();
+    }
+}
+
+TEST(ServerTest, StopsReadingWhileOutputIsQueued) {
+    auto logs = Logs();
+    const std::string value(1 << 16, 'v');
+    const std::string response = "VALUE big 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\nEND\r\n";
+    const int gets = 2000;
+
+    for (const std::string type : {"st_block", "mt_block", "st_nonblock", "mt_nonblock"}) {
+        SCOPED_TRACE(type);
+        auto storage = std::make_shared<Backend::ThreadSafeSimplLRU>(1 << 20);
+        ASSERT_TRUE(storage->Put("big", value));
+        auto server = MakeServer(type, storage, logs);
+        Network::Config config;
+        config.output_watermark = 4096;
+        server->Configure(config);
+        const uint16_t port = FreePort();
+        server->Start(port, 1, 2);
+
+        // Responses are far larger than socket buffers could take, while client reads none of them. Write at
+        // the end has to wait in the socket until client drains the responses
+        int client = Connect(port);
+        ASSERT_NE(-1, client);
+        std::string commands;
+        for (int i = 0; i < gets; i++) {
+            commands += "get big\r\n";
+        }
+        commands += "set marker 0 0 1\r\nm\r\n";
+        ASSERT_TRUE(SendAll(client, commands));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::string marker;
+        EXPECT_FALSE(storage->Get("marker", marker));
+
+        std::string received = ReadUntil(client, "STORED\r\n");
+        EXPECT_EQ(gets * response.size() + 8, received.size());
+        EXPECT_TRUE(storage->Get("marker", marker));
+
+        close(client);
+        server->Stop();
+        server->Join();
+    }
+}
+
+TEST(ServerTest, ServesUnixSockets) {
+    auto logs = Logs();
+    const std::string path = "/tmp/afina-test-" + std::to_string(getpid()) + ".sock";
+    const std::string abstract = "@afina-test-" + std::to_string(getpid());
+
+    for (const std::string type : {"st_block", "mt_block", "st_nonblock", "mt_nonblock"}) {
+        for (const std::string &name : {path, abstract}) {
+            SCOPED_TRACE(type + " " + name);
+
+            // Socket file left by a crashed server is replaced
+            if (name == path) {
+                int stale = socket(AF_UNIX, SOCK_STREAM, 0);
+                struct sockaddr_un addr;
+                socklen_t len = UnixAddress(name, addr);
+                ASSERT_EQ(0, bind(stale, (struct sockaddr *)&addr, len));
+                close(stale);
+                ASSERT_TRUE(Exists(name));
+            }
+
+            auto storage = std::make_shared<Backend::ThreadSafeSimplLRU>(1 << 20);
+            auto server = MakeServer(type, storage, logs);
+            Network::Config config;
+            config.unix_socket = name;
+            server->Configure(config);
+            server->Start(FreePort(), 1, 2);
+
+            int client = ConnectUnix(name);
+            ASSERT_NE(-1, client);
+            ASSERT_TRUE(SendAll(client, "set key 0 0 5\r\nvalue\r\nget key\r\n"));
+            EXPECT_EQ("STORED\r\nVALUE key 0 5\r\nvalue\r\nEND\r\n", ReadUntil(client, "END\r\n"));
+            close(client);
+
+            server->Stop();
+            server->Join();
+            EXPECT_FALSE(Exists(path));
+        }
+    }
+}
+
+TEST(ServerTest, KeepsFileInPlaceOfUnixSocket) {
+    const std::string path = "/tmp/afina-test-" + std::to_string(getpid()) + ".file";
+    std::ofstream(path) << "data";
+
+    EXPECT_THROW(Network::open_unix_socket(path, 16), std::runtime_error);
+    EXPECT_TRUE(Exists(path));
+    unlink(path.c_str());
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <protocol/BinaryParser.h>
+
+using namespace Afina;
+
+// SET request with key "foo", value "bar", flags 0xdeadbeef, expiration 10 and opaque 0x01020304
+static const std::string set_request("\x80\x01\x00\x03\x08\x00\x00\x00\x00\x00\x00\x0e\x01\x02\x03\x04"
+                                     "\x00\x00\x00\x00\x00\x00\x00\x00"
+                                     "\xde\xad\xbe\xef\x00\x00\x00\x0a"
+                                     "foobar",
+                                     38);
+
+// Verify request passed in a single block
+TEST(BinaryParserTest, SimpleSet) {
+    Protocol::BinaryParser parser(1024);
+
+    size_t consumed = 0;
+    std::string input = set_request + "tail";
+    ASSERT_TRUE(parser.Parse(input.data(), input.size(), consumed));
+    ASSERT_EQ(38, consumed);
+
+    ASSERT_EQ(Protocol::Binary::kSet, parser.Opcode());
+    ASSERT_EQ(8, parser.ExtrasLength());
+    ASSERT_EQ("foo", parser.Key());
+    ASSERT_EQ("bar", parser.Value());
+    uint32_t opaque = parser.Opaque();
+    ASSERT_EQ(0, std::memcmp(&set_request[12], &opaque, sizeof(opaque)));
+}
+
+// Verify request splitted between header and body
+TEST(BinaryParserTest, Splitted) {
+    Protocol::BinaryParser parser(1024);
+
+    size_t consumed = 0;
+    ASSERT_FALSE(parser.Parse(set_request.data(), 10, consumed));
+    ASSERT_EQ(10, consumed);
+    ASSERT_FALSE(parser.Parse(set_request.data() + 10, 20, consumed));
+    ASSERT_EQ(20, consumed);
+    ASSERT_TRUE(parser.Parse(set_request.data() + 30, 8, consumed));
+    ASSERT_EQ(8, consumed);
+    ASSERT_EQ("foo", parser.Key());
+    ASSERT_EQ("bar", parser.Value());
+}
+
+// Verify malformed and too large requests are rejected
+TEST(BinaryParserTest, Errors) {
+    size_t consumed = 0;
+    Protocol::BinaryParser parser(8);
+    ASSERT_THROW(parser.Parse(set_request.data(), set_request.size(), consumed), std::length_error);
+
+    std::string bad_magic = set_request;
+    bad_magic[0] = '\x81';
+    parser.Reset();
+    ASSERT_THROW(parser.Parse(bad_magic.data(), bad_magic.size(), consumed), std::runtime_error);
+}
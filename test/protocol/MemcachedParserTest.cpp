@@ -5,6 +5,7 @@
 
 #include <afina/execute/Add.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/MetaSet.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
 
@@ -98,3 +99,43 @@ TEST(MemcachedParserTest, Stats) {
     Execute::Stats *tmp = reinterpret_cast<Execute::Stats *>(cmd.get());
     ASSERT_FALSE(tmp == nullptr);
 }
+
+// Verify meta set command with flags separated by several spaces
+TEST(MemcachedParserTest, MetaSet) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    bool cmd_avail = parser.Parse("ms foo 6  T30 q\r\nfooval\r\n", consumed);
+    ASSERT_TRUE(cmd_avail);
+    ASSERT_EQ(17, consumed);
+    ASSERT_EQ("ms", parser.Name());
+    ASSERT_TRUE(parser.HasBody());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(6, value_size);
+
+    Execute::MetaSet *tmp = reinterpret_cast<Execute::MetaSet *>(cmd.get());
+    ASSERT_EQ("foo", tmp->key());
+    ASSERT_EQ(2, tmp->flags().size());
+    ASSERT_EQ("T30", tmp->flags()[0]);
+    ASSERT_EQ("q", tmp->flags()[1]);
+}
+
+// Verify multi-digit and negative expiration time
+TEST(MemcachedParserTest, ExpireTime) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("set foo 0 3600 6\r\n", consumed));
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_EQ(3600, reinterpret_cast<Execute::Set *>(cmd.get())->expire());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("set foo 0 -15 6\r\n", consumed));
+    cmd = parser.Build(value_size);
+    ASSERT_EQ(-15, reinterpret_cast<Execute::Set *>(cmd.get())->expire());
+}
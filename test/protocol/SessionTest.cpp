@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/metrics/SlowLog.h>
+
+#include <protocol/Session.h>
+
+using namespace Afina;
+
+// Plain map without any limits, enough to check commands got executed
+class MapStorage : public Afina::Storage {
+public:
+    bool Put(const std::string &key, const std::string &value) override {
+        data[key] = value;
+        return true;
+    }
+
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        return data.insert(std::make_pair(key, value)).second;
+    }
+
+    bool Set(const std::string &key, const std::string &value) override {
+        auto it = data.find(key);
+        if (it == data.end()) {
+            return false;
+        }
+        it->second = value;
+        return true;
+    }
+
+    bool Delete(const std::string &key) override { return data.erase(key) > 0; }
+
+    bool Get(const std::string &key, std::string &value) override {
+        auto it = data.find(key);
+        if (it == data.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    std::map<std::string, std::string> data;
+};
+
+// Verify pipelined commands passed in a single block
+TEST(SessionTest, Pipeline) {
+    auto storage = std::make_shared<MapStorage>();
+    Protocol::Session session(storage, 1024);
+
+    std::string out;
+    session.Process("set foo 0 0 6\r\nfooval\r\nget foo\r\n", 32, out);
+    ASSERT_EQ("STORED\r\nVALUE foo 0 6\r\nfooval\r\nEND\r\n", out);
+    ASSERT_EQ("fooval", storage->data["foo"]);
+}
+
+// Verify command splitted on arbitrary boundaries
+TEST(SessionTest, ByteByByte) {
+    auto storage = std::make_shared<MapStorage>();
+    Protocol::Session session(storage, 1024);
+
+    std::string input = "set foo 0 0 6\r\nfooval\r\nadd foo 0 0 3\r\nbar\r\n";
+    std::string out;
+    for (char c : input) {
+        session.Process(&c, 1, out);
+    }
+    ASSERT_EQ("STORED\r\nNOT_STORED\r\n", out);
+    ASSERT_EQ("fooval", storage->data["foo"]);
+}
+
+// Verify value larger than allowed is rejected before it gets read
+TEST(SessionTest, TooLargeValue) {
+    auto storage = std::make_shared<MapStorage>();
+    Protocol::Session session(storage, 4);
+
+    std::string out;
+    ASSERT_FALSE(session.Process("set foo 0 0 6\r\n", 15, out));
+    ASSERT_EQ("SERVER_ERROR object too large for cache\r\n", out);
+    ASSERT_TRUE(storage->data.empty());
+}
+
+// Builds binary request packet
+static std::string binary_request(uint8_t opcode, const std::string &extras, const std::string &key,
+                                  const std::string &value, uint32_t opaque = 0) {
+    std::string packet(24, '\0');
+    packet[0] = '\x80';
+    packet[1] = opcode;
+    packet[2] = char(key.size() >> 8);
+    packet[3] = char(key.size());
+    packet[4] = char(extras.size());
+
+    uint32_t body = extras.size() + key.size() + value.size();
+    for (int i = 0; i < 4; i++) {
+        packet[8 + i] = char(body >> (24 - 8 * i));
+    }
+    std::memcpy(&packet[12], &opaque, sizeof(opaque));
+    return packet + extras + key + value;
+}
+
+// Verify quiet requests answered only on miss or failure, noop terminates the batch
+TEST(SessionTest, BinaryQuietBatch) {
+    auto storage = std::make_shared<MapStorage>();
+    Protocol::Session session(storage, 1024);
+
+    std::string input = binary_request(0x11, std::string(8, '\0'), "foo", "fooval");
+    input += binary_request(0x0d, "", "foo", "", 7);
+    input += binary_request(0x0d, "", "bar", "", 8);
+    input += binary_request(0x0a, "", "", "", 9);
+
+    std::string out;
+    ASSERT_TRUE(session.Process(input.data(), input.size(), out));
+    ASSERT_EQ("fooval", storage->data["foo"]);
+
+    // GETKQ hit: header + 4 bytes flags + key + value
+    ASSERT_EQ(24 + 4 + 3 + 6 + 24, out.size());
+    ASSERT_EQ('\x81', out[0]);
+    ASSERT_EQ(0x0d, out[1]);
+    ASSERT_EQ(7, out[12]);
+    ASSERT_EQ("foofooval", out.substr(28, 9));
+
+    // NOOP
+    ASSERT_EQ('\x81', out[37]);
+    ASSERT_EQ(0x0a, out[38]);
+    ASSERT_EQ(9, out[37 + 12]);
+}
+
+// Verify binary request splitted on arbitrary boundaries
+TEST(SessionTest, BinaryByteByByte) {
+    auto storage = std::make_shared<MapStorage>();
+    Protocol::Session session(storage, 1024);
+    storage->data["foo"] = "fooval";
+
+    std::string input = binary_request(0x00, "", "foo", "") + binary_request(0x04, "", "foo", "");
+    std::string out;
+    for (char c : input) {
+        ASSERT_TRUE(session.Process(&c, 1, out));
+    }
+
+    ASSERT_EQ(24 + 4 + 6 + 24, out.size());
+    ASSERT_EQ("fooval", out.substr(28, 6));
+    ASSERT_EQ(0x04, out[35]);
+    ASSERT_TRUE(storage->data.empty());
+}
+
+// Verify meta commands, quiet ones are answered only on failure and mn terminates the batch
+TEST(SessionTest, MetaCommands) {
+    auto storage = std::make_shared<MapStorage>();
+    Protocol::Session session(storage, 1024);
+
+    std::string input = "ms foo 3 q\r\nbar\r\n"
+                        "ms foo 3 ME q Oa1\r\nbaz\r\n"
+                        "mg foo s v k\r\n"
+                        "mg nope q\r\n"
+                        "ma cnt N0 J10 v\r\n"
+                        "ma cnt MD D3\r\n"
+                        "md nope q\r\n"
+                        "mg foo x\r\n"
+                        "mn\r\n";
+    std::string out;
+    for (char c : input) {
+        ASSERT_TRUE(session.Process(&c, 1, out));
+    }
+    ASSERT_EQ("NS Oa1\r\n"
+              "VA 3 s3 kfoo\r\nbar\r\n"
+              "VA 2\r\n10\r\n"
+              "HD\r\n"
+              "CLIENT_ERROR invalid flag\r\n"
+              "MN\r\n",
+              out);
+    ASSERT_EQ("7", storage->data["cnt"]);
+}
+
+// Verify zero length data block is still terminated by \r\n
+TEST(SessionTest, MetaSetEmpty) {
+    auto storage = std::make_shared<MapStorage>();
+    Protocol::Session session(storage, 1024);
+
+    std::string out;
+    ASSERT_TRUE(session.Process("ms foo 0\r\n\r\nmg foo v\r\n", 22, out));
+    ASSERT_EQ("HD\r\nVA 0\r\n\r\n", out);
+}
+
+// Verify slow client makes request slow, it is logged once the response is sent
+TEST(SessionTest, SlowLogCountsWrite) {
+    auto storage = std::make_shared<MapStorage>();
+    Protocol::Session session(storage, 1024);
+    Metrics::SlowLog &log = Metrics::SlowRequests();
+    std::vector<Metrics::SlowRequest> requests;
+    const uint64_t from = log.Read(0, requests);
+    log.Configure(20000, 0);
+
+    std::string out;
+    ASSERT_TRUE(session.Process("get foo\r\n", 9, out));
+    requests.clear();
+    log.Read(from, requests);
+    EXPECT_TRUE(requests.empty());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    session.Sent();
+    log.Configure(0, 0);
+    requests.clear();
+    log.Read(from, requests);
+    ASSERT_EQ(1, requests.size());
+    EXPECT_LE(uint64_t(20000000), requests[0].write);
+    EXPECT_NE(std::string::npos, Metrics::SlowLog::Format(requests[0]).find(" write_us="));
+}
+
+// Value of the statistic from the stats response, counters are process wide so tests compare deltas
+static uint64_t stat_value(const std::string &stats, const std::string &name) {
+    std::size_t pos = stats.find("STAT " + name + " ");
+    if (pos == std::string::npos) {
+        throw std::runtime_error("No stat " + name);
+    }
+    return std::stoull(stats.substr(pos + name.size() + 6));
+}
+
+// Verify stats reflect requests served and groups are told apart
+TEST(SessionTest, Stats) {
+    auto storage = std::make_shared<MapStorage>();
+    Protocol::Session session(storage, 1024);
+
+    std::string before;
+    ASSERT_TRUE(session.Process("stats\r\n", 7, before));
+    ASSERT_EQ("END\r\n", before.substr(before.size() - 5));
+
+    std::string input = "set foo 0 0 3\r\nbar\r\nget foo\r\nget nope\r\n";
+    std::string out;
+    ASSERT_TRUE(session.Process(input.data(), input.size(), out));
+
+    std::string after;
+    ASSERT_TRUE(session.Process("stats\r\n", 7, after));
+    ASSERT_EQ(1, stat_value(after, "cmd_set") - stat_value(before, "cmd_set"));
+    ASSERT_EQ(2, stat_value(after, "cmd_get") - stat_value(before, "cmd_get"));
+    ASSERT_EQ(1, stat_value(after, "get_hits") - stat_value(before, "get_hits"));
+    ASSERT_EQ(1, stat_value(after, "get_misses") - stat_value(before, "get_misses"));
+    ASSERT_EQ(input.size() + 7, stat_value(after, "bytes_read") - stat_value(before, "bytes_read"));
+    ASSERT_LE(1, stat_value(after, "curr_connections"));
+
+    std::string conns;
+    ASSERT_TRUE(session.Process("stats conns\r\n", 13, conns));
+    ASSERT_NE(std::string::npos, conns.find(":requests 4\r\n"));
+
+    std::string unknown;
+    ASSERT_TRUE(session.Process("stats nope\r\n", 12, unknown));
+    ASSERT_EQ("CLIENT_ERROR unknown stats group\r\n", unknown);
+
+    // Responses are reported as sent in the order they were produced
+    for (int i = 0; i < 5; i++) {
+        session.Sent();
+    }
+    std::string latency;
+    ASSERT_TRUE(session.Process("stats latency\r\n", 15, latency));
+    ASSERT_LE(2, stat_value(latency, "get:execute:count"));
+    ASSERT_LE(1, stat_value(latency, "set:parse:count"));
+    ASSERT_LE(2, stat_value(latency, "get:write:count"));
+    ASSERT_LE(stat_value(latency, "get:execute:p50"), stat_value(latency, "get:execute:max"));
+}
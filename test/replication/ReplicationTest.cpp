@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "replication/Follower.h"
+#include "replication/Leader.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina::Backend;
+using namespace Afina::Replication;
+
+// Waits for replica to catch up, returns false if it didn't in a few seconds
+static bool WaitFor(const std::function<bool()> &condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+static bool Has(Afina::Storage &storage, const std::string &key, const std::string &expected) {
+    std::string value;
+    return storage.Get(key, value) && value == expected;
+}
+
+TEST(ReplicationTest, FullSyncThenStream) {
+    Leader leader(std::make_shared<ThreadSafeSimplLRU>(1 << 20), 0);
+    leader.Start();
+    for (int i = 0; i < 5000; ++i) {
+        EXPECT_TRUE(leader.Put("Key " + std::to_string(i), "val" + std::to_string(i)));
+    }
+
+    Follower follower(std::make_shared<ThreadSafeSimplLRU>(1 << 20), "127.0.0.1", leader.Port());
+    follower.Start();
+    // Snapshot is counted once stale keys are dropped, after its records are already visible
+    EXPECT_TRUE(WaitFor([&]() { return follower.FullSyncs() == 1; }));
+    EXPECT_TRUE(Has(follower, "Key 4999", "val4999"));
+    EXPECT_TRUE(Has(follower, "Key 0", "val0"));
+
+    EXPECT_TRUE(leader.Set("Key 1", "new"));
+    EXPECT_TRUE(leader.Delete("Key 2"));
+    EXPECT_TRUE(leader.Put("Expiring", "val", 100));
+    EXPECT_TRUE(leader.Put("Last", "val"));
+    EXPECT_TRUE(WaitFor([&]() { return Has(follower, "Last", "val"); }));
+
+    std::string value;
+    EXPECT_TRUE(Has(follower, "Key 1", "new"));
+    EXPECT_FALSE(follower.Get("Key 2", value));
+    EXPECT_TRUE(Has(follower, "Expiring", "val"));
+
+    // Replica is read-only
+    EXPECT_FALSE(follower.Put("Key 3", "val"));
+    EXPECT_FALSE(follower.Delete("Key 3"));
+
+    follower.Stop();
+    leader.Stop();
+}
+
+TEST(ReplicationTest, ResumeFromOffset) {
+    Leader leader(std::make_shared<ThreadSafeSimplLRU>(1 << 20), 0);
+    leader.Start();
+    EXPECT_TRUE(leader.Put("KEY1", "val1"));
+
+    Follower follower(std::make_shared<ThreadSafeSimplLRU>(1 << 20), "127.0.0.1", leader.Port());
+    follower.Start();
+    EXPECT_TRUE(WaitFor([&]() { return Has(follower, "KEY1", "val1"); }));
+    EXPECT_TRUE(leader.Put("KEY2", "val2"));
+    EXPECT_TRUE(WaitFor([&]() { return Has(follower, "KEY2", "val2"); }));
+    follower.Stop();
+
+    // Changes made while follower was away are taken from backlog, no snapshot is needed
+    EXPECT_TRUE(leader.Put("KEY3", "val3"));
+    EXPECT_TRUE(leader.Delete("KEY1"));
+    follower.Start();
+    EXPECT_TRUE(WaitFor([&]() { return Has(follower, "KEY3", "val3"); }));
+
+    std::string value;
+    EXPECT_FALSE(follower.Get("KEY1", value));
+    EXPECT_EQ(1, follower.FullSyncs());
+
+    follower.Stop();
+    leader.Stop();
+}
+
+TEST(ReplicationTest, FallBehindBacklog) {
+    Leader leader(std::make_shared<ThreadSafeSimplLRU>(1 << 20), 0, 1024);
+    leader.Start();
+    EXPECT_TRUE(leader.Put("KEY1", "val1"));
+    EXPECT_TRUE(leader.Put("KEY2", "val2"));
+
+    Follower follower(std::make_shared<ThreadSafeSimplLRU>(1 << 20), "127.0.0.1", leader.Port());
+    follower.Start();
+    EXPECT_TRUE(WaitFor([&]() { return Has(follower, "KEY2", "val2"); }));
+    follower.Stop();
+
+    // Backlog keeps only the last kilobyte, follower has to get snapshot again
+    EXPECT_TRUE(leader.Delete("KEY1"));
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(leader.Put("Key " + std::to_string(i), "val"));
+    }
+    follower.Start();
+    EXPECT_TRUE(WaitFor([&]() { return Has(follower, "Key 999", "val"); }));
+    EXPECT_TRUE(WaitFor([&]() { return follower.FullSyncs() == 2; }));
+
+    std::string value;
+    EXPECT_FALSE(follower.Get("KEY1", value));
+    EXPECT_TRUE(Has(follower, "KEY2", "val2"));
+    EXPECT_TRUE(Has(follower, "Key 0", "val"));
+
+    follower.Stop();
+    leader.Stop();
+}
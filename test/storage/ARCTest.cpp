@@ -0,0 +1,105 @@
+#include "gtest/gtest.h"
+#include <string>
+
+#include "storage/ARC.h"
+
+using namespace Afina::Backend;
+
+TEST(ARCTest, PutGetDelete) {
+    ARC storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "val3"));
+    EXPECT_TRUE(storage.Set("KEY1", "val4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val4", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+
+    EXPECT_TRUE(storage.Put("KEY4", "val6", -1));
+    EXPECT_FALSE(storage.Get("KEY4", value));
+}
+
+TEST(ARCTest, ByteAccounting) {
+    // Each item takes 2 + 8 bytes, so 10 of them fit
+    ARC storage(100);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(storage.Put("k" + std::to_string(i), "01234567"));
+    }
+
+    std::string value;
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(storage.Get("k" + std::to_string(i), value));
+    }
+
+    // One large item pushes out as many small ones as needed
+    EXPECT_TRUE(storage.Put("big", std::string(47, 'x')));
+    int hits = 0;
+    for (int i = 0; i < 10; ++i) {
+        hits += storage.Get("k" + std::to_string(i), value);
+    }
+    EXPECT_EQ(5, hits);
+    EXPECT_TRUE(storage.Get("big", value));
+    EXPECT_FALSE(storage.Put("huge", std::string(100, 'x')));
+}
+
+TEST(ARCTest, ScanResistance) {
+    ARC storage(100 * 20);
+
+    // Working set is accessed twice, so it lives in T2
+    std::string value;
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 50; ++i) {
+            std::string key = "Hot " + std::to_string(i);
+            if (!storage.Get(key, value)) {
+                storage.Put(key, "0123456789");
+            }
+        }
+    }
+
+    // Keys seen once only churn T1
+    for (int i = 0; i < 1000; ++i) {
+        storage.Put("Cold " + std::to_string(i), "0123456789");
+    }
+
+    int hits = 0;
+    for (int i = 0; i < 50; ++i) {
+        hits += storage.Get("Hot " + std::to_string(i), value);
+    }
+    EXPECT_EQ(50, hits);
+}
+
+TEST(ARCTest, TargetAdapts) {
+    // Each item takes 2 + 8 bytes, so 10 of them fit
+    ARC storage(100);
+    EXPECT_EQ(0, storage.Target());
+
+    // Fill T2 with items accessed twice
+    std::string value;
+    for (int i = 0; i < 10; ++i) {
+        std::string key = "f" + std::to_string(i);
+        storage.Put(key, "01234567");
+        EXPECT_TRUE(storage.Get(key, value));
+    }
+
+    // New items push f0 into B2 and k0 into B1, return of k0 means T1 was too small
+    storage.Put("k0", "01234567");
+    storage.Put("k1", "01234567");
+    EXPECT_FALSE(storage.Get("k0", value));
+    EXPECT_FALSE(storage.Get("f0", value));
+    storage.Put("k0", "01234567");
+    EXPECT_EQ(10, storage.Target());
+
+    // Return of f0 means T2 was too small
+    storage.Put("f0", "01234567");
+    EXPECT_EQ(0, storage.Target());
+    EXPECT_TRUE(storage.Get("f0", value));
+}
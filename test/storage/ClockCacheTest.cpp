@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/ClockCache.h"
+
+using namespace Afina::Backend;
+
+TEST(ClockCacheTest, PutGetDelete) {
+    ClockCache storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "val3"));
+    EXPECT_TRUE(storage.Set("KEY1", "val4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val4", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+}
+
+TEST(ClockCacheTest, SecondChance) {
+    const size_t length = 20;
+    ClockCache storage(2 * 100 * length);
+
+    auto key = [length](int i) {
+        std::string result = "Key " + std::to_string(i);
+        result.resize(length, ' ');
+        return result;
+    };
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(storage.Put(key(i), key(i)));
+    }
+
+    // Referenced half survives next hundred of inserts, the other half is evicted first
+    std::string value;
+    for (int i = 0; i < 100; i += 2) {
+        EXPECT_TRUE(storage.Get(key(i), value));
+    }
+    for (int i = 100; i < 150; ++i) {
+        EXPECT_TRUE(storage.Put(key(i), key(i)));
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(i % 2 == 0, storage.Get(key(i), value)) << i;
+    }
+    for (int i = 100; i < 150; ++i) {
+        EXPECT_TRUE(storage.Get(key(i), value));
+    }
+}
+
+TEST(ClockCacheTest, Expire) {
+    ClockCache storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1", 100));
+    EXPECT_TRUE(storage.Put("KEY2", "val2", -1));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_FALSE(storage.Set("KEY2", "val3"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val4"));
+}
+
+TEST(ClockCacheTest, ConcurrentReaders) {
+    ClockCache storage(64 * 1024);
+    for (int i = 0; i < 256; ++i) {
+        storage.Put("Key " + std::to_string(i), "Val " + std::to_string(i));
+    }
+
+    std::atomic<int> failures(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&storage, &failures, t]() {
+            std::string value;
+            for (int i = 0; i < 20000; ++i) {
+                int k = (i * 7 + t) % 256;
+                if (t == 0 && i % 10 == 0) {
+                    storage.Put("Key " + std::to_string(k), "Val " + std::to_string(k));
+                } else if (!storage.Get("Key " + std::to_string(k), value) || value != "Val " + std::to_string(k)) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(0, failures.load());
+}
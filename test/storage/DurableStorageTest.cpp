@@ -0,0 +1,178 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "storage/DurableStorage.h"
+#include "storage/SimpleLRU.h"
+
+using namespace Afina::Backend;
+
+static std::string TestDir(const std::string &name) {
+    std::string dir = "/tmp/afina_" + name;
+    std::system(("rm -rf " + dir).c_str());
+    return dir;
+}
+
+static std::unique_ptr<DurableStorage> OpenStorage(const std::string &dir, uint64_t compact_size = 64 << 20) {
+    std::unique_ptr<OpLog> log(new OpLog(dir, std::chrono::milliseconds(10), compact_size));
+    std::unique_ptr<DurableStorage> storage(
+        new DurableStorage(std::make_shared<SimpleLRU>(1 << 20), std::move(log)));
+    storage->Start();
+    return storage;
+}
+
+static off_t FileSize(const std::string &path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? st.st_size : -1;
+}
+
+TEST(DurableStorageTest, ReplayAfterRestart) {
+    std::string dir = TestDir("durable_replay");
+    {
+        auto storage = OpenStorage(dir);
+        EXPECT_TRUE(storage->Put("KEY1", "val1"));
+        EXPECT_TRUE(storage->PutIfAbsent("KEY2", "val2"));
+        EXPECT_FALSE(storage->PutIfAbsent("KEY2", "val3"));
+        EXPECT_TRUE(storage->Set("KEY1", "val4"));
+        EXPECT_TRUE(storage->Put("KEY3", "val5"));
+        EXPECT_TRUE(storage->Delete("KEY3"));
+        EXPECT_TRUE(storage->Put("KEY4", "val6", 1000));
+        EXPECT_TRUE(storage->Put("KEY5", "val7", -1));
+        storage->Stop();
+    }
+
+    auto storage = OpenStorage(dir);
+    std::string value;
+    EXPECT_TRUE(storage->Get("KEY1", value));
+    EXPECT_EQ("val4", value);
+    EXPECT_TRUE(storage->Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+    EXPECT_FALSE(storage->Get("KEY3", value));
+    EXPECT_TRUE(storage->Get("KEY4", value));
+    EXPECT_EQ("val6", value);
+    EXPECT_FALSE(storage->Get("KEY5", value));
+    storage->Stop();
+}
+
+TEST(DurableStorageTest, SyncWithoutStop) {
+    std::string dir = TestDir("durable_sync");
+    auto crashed = OpenStorage(dir);
+    EXPECT_TRUE(crashed->Put("KEY", "val"));
+    crashed->Sync();
+
+    // Log is read by another instance while the first one still runs, as after a crash
+    std::unique_ptr<OpLog> log(new OpLog(dir, std::chrono::milliseconds(10)));
+    std::string value;
+    log->Replay([&value](const OpLog::Record &record) { value = record.value; });
+    EXPECT_EQ("val", value);
+    crashed->Stop();
+}
+
+TEST(DurableStorageTest, TornTail) {
+    std::string dir = TestDir("durable_torn");
+    {
+        auto storage = OpenStorage(dir);
+        EXPECT_TRUE(storage->Put("KEY1", "val1"));
+        storage->Stop();
+    }
+
+    // Half written record at the end of log
+    {
+        std::ofstream file(dir + "/log", std::ios::binary | std::ios::app);
+        file.write("\x20\0\0\0garbage", 11);
+    }
+
+    {
+        auto storage = OpenStorage(dir);
+        std::string value;
+        EXPECT_TRUE(storage->Get("KEY1", value));
+        EXPECT_TRUE(storage->Put("KEY2", "val2"));
+        storage->Stop();
+    }
+
+    // Records appended after the cut are readable
+    auto storage = OpenStorage(dir);
+    std::string value;
+    EXPECT_TRUE(storage->Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+    storage->Stop();
+}
+
+TEST(DurableStorageTest, Compaction) {
+    std::string dir = TestDir("durable_compact");
+    {
+        auto storage = OpenStorage(dir, 4096);
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 0; i < 50; ++i) {
+                storage->Put("Key " + std::to_string(i), "Value " + std::to_string(round));
+            }
+            storage->Delete("Key 0");
+            storage->Sync();
+
+            // Log grows freely while compaction runs, so let the previous one finish first
+            while (FileSize(dir + "/log.old") != -1) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        storage->Set("Key 1", "Last");
+        storage->Stop();
+    }
+
+    // Log was cut many times, snapshot has one record per live key
+    EXPECT_LT(FileSize(dir + "/log"), 8192);
+    EXPECT_GT(FileSize(dir + "/snapshot"), 0);
+    EXPECT_LT(FileSize(dir + "/snapshot"), 50 * 64);
+
+    auto storage = OpenStorage(dir);
+    std::string value;
+    EXPECT_FALSE(storage->Get("Key 0", value));
+    EXPECT_TRUE(storage->Get("Key 1", value));
+    EXPECT_EQ("Last", value);
+    for (int i = 2; i < 50; ++i) {
+        EXPECT_TRUE(storage->Get("Key " + std::to_string(i), value));
+        EXPECT_EQ("Value 19", value);
+    }
+    storage->Stop();
+}
+
+TEST(DurableStorageTest, CompactionFailure) {
+    std::string dir = TestDir("durable_compact_failure");
+    {
+        auto storage = OpenStorage(dir, 1024);
+
+        // Snapshot can't be written in place of a directory
+        mkdir((dir + "/snapshot.tmp").c_str(), 0755);
+        for (int i = 0; i < 100; ++i) {
+            storage->Put("Key " + std::to_string(i), "Value " + std::to_string(i));
+            EXPECT_TRUE(storage->Sync());
+        }
+
+        uint64_t failed = 0;
+        storage->Stats("", [&failed](const std::string &name, uint64_t value) {
+            if (name == "oplog_compaction_failed") {
+                failed = value;
+            }
+        });
+        EXPECT_EQ(1, failed);
+        storage->Stop();
+    }
+    EXPECT_GT(FileSize(dir + "/log.old"), 0);
+
+    // Old log is still replayed and compacted once it is possible
+    rmdir((dir + "/snapshot.tmp").c_str());
+    auto storage = OpenStorage(dir);
+    EXPECT_EQ(-1, FileSize(dir + "/log.old"));
+    std::string value;
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(storage->Get("Key " + std::to_string(i), value));
+        EXPECT_EQ("Value " + std::to_string(i), value);
+    }
+    storage->Stop();
+}
@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/metrics/HotKeys.h>
+
+#include "storage/HotReplicas.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina::Backend;
+
+static std::map<std::string, uint64_t> stats(HotReplicas &storage) {
+    std::map<std::string, uint64_t> result;
+    storage.Stats("", [&result](const std::string &name, uint64_t value) { result[name] = value; });
+    return result;
+}
+
+// Makes key the only hot one
+static void heat(const std::string &key) {
+    Afina::Metrics::SetHotKeySampling(1);
+    for (int i = 0; i < 10; i++) {
+        Afina::Metrics::SampleKey(key.data(), key.size());
+    }
+}
+
+TEST(HotReplicasTest, ServesCopyTillWrite) {
+    HotReplicas storage(std::make_shared<ThreadSafeSimplLRU>(1024), 4);
+    ASSERT_TRUE(storage.Put("hot", "v1"));
+    ASSERT_TRUE(storage.Put("cold", "c1"));
+    heat("hot");
+    storage.Refresh();
+    EXPECT_EQ(1, stats(storage)["hot_replica_keys"]);
+
+    // The first Get fills the copy, the next one is served from it
+    std::string value;
+    ASSERT_TRUE(storage.Get("hot", value));
+    ASSERT_TRUE(storage.Get("hot", value));
+    EXPECT_EQ("v1", value);
+    ASSERT_TRUE(storage.Get("cold", value));
+    EXPECT_EQ("c1", value);
+    EXPECT_LE(1, stats(storage)["hot_replica_hits"]);
+
+    ASSERT_TRUE(storage.Set("hot", "v2"));
+    ASSERT_TRUE(storage.Get("hot", value));
+    EXPECT_EQ("v2", value);
+
+    ASSERT_TRUE(storage.Delete("hot"));
+    EXPECT_FALSE(storage.Get("hot", value));
+    Afina::Metrics::SetHotKeySampling(0);
+}
+
+TEST(HotReplicasTest, FollowsHotKeys) {
+    HotReplicas storage(std::make_shared<ThreadSafeSimplLRU>(1024), 1);
+    ASSERT_TRUE(storage.Put("old", "o"));
+    ASSERT_TRUE(storage.Put("new", "n"));
+    Afina::Metrics::SetHotKeySampling(1);
+    for (int i = 0; i < 1000; i++) {
+        Afina::Metrics::SampleKey("old", 3);
+    }
+    storage.Refresh();
+
+    // Hits of the copy are counted only when key is copied
+    auto served = [&storage](const std::string &key) {
+        uint64_t before = stats(storage)["hot_replica_hits"];
+        std::string value;
+        for (int i = 0; i < 10; i++) {
+            storage.Get(key, value);
+        }
+        return stats(storage)["hot_replica_hits"] > before;
+    };
+    EXPECT_TRUE(served("old"));
+    EXPECT_FALSE(served("new"));
+
+    // Access moves to the other key at a tenth of the old rate, all-time counts still favor the old one
+    for (int round = 0; round < 8; round++) {
+        for (int i = 0; i < 100; i++) {
+            Afina::Metrics::SampleKey("new", 3);
+        }
+        storage.Refresh();
+    }
+    EXPECT_TRUE(served("new"));
+    EXPECT_FALSE(served("old"));
+    Afina::Metrics::SetHotKeySampling(0);
+}
+
+// Counts reads reaching the storage
+class CountingStorage : public ThreadSafeSimplLRU {
+public:
+    CountingStorage() : ThreadSafeSimplLRU(1024), gets(0) {}
+
+    bool Get(const std::string &key, std::string &value, std::chrono::steady_clock::time_point &expire) override {
+        gets++;
+        return ThreadSafeSimplLRU::Get(key, value, expire);
+    }
+
+    std::atomic<int> gets;
+};
+
+TEST(HotReplicasTest, ExpiredCopyIsNotServed) {
+    HotReplicas storage(std::make_shared<ThreadSafeSimplLRU>(1024), 4);
+    ASSERT_TRUE(storage.Put("hot", "v1", 1));
+    heat("hot");
+    storage.Refresh();
+
+    std::string value;
+    ASSERT_TRUE(storage.Get("hot", value));
+    ASSERT_TRUE(storage.Get("hot", value));
+    EXPECT_LE(1, stats(storage)["hot_replica_hits"]);
+
+    // Copies are not refreshed here, so it is the copy that has to expire
+    auto until = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (storage.Get("hot", value) && std::chrono::steady_clock::now() < until) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    EXPECT_FALSE(storage.Get("hot", value));
+    Afina::Metrics::SetHotKeySampling(0);
+}
+
+TEST(HotReplicasTest, HitsReachStorageSometimes) {
+    auto counting = std::make_shared<CountingStorage>();
+    HotReplicas storage(counting, 4);
+    ASSERT_TRUE(storage.Put("hot", "v1"));
+    heat("hot");
+    storage.Refresh();
+
+    // Thread could move between cores, each of them fills a copy of its own
+    std::string value;
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(storage.Get("hot", value));
+    }
+    EXPECT_LE(1000 / 64, counting->gets.load());
+    EXPECT_GT(1000 / 2, counting->gets.load());
+    Afina::Metrics::SetHotKeySampling(0);
+}
+
+TEST(HotReplicasTest, ConcurrentWritesAreSeen) {
+    HotReplicas storage(std::make_shared<ThreadSafeSimplLRU>(1024), 4);
+    ASSERT_TRUE(storage.Put("hot", "0"));
+    heat("hot");
+    storage.Refresh();
+
+    // Readers keep refilling copies while the key changes, none of them is left stale
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&storage]() {
+            std::string value;
+            for (int i = 0; i < 10000; i++) {
+                storage.Get("hot", value);
+            }
+        });
+    }
+    for (int i = 1; i <= 1000; i++) {
+        EXPECT_TRUE(storage.Set("hot", std::to_string(i)));
+    }
+    for (auto &reader : readers) {
+        reader.join();
+    }
+
+    std::string value;
+    ASSERT_TRUE(storage.Get("hot", value));
+    EXPECT_EQ("1000", value);
+    Afina::Metrics::SetHotKeySampling(0);
+}
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include <string>
+
+#include "storage/S3FIFO.h"
+
+using namespace Afina::Backend;
+
+TEST(S3FIFOTest, PutGetDelete) {
+    S3FIFO storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "val3"));
+    EXPECT_TRUE(storage.Set("KEY1", "val4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val4", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+
+    EXPECT_TRUE(storage.Put("KEY4", "val6", -1));
+    EXPECT_FALSE(storage.Get("KEY4", value));
+}
+
+TEST(S3FIFOTest, ByteBudget) {
+    const size_t length = 20;
+    S3FIFO storage(2 * 1000 * length);
+
+    for (int i = 0; i < 5000; ++i) {
+        std::string key = "Key " + std::to_string(i);
+        key.resize(length, ' ');
+        EXPECT_TRUE(storage.Put(key, key));
+    }
+
+    int present = 0;
+    std::string value;
+    for (int i = 0; i < 5000; ++i) {
+        std::string key = "Key " + std::to_string(i);
+        key.resize(length, ' ');
+        present += storage.Get(key, value);
+    }
+    EXPECT_LE(present, 1000);
+    EXPECT_GE(present, 900);
+}
+
+TEST(S3FIFOTest, AccessedItemsSurvive) {
+    S3FIFO storage(100 * 20);
+
+    std::string value;
+    for (int i = 0; i < 50; ++i) {
+        storage.Put("Hot " + std::to_string(i), "0123456789");
+        storage.Get("Hot " + std::to_string(i), value);
+    }
+
+    // Items accessed in small queue move to main one, scan of new keys goes through small only
+    for (int i = 0; i < 1000; ++i) {
+        storage.Put("Cold " + std::to_string(i), "0123456789");
+    }
+
+    int hits = 0;
+    for (int i = 0; i < 50; ++i) {
+        hits += storage.Get("Hot " + std::to_string(i), value);
+    }
+    EXPECT_EQ(50, hits);
+}
+
+TEST(S3FIFOTest, GhostReadmission) {
+    S3FIFO storage(100 * 20);
+
+    // Key evicted from small queue goes straight into main queue once it comes back
+    std::string value;
+    storage.Put("Back", "0123456789");
+    for (int i = 0; i < 150; ++i) {
+        storage.Put("Cold " + std::to_string(i), "0123456789");
+    }
+    EXPECT_FALSE(storage.Get("Back", value));
+
+    storage.Put("Back", "0123456789");
+    for (int i = 150; i < 1000; ++i) {
+        storage.Put("Cold " + std::to_string(i), "0123456789");
+    }
+    EXPECT_TRUE(storage.Get("Back", value));
+}
@@ -0,0 +1,297 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "storage/SlabLRU.h"
+
+using namespace Afina::Backend;
+
+static SlabLRU::Options WithPageSize(std::size_t page_size) {
+    SlabLRU::Options options;
+    options.page_size = page_size;
+    return options;
+}
+
+// Cache file in a directory of its own, so that tests running in parallel don't share it
+static std::string TempPath() {
+    char dir[] = "/tmp/afina_slab_XXXXXX";
+    EXPECT_NE(nullptr, mkdtemp(dir));
+    return std::string(dir) + "/cache";
+}
+
+static void RemoveTemp(const std::string &path) {
+    std::remove(path.c_str());
+    rmdir(path.substr(0, path.rfind('/')).c_str());
+}
+
+TEST(SlabLRUTest, PutGetDelete) {
+    SlabLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "val3"));
+    EXPECT_TRUE(storage.Set("KEY1", "val4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val4", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+
+    EXPECT_TRUE(storage.Put("KEY4", "val6", -1));
+    EXPECT_FALSE(storage.Get("KEY4", value));
+
+    EXPECT_FALSE(storage.Put("KEY5", std::string(1024, 'x')));
+}
+
+TEST(SlabLRUTest, GetReportsExpiration) {
+    SlabLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2", 100));
+
+    std::string value;
+    std::chrono::steady_clock::time_point expire;
+    EXPECT_TRUE(storage.Get("KEY1", value, expire));
+    EXPECT_TRUE(expire == std::chrono::steady_clock::time_point::max());
+
+    const auto now = std::chrono::steady_clock::now();
+    EXPECT_TRUE(storage.Get("KEY2", value, expire));
+    EXPECT_EQ("val2", value);
+    EXPECT_TRUE(expire > now + std::chrono::seconds(90) && expire <= now + std::chrono::seconds(100));
+}
+
+TEST(SlabLRUTest, MemoryBudget) {
+    SlabLRU storage(64 * 1024, WithPageSize(1024));
+    EXPECT_EQ(64, storage.Slabs().TotalPages());
+
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "0123456789"));
+    }
+
+    // All items are of the same class, it got the whole memory and evicts the oldest ones
+    int cls = storage.ItemClass("Key 9999", "0123456789");
+    std::size_t chunks = 64 * (1024 / storage.Slabs().ChunkSize(cls));
+    EXPECT_EQ(0, storage.Slabs().FreePages());
+    EXPECT_EQ(chunks, storage.Items(cls));
+    EXPECT_EQ(10000 - chunks, storage.Evictions(cls));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("Key 9999", value));
+    EXPECT_EQ("0123456789", value);
+    EXPECT_FALSE(storage.Get("Key 0", value));
+}
+
+TEST(SlabLRUTest, GaugesFollowStats) {
+    SlabLRU storage(64 * 1024, WithPageSize(1024));
+    for (int i = 0; i < 2000; ++i) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), std::string(i % 300, 'x')));
+    }
+    EXPECT_TRUE(storage.Delete("Key 1999"));
+
+    std::map<std::string, uint64_t> stats;
+    auto writer = [&stats](const std::string &name, uint64_t value) { stats[name] = value; };
+    storage.Stats("", writer);
+    storage.Stats("slabs", writer);
+
+    const Afina::Metrics::StorageGauges &gauges = *storage.Gauges();
+    EXPECT_EQ(stats["curr_items"], gauges.curr_items.Get());
+    EXPECT_EQ(stats["bytes"], gauges.bytes.Get());
+    EXPECT_EQ(stats["limit_maxbytes"], gauges.limit_maxbytes.Get());
+    EXPECT_EQ(stats["evictions"], gauges.evictions.Get());
+    EXPECT_EQ(stats["slabs_moved"], gauges.slabs_moved.Get());
+    EXPECT_EQ(stats["total_malloced"], gauges.total_malloced.Get());
+    for (int cls = 0; cls < gauges.classes; cls++) {
+        const std::string prefix = std::to_string(cls + 1) + ":";
+        EXPECT_EQ(stats[prefix + "total_pages"], gauges.size_classes[cls].total_pages.Get());
+        EXPECT_EQ(stats[prefix + "used_chunks"], gauges.size_classes[cls].used_chunks.Get());
+        EXPECT_EQ(storage.Items(cls), gauges.size_classes[cls].items.Get());
+        EXPECT_EQ(storage.Evictions(cls), gauges.size_classes[cls].evictions.Get());
+    }
+}
+
+TEST(SlabLRUTest, UpdateChangesClass) {
+    SlabLRU storage(16 * 1024, WithPageSize(1024));
+
+    EXPECT_TRUE(storage.Put("KEY", "small"));
+    EXPECT_TRUE(storage.Set("KEY", std::string(500, 'x')));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY", value));
+    EXPECT_EQ(std::string(500, 'x'), value);
+
+    EXPECT_TRUE(storage.Set("KEY", "small again"));
+    EXPECT_TRUE(storage.Get("KEY", value));
+    EXPECT_EQ("small again", value);
+
+    std::size_t items = 0;
+    for (std::size_t cls = 0; cls < storage.Slabs().Classes(); ++cls) {
+        items += storage.Items(cls);
+    }
+    EXPECT_EQ(1, items);
+}
+
+TEST(SlabLRUTest, AutomoveFollowsSizeMix) {
+    SlabLRU storage(32 * 1024, WithPageSize(1024));
+
+    // Small items take all pages
+    for (int i = 0; i < 5000; ++i) {
+        storage.Put("Small " + std::to_string(i), "01234567");
+    }
+    int small = storage.ItemClass("Small 4999", "01234567");
+    EXPECT_EQ(32, storage.Slabs().Pages(small).size());
+
+    // Then workload switches to large ones, pages follow it
+    const std::string large_value(400, 'x');
+    for (int i = 0; i < 5000; ++i) {
+        storage.Put("Large " + std::to_string(i), large_value);
+    }
+    int large = storage.ItemClass("Large 4999", large_value);
+    EXPECT_GT(storage.PagesMoved(), 0);
+    EXPECT_GT(storage.Slabs().Pages(large).size(), 16);
+    EXPECT_EQ(storage.Slabs().Pages(large).size() * (1024 / storage.Slabs().ChunkSize(large)), storage.Items(large));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("Large 4999", value));
+    EXPECT_EQ(large_value, value);
+}
+
+TEST(SlabLRUTest, HugePagesPrefault) {
+    // Works with or without huge pages reserved in the system
+    SlabLRU::Options options = WithPageSize(1 << 20);
+    options.huge_pages = true;
+    options.prefault = true;
+    SlabLRU storage(4 << 20, options);
+    EXPECT_EQ(4, storage.Slabs().TotalPages());
+
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), std::string(1000, 'x')));
+    }
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("Key 999", value));
+    EXPECT_EQ(std::string(1000, 'x'), value);
+}
+
+TEST(SlabLRUTest, WarmRestart) {
+    SlabLRU::Options options = WithPageSize(1024);
+    options.path = TempPath();
+
+    {
+        SlabLRU storage(64 * 1024, options);
+        EXPECT_FALSE(storage.Restored());
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "Value " + std::to_string(i)));
+        }
+        EXPECT_TRUE(storage.Put("Expired", "soon", 1));
+        storage.Stop();
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    {
+        SlabLRU storage(64 * 1024, options);
+        EXPECT_TRUE(storage.Restored());
+
+        std::string value;
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_TRUE(storage.Get("Key " + std::to_string(i), value));
+            EXPECT_EQ("Value " + std::to_string(i), value);
+        }
+        EXPECT_FALSE(storage.Get("Expired", value));
+
+        // Restored cache works as usual
+        EXPECT_TRUE(storage.Put("Key 100", "Value 100"));
+        EXPECT_TRUE(storage.Delete("Key 0"));
+    }
+
+    // No flush means no restore
+    {
+        SlabLRU storage(64 * 1024, options);
+        EXPECT_FALSE(storage.Restored());
+
+        std::string value;
+        EXPECT_FALSE(storage.Get("Key 1", value));
+    }
+    RemoveTemp(options.path);
+}
+
+TEST(SlabLRUTest, WarmRestartDetectsValueCorruption) {
+    SlabLRU::Options options = WithPageSize(1024);
+    options.path = TempPath();
+
+    {
+        SlabLRU storage(64 * 1024, options);
+        EXPECT_TRUE(storage.Put("Key", "Value"));
+        EXPECT_TRUE(storage.Put("Other", "Distinct value"));
+        storage.Stop();
+    }
+
+    // Damage bytes of the value, item headers stay intact
+    {
+        std::fstream file(options.path, std::ios::in | std::ios::out | std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const std::size_t offset = content.find("Distinct value");
+        ASSERT_NE(std::string::npos, offset);
+        file.seekp(offset);
+        file.write("Damaged", 7);
+    }
+
+    {
+        SlabLRU storage(64 * 1024, options);
+        EXPECT_FALSE(storage.Restored());
+
+        std::string value;
+        EXPECT_FALSE(storage.Get("Other", value));
+    }
+    RemoveTemp(options.path);
+}
+
+TEST(SlabLRUTest, WarmRestartDetectsCorruption) {
+    SlabLRU::Options options = WithPageSize(1024);
+    options.path = TempPath();
+
+    {
+        SlabLRU storage(64 * 1024, options);
+        EXPECT_TRUE(storage.Put("Key", "Value"));
+        storage.Stop();
+    }
+
+    // Damage header of the item on the page right after the file header
+    {
+        std::fstream file(options.path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(64 * 1024 + 8);
+        file.write("garbage", 7);
+    }
+
+    {
+        SlabLRU storage(64 * 1024, options);
+        EXPECT_FALSE(storage.Restored());
+
+        std::string value;
+        EXPECT_FALSE(storage.Get("Key", value));
+    }
+
+    // Layout change is detected as well
+    {
+        SlabLRU storage(64 * 1024, options);
+        EXPECT_TRUE(storage.Put("Key", "Value"));
+        storage.Stop();
+    }
+    {
+        SlabLRU storage(32 * 1024, options);
+        EXPECT_FALSE(storage.Restored());
+    }
+    RemoveTemp(options.path);
+}
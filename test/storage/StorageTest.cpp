@@ -1,6 +1,10 @@
 #include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <thread>
 #include <set>
 #include <vector>
 
@@ -11,6 +15,7 @@
 #include <afina/execute/Set.h>
 
 #include "storage/SimpleLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
 
 using namespace Afina::Backend;
 using namespace Afina::Execute;
@@ -195,3 +200,187 @@ TEST(StorageTest, MaxTest) {
         EXPECT_FALSE(storage.Get(key, res));
     }
 }
+
+TEST(StorageTest, GaugesFollowStats) {
+    SimpleLRU storage(1000);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "Value " + std::to_string(i)));
+    }
+    EXPECT_TRUE(storage.Delete("Key 99"));
+
+    std::map<std::string, uint64_t> stats;
+    storage.Stats("", [&stats](const std::string &name, uint64_t value) { stats[name] = value; });
+
+    const Afina::Metrics::StorageGauges &gauges = *storage.Gauges();
+    EXPECT_EQ(stats["curr_items"], gauges.curr_items.Get());
+    EXPECT_EQ(stats["bytes"], gauges.bytes.Get());
+    EXPECT_EQ(1000, gauges.limit_maxbytes.Get());
+    EXPECT_EQ(stats["evictions"], gauges.evictions.Get());
+    EXPECT_GT(gauges.evictions.Get(), 0);
+}
+
+TEST(StorageTest, ExpiredImmediately) {
+    SimpleLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY1", "val2", -1));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Set("KEY1", "val3"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY1", "val4", 100));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "val4");
+}
+
+TEST(StorageTest, GetReportsExpiration) {
+    SimpleLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2", 100));
+
+    std::string value;
+    std::chrono::steady_clock::time_point expire;
+    EXPECT_TRUE(storage.Get("KEY1", value, expire));
+    EXPECT_TRUE(expire == std::chrono::steady_clock::time_point::max());
+
+    const auto now = std::chrono::steady_clock::now();
+    EXPECT_TRUE(storage.Get("KEY2", value, expire));
+    EXPECT_EQ("val2", value);
+    EXPECT_TRUE(expire > now + std::chrono::seconds(90) && expire <= now + std::chrono::seconds(100));
+}
+
+TEST(StorageTest, ExpireAndSweep) {
+    SimpleLRU storage(1000 * 20);
+
+    EXPECT_TRUE(storage.Put("KEY", "val", 1));
+    EXPECT_TRUE(storage.Set("KEY", "val2"));
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(storage.Put("Expire " + std::to_string(i), "val", 1));
+    }
+    EXPECT_TRUE(storage.Put("Live", "val", 100));
+    EXPECT_EQ(0, storage.SweepExpired(1000));
+
+    // Lookups see expiration right away
+    std::string value;
+    for (int i = 0; i < 300 && storage.Get("KEY", value); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_FALSE(storage.Get("KEY", value));
+
+    // Expiration index has one second resolution, sweeps reclaim bucket once it is past
+    std::size_t swept = 0;
+    for (int i = 0; i < 300 && swept < 100; i++) {
+        const std::size_t slice = storage.SweepExpired(10);
+        EXPECT_LE(slice, 10);
+        swept += slice;
+        if (slice == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    EXPECT_EQ(100, swept);
+    EXPECT_EQ(0, storage.SweepExpired(1000));
+    EXPECT_TRUE(storage.Get("Live", value));
+}
+
+// Plain writes of the locked storage go through the ttl ones without taking the lock twice
+TEST(StorageTest, ThreadSafePut) {
+    ThreadSafeSimplLRU storage;
+
+    std::string value;
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+}
+
+TEST(StorageTest, Snapshot) {
+    SimpleLRU storage(1000 * 20);
+
+    for (int i = 0; i < 300; ++i) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "val" + std::to_string(i)));
+    }
+    EXPECT_TRUE(storage.Put("Expiring", "val", 100));
+    EXPECT_TRUE(storage.Put("Expired", "val", -1));
+
+    std::map<std::string, std::pair<std::string, int32_t>> items;
+    EXPECT_TRUE(storage.Snapshot([&](const std::string &key, const std::string &value, int32_t ttl) {
+        EXPECT_TRUE(items.emplace(key, std::make_pair(value, ttl)).second);
+        return true;
+    }));
+
+    EXPECT_EQ(301, items.size());
+    EXPECT_TRUE(items["Key 7"].first == "val7");
+    EXPECT_EQ(0, items["Key 7"].second);
+    EXPECT_EQ(100, items["Expiring"].second);
+
+    // Writer stops the snapshot
+    int written = 0;
+    EXPECT_FALSE(storage.Snapshot([&](const std::string &, const std::string &, int32_t) { return ++written < 10; }));
+    EXPECT_EQ(10, written);
+}
+
+TEST(StorageTest, SnapshotIgnoresLaterChanges) {
+    SimpleLRU storage(1000 * 20);
+
+    std::map<std::string, std::string> expected;
+    for (int i = 0; i < 500; ++i) {
+        std::string key = "Key " + std::to_string(1000 + i);
+        EXPECT_TRUE(storage.Put(key, "val"));
+        expected[key] = "val";
+    }
+
+    // Once the first batch is taken, change items on both sides of the snapshot cursor
+    std::map<std::string, std::string> items;
+    EXPECT_TRUE(storage.Snapshot([&](const std::string &key, const std::string &value, int32_t) {
+        if (items.empty()) {
+            EXPECT_TRUE(storage.Set("Key 1001", "new"));
+            EXPECT_TRUE(storage.Set("Key 1400", "new"));
+            EXPECT_TRUE(storage.Delete("Key 1450"));
+            EXPECT_TRUE(storage.Delete("Key 1002"));
+            EXPECT_TRUE(storage.Put("Key 1450", "new"));
+            EXPECT_TRUE(storage.Put("Key 0", "new"));
+            EXPECT_TRUE(storage.Put("Key 9", "new"));
+        }
+        EXPECT_TRUE(items.emplace(key, value).second);
+        return true;
+    }));
+    EXPECT_TRUE(items == expected);
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("Key 1450", value));
+    EXPECT_TRUE(value == "new");
+}
+
+TEST(StorageTest, ThreadSafeSnapshot) {
+    ThreadSafeSimplLRU storage(1000 * 100);
+
+    std::map<std::string, std::string> expected;
+    for (int i = 0; i < 2000; ++i) {
+        std::string key = "Key " + std::to_string(i);
+        EXPECT_TRUE(storage.Put(key, "val"));
+        expected[key] = "val";
+    }
+
+    // Writer keeps changing storage while the snapshot is taken
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (int i = 0; !done; i = (i + 7) % 2000) {
+            storage.Set("Key " + std::to_string(i), "new");
+            storage.Put("New " + std::to_string(i), "new");
+        }
+    });
+
+    std::map<std::string, std::string> items;
+    EXPECT_TRUE(storage.Snapshot([&](const std::string &key, const std::string &value, int32_t) {
+        EXPECT_TRUE(items.emplace(key, value).second);
+        std::this_thread::yield();
+        return true;
+    }));
+    done = true;
+    writer.join();
+    EXPECT_TRUE(items == expected);
+}
@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+#include <string>
+
+#include "storage/FrequencySketch.h"
+#include "storage/TinyLFU.h"
+
+using namespace Afina::Backend;
+
+TEST(TinyLFUTest, PutGetDelete) {
+    TinyLFU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "val3"));
+    EXPECT_TRUE(storage.Set("KEY1", "val4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val4", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+
+    EXPECT_TRUE(storage.Put("KEY4", "val6", -1));
+    EXPECT_FALSE(storage.Get("KEY4", value));
+}
+
+TEST(TinyLFUTest, ScanResistance) {
+    TinyLFU storage(100 * 20);
+
+    // Working set is accessed a few times, so sketch knows it
+    std::string value;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 50; ++i) {
+            std::string key = "Hot " + std::to_string(i);
+            if (!storage.Get(key, value)) {
+                storage.Put(key, "0123456789");
+            }
+        }
+    }
+
+    // Scan of keys seen once doesn't flush it
+    for (int i = 0; i < 1000; ++i) {
+        storage.Put("Cold " + std::to_string(i), "0123456789");
+    }
+
+    int hits = 0;
+    for (int i = 0; i < 50; ++i) {
+        hits += storage.Get("Hot " + std::to_string(i), value);
+    }
+    EXPECT_GE(hits, 45);
+}
+
+TEST(TinyLFUTest, SketchAging) {
+    FrequencySketch sketch(64);
+
+    for (int i = 0; i < 20; ++i) {
+        sketch.Increment(42);
+    }
+    for (int i = 0; i < 8; ++i) {
+        sketch.Increment(7);
+    }
+    EXPECT_EQ(15, sketch.Estimate(42));
+    EXPECT_EQ(8, sketch.Estimate(7));
+    EXPECT_EQ(0, sketch.Estimate(1000));
+
+    // Sample size is 10 times width, after that all counters are halved
+    for (int i = 0; i < 640; ++i) {
+        sketch.Increment(100000 + i);
+    }
+    EXPECT_LE(sketch.Estimate(42), 7);
+    EXPECT_GE(sketch.Estimate(42), 3);
+}